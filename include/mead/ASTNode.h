@@ -4,24 +4,96 @@
 
 #include <format>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <set>
 #include <sstream>
 #include <vector>
 
 namespace mead {
+	// The node table. Each entry is X(enumerator, display name, class, base), where the class is the ASTNode subclass
+	// used for nodes of that type and the base is the visitor fallback (Node, Expression or Statement). Adding a node
+	// type here is enough to make it show up in NodeType, the debug output and every visitor.
+#define MEAD_NODE_TYPES(X) \
+	X(Invalid,               "Invalid",               ASTNode,            Node) \
+	X(FunctionPrototype,     "FunctionPrototype",     ASTNode,            Node) \
+	X(FunctionDeclaration,   "FunctionDeclaration",   ASTNode,            Node) \
+	X(FunctionDefinition,    "FunctionDefinition",    ASTNode,            Node) \
+	X(VariableDeclaration,   "VariableDeclaration",   ASTNode,            Node) \
+	X(VariableDefinition,    "VariableDefinition",    VariableDefinition, Statement) \
+	X(Identifier,            "Identifier",            Identifier,         Expression) \
+	X(Type,                  "Type",                  TypeNode,           Node) \
+	X(Block,                 "Block",                 Block,              Statement) \
+	X(Const,                 "Const",                 ASTNode,            Node) \
+	X(Pointer,               "Pointer",               ASTNode,            Node) \
+	X(LReference,            "LReference",            ASTNode,            Node) \
+	X(Number,                "Number",                Number,             Expression) \
+	X(String,                "String",                Expression,         Expression) \
+	X(PrefixIncrement,       "PrefixIncrement",       Expression,         Expression) \
+	X(PrefixDecrement,       "PrefixDecrement",       Expression,         Expression) \
+	X(PostfixIncrement,      "PostfixIncrement",      Expression,         Expression) \
+	X(PostfixDecrement,      "PostfixDecrement",      Expression,         Expression) \
+	X(ConstructorCall,       "Constructor",           Expression,         Expression) \
+	X(FunctionCall,          "FunctionCall",          FunctionCall,       Expression) \
+	X(UnaryExpression,       "Unary",                 ASTNode,            Node) \
+	X(Cast,                  "Cast",                  Expression,         Expression) \
+	X(Sizeof,                "Sizeof",                ASTNode,            Node) \
+	X(Binary,                "Binary",                Binary,             Expression) \
+	X(SingleNew,             "SingleNew",             ASTNode,            Node) \
+	X(ArrayNew,              "ArrayNew",              ASTNode,            Node) \
+	X(Delete,                "Delete",                ASTNode,            Node) \
+	X(EmptyPrime,            "EmptyPrime",            ASTNode,            Node) \
+	X(EmptyStatement,        "EmptyStatement",        ASTNode,            Node) \
+	X(Scope,                 "Scope",                 ASTNode,            Node) \
+	X(Expressions,           "Expressions",           ASTNode,            Node) \
+	X(Subscript,             "Subscript",             ASTNode,            Node) \
+	X(AccessMember,          "AccessMember",          ASTNode,            Node) \
+	X(Deref,                 "Deref",                 Dereference,        Expression) \
+	X(GetAddress,            "GetAddress",            GetAddress,         Expression) \
+	X(UnaryPlus,             "UnaryPlus",             Expression,         Expression) \
+	X(UnaryMinus,            "UnaryMinus",            Expression,         Expression) \
+	X(LogicalNot,            "LogicalNot",            Expression,         Expression) \
+	X(BitwiseNot,            "BitwiseNot",            Expression,         Expression) \
+	X(Assign,                "Assign",                Expression,         Expression) \
+	X(CompoundAssign,        "CompoundAssign",        Expression,         Expression) \
+	X(ConditionalExpression, "ConditionalExpression", Expression,         Expression) \
+	X(Comma,                 "Comma",                 Expression,         Expression) \
+	X(ExpressionStatement,   "ExpressionStatement",   ASTNode,            Node) \
+	X(IfStatement,           "IfStatement",           ASTNode,            Node) \
+	X(ReturnStatement,       "ReturnStatement",       Return,             Statement)
+
 	enum class NodeType {
-		Invalid,
-		FunctionPrototype, FunctionDeclaration, FunctionDefinition, VariableDeclaration, VariableDefinition, Identifier, Type, Block,
-		Const, Pointer, LReference, Number, String,
-		PrefixIncrement, PrefixDecrement, PostfixIncrement, PostfixDecrement,
-		ConstructorCall, FunctionCall, UnaryExpression, Cast, Sizeof, Binary, SingleNew, ArrayNew, Delete,
-		EmptyPrime, EmptyStatement, Scope, Expressions, Subscript, AccessMember, Deref, GetAddress, UnaryPlus, UnaryMinus, LogicalNot, BitwiseNot,
-		Assign, CompoundAssign, ConditionalExpression, Comma, ExpressionStatement, IfStatement, ReturnStatement,
+#define MEAD_NODE_ENUMERATOR(enumerator, name, cls, base) enumerator,
+		MEAD_NODE_TYPES(MEAD_NODE_ENUMERATOR)
+#undef MEAD_NODE_ENUMERATOR
 	};
 
-	extern std::map<NodeType, const char *> nodeTypes;
+	enum class NodeCategory {Node, Expression, Statement};
+
+	constexpr size_t nodeTypeCount = 0
+#define MEAD_NODE_COUNT(enumerator, name, cls, base) + 1
+		MEAD_NODE_TYPES(MEAD_NODE_COUNT);
+#undef MEAD_NODE_COUNT
+
+	/** Returns nullptr for values outside the node table. */
+	constexpr const char * getNodeTypeName(NodeType type) {
+		switch (type) {
+#define MEAD_NODE_NAME(enumerator, name, cls, base) case NodeType::enumerator: return name;
+			MEAD_NODE_TYPES(MEAD_NODE_NAME)
+#undef MEAD_NODE_NAME
+		}
+
+		return nullptr;
+	}
+
+	constexpr NodeCategory getNodeCategory(NodeType type) {
+		switch (type) {
+#define MEAD_NODE_CATEGORY(enumerator, name, cls, base) case NodeType::enumerator: return NodeCategory::base;
+			MEAD_NODE_TYPES(MEAD_NODE_CATEGORY)
+#undef MEAD_NODE_CATEGORY
+		}
+
+		return NodeCategory::Node;
+	}
 
 	class ASTNode: public std::enable_shared_from_this<ASTNode> {
 		public:
@@ -37,6 +109,8 @@ namespace mead {
 
 			std::shared_ptr<ASTNode> reparent(std::weak_ptr<ASTNode>);
 			void removeSelf();
+			/** Puts another node in this node's place among its parent's children and detaches this node. */
+			void replaceWith(const std::shared_ptr<ASTNode> &);
 			virtual std::ostream & debug(std::ostream & = std::cout, size_t padding = 0) const;
 			std::string debugStr() const;
 
@@ -48,10 +122,9 @@ namespace mead {
 				return self;
 			}
 
-			template <typename... Args>
-			static std::shared_ptr<ASTNode> make(Args &&...args) {
-				return std::make_shared<ASTNode>(std::forward<Args>(args)...);
-			}
+			/** Creates a node of a type that has no class of its own: an Expression for expression types, so the
+			 *  TypeChecker can annotate it, and a plain ASTNode otherwise. */
+			static std::shared_ptr<ASTNode> make(NodeType, Token);
 
 			const SourceLocation & location() const {
 				return token.location;
@@ -114,8 +187,8 @@ struct std::formatter<mead::NodeType> {
 	}
 
 	auto format(const auto &type, std::format_context &ctx) const {
-		if (auto iter = mead::nodeTypes.find(type); iter != mead::nodeTypes.end())
-			return std::format_to(ctx.out(), "{}", iter->second);
+		if (const char *name = mead::getNodeTypeName(type))
+			return std::format_to(ctx.out(), "{}", name);
 
 		return std::format_to(ctx.out(), "<NodeType:{}?>", static_cast<int>(type));
 	}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mead/node/Binary.h"
+#include "mead/node/Block.h"
+#include "mead/node/Dereference.h"
+#include "mead/node/Expression.h"
+#include "mead/node/FunctionCall.h"
+#include "mead/node/GetAddress.h"
+#include "mead/node/Identifier.h"
+#include "mead/node/Number.h"
+#include "mead/node/Return.h"
+#include "mead/node/Statement.h"
+#include "mead/node/TypeNode.h"
+#include "mead/node/VariableDefinition.h"
+#include "mead/util/Casting.h"
+#include "mead/ASTNode.h"
+
+#include <type_traits>
+
+namespace mead {
+	/** CRTP visitor over the node table in ASTNode.h. visit() switches on the node type and calls the derived class's
+	 *  visit<NodeType> method with the node cast to its class; nothing is virtual. Unhandled node types fall back to
+	 *  visitExpression or visitStatement according to their table entry and from there to visitNode. With IsConst set,
+	 *  every method receives const references instead. */
+	template <typename Derived, typename R = void, bool IsConst = false>
+	class ASTVisitor {
+		protected:
+			template <typename T>
+			using Ref = std::conditional_t<IsConst, const T &, T &>;
+
+		private:
+			Derived & derived() { return static_cast<Derived &>(*this); }
+
+		public:
+			R visit(Ref<ASTNode> node) {
+				switch (node.type) {
+#define MEAD_VISIT_CASE(enumerator, name, cls, base) case NodeType::enumerator: return derived().visit##enumerator(cast<cls>(node));
+					MEAD_NODE_TYPES(MEAD_VISIT_CASE)
+#undef MEAD_VISIT_CASE
+				}
+
+				// Only reachable with a NodeType value that isn't in the table.
+				return derived().visitNode(node);
+			}
+
+			/** Visits each child in order, discarding the results. */
+			void visitChildren(Ref<ASTNode> node) {
+				for (const ASTNodePtr &child : node.children)
+					visit(*child);
+			}
+
+			R visitNode(Ref<ASTNode>) {
+				if constexpr (!std::is_void_v<R>)
+					return R();
+			}
+
+			R visitExpression(Ref<Expression> node) { return derived().visitNode(node); }
+			R visitStatement(Ref<Statement> node) { return derived().visitNode(node); }
+
+#define MEAD_VISIT_DEFAULT(enumerator, name, cls, base) R visit##enumerator(Ref<cls> node) { return derived().visit##base(node); }
+			MEAD_NODE_TYPES(MEAD_VISIT_DEFAULT)
+#undef MEAD_VISIT_DEFAULT
+	};
+
+	template <typename Derived, typename R = void>
+	using ConstASTVisitor = ASTVisitor<Derived, R, true>;
+}
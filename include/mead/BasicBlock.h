@@ -1,36 +1,96 @@
 #pragma once
 
-#include <list>
+#include <cassert>
 #include <memory>
-#include <set>
+#include <string>
+#include <vector>
 
-#include "mead/util/WeakSet.h"
+#include "mead/util/Arena.h"
+#include "mead/util/IntrusiveList.h"
+#include "mead/Instruction.h"
 
 namespace mead {
 	class Function;
-	class LLVMInstruction;
 
 	class BasicBlock: public std::enable_shared_from_this<BasicBlock> {
 		private:
 			Function *parent = nullptr;
-			WeakSet<BasicBlock> in;
-			WeakSet<BasicBlock> out;
-			std::list<std::shared_ptr<LLVMInstruction>> instructions;
+			/** The parent's, where the block's instructions are allocated. */
+			Arena *arena = nullptr;
+			/** Dense within the parent, so analyses can keep per-block data in arrays. */
+			size_t id = 0;
+			/** Doesn't include a leading %. */
+			std::string label;
+			/** In the order the edges were added, without duplicates. */
+			std::vector<BasicBlock *> predecessors;
+			std::vector<BasicBlock *> successors;
+			IntrusiveList<Instruction> instructions;
+
+			template <typename T, typename... Args>
+			T * create(Args &&...args) {
+				T *out = arena->create<T>(std::forward<Args>(args)...);
+				out->parent = this;
+				return out;
+			}
 
 		public:
-			BasicBlock(Function &parent);
+			BasicBlock(Function &parent, std::string label = {});
+
+			inline Function * getParent() const { return parent; }
+			inline size_t getId() const { return id; }
+			inline const auto & getLabel() const { return label; }
+			inline void setLabel(std::string new_label) { label = std::move(new_label); }
+			inline auto & getInstructions() { return instructions; }
+			inline const auto & getInstructions() const { return instructions; }
+			inline const auto & getPredecessors() const { return predecessors; }
+			inline const auto & getSuccessors() const { return successors; }
 
+			/** Adds an edge from this block to another of the same function, if there isn't one already. */
 			void connectTo(BasicBlock &);
 
-			/** Removes this block from the in/out sets of the other and vice versa. */
+			/** Removes the edges between this block and the other in both directions. */
 			void disconnect(BasicBlock &);
 
+			/** Returns whether the block ends in a terminator, after which nothing more can be added. */
+			bool isTerminated() const;
+
+			/** The label followed by one instruction per line. */
+			std::string toString() const;
+
+			/** Constructs an instruction at the end of the block. */
 			template <typename T, typename... Args>
-			requires std::derived_from<T, LLVMInstruction>
-			std::shared_ptr<T> add(Args &&...args) {
-				auto out = std::make_shared<T>(std::forward<Args>(args)...);
-				instructions.emplace_back(out);
+			requires std::derived_from<T, Instruction>
+			T * add(Args &&...args) {
+				T *out = create<T>(std::forward<Args>(args)...);
+				instructions.pushBack(*out);
 				return out;
 			}
+
+			/** Constructs an instruction in front of one of the block's instructions. */
+			template <typename T, typename... Args>
+			requires std::derived_from<T, Instruction>
+			T * insertBefore(Instruction &position, Args &&...args) {
+				assert(position.parent == this);
+				T *out = create<T>(std::forward<Args>(args)...);
+				instructions.insertBefore(&position, *out);
+				return out;
+			}
+
+			/** Constructs an instruction after one of the block's instructions. */
+			template <typename T, typename... Args>
+			requires std::derived_from<T, Instruction>
+			T * insertAfter(Instruction &position, Args &&...args) {
+				assert(position.parent == this);
+				T *out = create<T>(std::forward<Args>(args)...);
+				instructions.insertAfter(position, *out);
+				return out;
+			}
+
+			/** Unlinks one of the block's instructions. It stays allocated until the function is destroyed. */
+			void remove(Instruction &);
+
+			/** Moves another block's instructions from first up to but not including last, or to the end if last is
+			 *  null, in front of position, or at the end if that's null. The blocks must belong to the same function. */
+			void splice(Instruction *position, BasicBlock &from, Instruction &first, Instruction *last = nullptr);
 	};
 }
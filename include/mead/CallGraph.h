@@ -0,0 +1,63 @@
+#pragma once
+
+#include "mead/Function.h"
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace mead {
+	class Namespace;
+	class ThreadPool;
+
+	/** The calls between a set of function definitions, found by resolving the named callees of their FunctionCall
+	 *  nodes. The functions are grouped into strongly connected components, which are numbered callees first, so that
+	 *  an interprocedural analysis can summarize each component once everything it calls has been summarized. */
+	class CallGraph {
+		public:
+			struct Node {
+				FunctionPtr function;
+				/** Indices of the functions in the graph that this one calls, without duplicates. */
+				std::vector<size_t> callees;
+				/** Functions outside the graph that this one calls, like ones that are only declared. */
+				std::vector<FunctionPtr> externalCallees;
+				/** Whether some call couldn't be resolved to a function. */
+				bool hasUnresolvedCalls = false;
+				size_t component = 0;
+			};
+
+			struct Component {
+				size_t index = 0;
+				/** Indices of the functions in the component. */
+				std::vector<size_t> members;
+				/** Indices of the other components that the component's functions call. They're all lower than its own. */
+				std::vector<size_t> callees;
+				/** Whether some function in the component can call itself, directly or not. */
+				bool isRecursive = false;
+			};
+
+		private:
+			std::vector<Node> nodes;
+			std::vector<Component> components;
+			std::unordered_map<const Function *, size_t> indices;
+
+			void findCalls(Node &, const Namespace &);
+			/** Tarjan's algorithm, with an explicit stack so deep call chains can't overflow the native one. */
+			void findComponents();
+
+		public:
+			/** The functions must have definitions. */
+			CallGraph(std::vector<FunctionPtr> functions, const Namespace &);
+
+			inline const auto & getNodes() const { return nodes; }
+			inline const auto & getComponents() const { return components; }
+			/** Returns null if the function isn't in the graph. */
+			const Node * find(const Function &) const;
+
+			/** Calls the function for each component after it has been called for all the component's callees. With a
+			 *  pool of workers, components whose callees are done run concurrently. The first exception thrown is
+			 *  rethrown once the running calls have finished, and components that hadn't started are skipped. */
+			void forEachBottomUp(ThreadPool &, const std::function<void(const Component &)> &) const;
+	};
+}
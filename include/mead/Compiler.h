@@ -1,34 +1,153 @@
 #pragma once
 
 #include <expected>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "mead/util/ThreadPool.h"
 #include "mead/ASTNode.h"
+#include "mead/ASTVisitor.h"
+#include "mead/Diagnostics.h"
+#include "mead/Function.h"
+#include "mead/GlobalPool.h"
+#include "mead/Interpreter.h"
+#include "mead/PassManager.h"
 #include "mead/Program.h"
+#include "mead/Purity.h"
+#include "mead/Token.h"
 #include "mead/Type.h"
+#include "mead/Variable.h"
 
 namespace mead {
 	class BasicBlock;
-	class Function;
 	class Scope;
 	class TypeNode;
 
 	using CompilerError = std::pair<std::string, ASTNodePtr>;
 	using CompilerResult = std::expected<std::string, CompilerError>;
+	/** Fills in the body of a function definition whose body was skipped during parsing. Returns the token where parsing
+	 *  failed if applicable. */
+	using BodyLoader = std::function<std::optional<Token>(ASTNode &)>;
 
-	class Compiler {
+	/** A global whose initializer couldn't be evaluated at compile time. The global is emitted zero-initialized and the
+	 *  initializer has to run at startup instead. */
+	struct RuntimeInitializer {
+		VariablePtr variable;
+		ASTNodePtr initializer;
+	};
+
+	/** Part of a module compiled on its own, for callers that cache parts and put modules together themselves. */
+	struct ModulePiece {
+		/** One per node compiled, empty for nodes that don't produce anything in this piece. */
+		std::vector<std::string> sections;
+		/** Definitions of the string constants the piece uses, one per line. */
+		std::string strings;
+		/** Declarations of the functions without a body that the piece calls, by symbol name. */
+		std::map<std::string, std::string> externalDeclarations;
+		/** A constructor that runs the piece's runtime initializers, if there are any. */
+		std::string constructor;
+		/** The values of the constant globals the piece defines whose initializers were evaluated at compile time, by
+		 *  name. Only filled in by compileGlobals(). */
+		std::map<std::string, LLVMValuePtr> constants;
+		std::vector<Diagnostic> diagnostics;
+	};
+
+	/** Compiles in two passes. The declaration pass goes through the top-level nodes in order, registering functions and
+	 *  compiling globals. The body pass then compiles function bodies concurrently, since they only depend on what the
+	 *  declaration pass registered. In between, interprocedural analyses like purity inference run over the call graph
+	 *  of the new definitions, a strongly connected component at a time, callees first. Once every body is emitted, the
+	 *  pass manager's pipeline runs over them. Each body is then rendered into a buffer of its own and the buffers are
+	 *  put back in source order, along with the body pass's diagnostics, so the output doesn't depend on the thread
+	 *  count. Module entities that bodies share, like string constants and declarations of external functions, are
+	 *  collected in a GlobalPool and emitted once after the definitions. Problems go to the program's DiagnosticEngine
+	 *  and don't stop either pass, so a single compile() reports every error in its input; it fails at the end if there
+	 *  were any. */
+	class Compiler: private ASTVisitor<Compiler, CompilerResult> {
 		public:
-			Compiler();
+			/** With a thread count of zero, function bodies are compiled on the calling thread. */
+			explicit Compiler(size_t thread_count = std::thread::hardware_concurrency());
 
 			CompilerResult compile(std::span<const ASTNodePtr>);
 
+			/** Compiles the globals among the nodes and a constructor for the ones initialized at runtime. Functions are
+			 *  registered, so that initializers can call them, but their bodies aren't compiled. Diagnostics are returned
+			 *  rather than printed. */
+			ModulePiece compileGlobals(std::span<const ASTNodePtr>);
+			/** Compiles one function definition into a single section, registering the other nodes first. The other nodes
+			 *  only need to declare what the definition uses, so the function's purity can't be inferred here and is given
+			 *  instead, along with the values of the constant globals it uses, as compileGlobals() found them. Diagnostics
+			 *  are returned rather than printed. */
+			ModulePiece compileFunction(std::span<const ASTNodePtr> declarations, const ASTNodePtr &definition, Purity = Purity::Impure, const std::map<std::string, LLVMValuePtr> &constants = {});
+			/** Infers the purity of the function definitions among the nodes without compiling anything, for callers that
+			 *  compile functions one at a time and pass the results to compileFunction(). Returns one purity per node,
+			 *  Impure for nodes that don't define a function. The nodes aren't modified. */
+			std::vector<Purity> inferPurity(std::span<const ASTNodePtr>);
+			/** Returns the mangled name of the function a declaration or definition introduces, which tells it apart
+			 *  from its overloads, or nothing if its parameter types can't be resolved. Nothing is registered. */
+			std::optional<std::string> getMangledName(const ASTNode &);
+
+			/** Makes compile() skip functions and globals that can't be reached from the named roots through calls and
+			 *  variable uses. With no roots, everything is compiled. The loader, if any, is given each reachable function
+			 *  definition before its body is looked at, so bodies that are never reached are never parsed. */
+			void setRoots(std::vector<std::string> roots, BodyLoader = {});
+
+			/** The optimizations that run over each compiled function, and the report of what they cost. Starts out with
+			 *  constant propagation, then value numbering, then constant propagation again to fold what value numbering
+			 *  exposed. */
+			inline PassManager & getPassManager() { return passes; }
+
+			/** In definition order, which is the order they have to run in. */
+			inline const auto & getRuntimeInitializers() const { return runtimeInitializers; }
+
 		private:
 			ProgramPtr program;
+			/** Evaluates global initializers. Shared between globals so that calls are memoized across them. */
+			std::unique_ptr<Interpreter> interpreter;
+			std::vector<RuntimeInitializer> runtimeInitializers;
+			/** Functions defined in the current compile() call whose bodies haven't been compiled yet, in source order. */
+			std::vector<FunctionPtr> pendingBodies;
+			/** Functions declared without a body, in source order. The ones that are called get declared in the module. */
+			std::vector<FunctionPtr> externalFunctions;
+			GlobalPool globals;
+			/** Runs over the emitted functions before they're rendered. */
+			PassManager passes;
+			ThreadPool pool;
+			std::vector<std::string> roots;
+			BodyLoader bodyLoader;
+			/** Reachable function definitions whose bodies the loader failed to parse. They're registered like
+			 *  declarations, so that calls to them don't produce errors of their own, but their bodies aren't compiled. */
+			std::unordered_set<const ASTNode *> unparsedBodies;
+
+			friend class ASTVisitor<Compiler, CompilerResult>;
+
+			/** Returns the top-level nodes that are reachable from the roots, in source order. Nodes that don't define a
+			 *  function or global are always kept. */
+			std::vector<ASTNodePtr> findReachable(std::span<const ASTNodePtr>);
+			/** Fills in the parts of a piece that come from the whole compilation rather than from particular nodes. */
+			void finishPiece(ModulePiece &);
+			CompilerResult compileGlobalVariable(const ASTNode &);
+			CompilerResult declareFunction(const ASTNode &);
+			/** Emits the function's body into its blocks, reporting a diagnostic and returning false if it can't be. Safe
+			 *  to run concurrently for different functions. */
+			bool emitBody(Function &);
+			/** Returns a constructor that runs the initializers, or null if there are none or they couldn't be emitted. */
+			FunctionPtr emitRuntimeInitializers(std::span<const RuntimeInitializer>);
 
-			CompilerResult compileGlobalVariable(const ASTNodePtr &);
-			CompilerResult compileFunction(const ASTNodePtr &);
+			inline CompilerResult visitVariableDeclaration(ASTNode &node) { return compileGlobalVariable(node); }
+			inline CompilerResult visitVariableDefinition(VariableDefinition &node) { return compileGlobalVariable(node); }
+			inline CompilerResult visitFunctionDeclaration(ASTNode &node) { return declareFunction(node); }
+			inline CompilerResult visitFunctionDefinition(ASTNode &node) { return declareFunction(node); }
+			/** Other top-level nodes aren't compiled yet. */
+			inline CompilerResult visitNode(ASTNode &) { return {}; }
 
-			TypePtr getType(Scope &, const ASTNodePtr &expression);
 			TypePtr getType(Scope &, const TypeNode &);
 	};
 }
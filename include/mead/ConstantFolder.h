@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mead/ASTVisitor.h"
+#include "mead/LLVMValue.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace mead {
+	class IntType;
+	class Scope;
+	class TypeContext;
+
+	/** An integer value of a particular IntType. The bits are kept truncated to the type's width, so arithmetic on them
+	 *  wraps the way it would at runtime. */
+	class IntConstant {
+		private:
+			uint64_t bits;
+			std::shared_ptr<IntType> type;
+
+		public:
+			IntConstant(uint64_t bits, std::shared_ptr<IntType> type);
+
+			inline uint64_t getUnsigned() const { return bits; }
+			int64_t getSigned() const;
+			inline bool isTrue() const { return bits != 0; }
+			inline const auto & getType() const { return type; }
+
+			/** Converts to another integer type, sign-extending from signed types and zero-extending from unsigned ones. */
+			IntConstant convert(std::shared_ptr<IntType>) const;
+			/** Returns whether converting to the given type would preserve the value. */
+			bool fits(const IntType &) const;
+			/** Signed decimal for signed types, unsigned decimal otherwise. */
+			std::string toString() const;
+			LLVMValuePtr toLLVM() const;
+
+			/** Applies a binary operator with the semantics of generated code. The operands are converted to a common type
+			 *  first, chosen by the type checker's rule. Returns nullopt if there's no common type or if the operation is
+			 *  undefined. */
+			static std::optional<IntConstant> applyBinary(TokenType, const IntConstant &lhs, const IntConstant &rhs);
+			/** Applies a UnaryPlus, UnaryMinus, LogicalNot or BitwiseNot node's operation. */
+			static std::optional<IntConstant> applyUnary(NodeType, const IntConstant &);
+	};
+
+	/** Evaluates integer constant expressions: literals, arithmetic, bitwise operations, shifts, comparisons, logical
+	 *  operations, casts, constructor calls and conditional expressions. Anything that would be undefined at runtime
+	 *  (division by zero, signed division overflow, out-of-range shifts) isn't constant. Results are memoized per node
+	 *  for the lifetime of the folder. */
+	class ConstantFolder: public ConstASTVisitor<ConstantFolder, std::optional<IntConstant>> {
+		private:
+			const Scope &scope;
+			TypeContext &context;
+			std::unordered_map<const ASTNode *, std::optional<IntConstant>> cache;
+
+			std::optional<IntConstant> evaluateBlock(const ASTNode &);
+			std::optional<IntConstant> evaluateConversion(const ASTNode &type_node, const ASTNode &subexpr);
+
+		public:
+			explicit ConstantFolder(const Scope &);
+
+			/** Returns the value of the expression, or nullopt if it isn't a constant expression. */
+			std::optional<IntConstant> evaluate(const ASTNode &);
+
+			/** Replaces every maximal constant subexpression in the tree, other than the root, with a Number of the same
+			 *  type. Returns the number of subexpressions replaced. */
+			size_t fold(ASTNode &root);
+
+			std::optional<IntConstant> visitNumber(const Number &);
+			std::optional<IntConstant> visitBinary(const Binary &);
+			std::optional<IntConstant> visitUnaryPlus(const ASTNode &);
+			std::optional<IntConstant> visitUnaryMinus(const ASTNode &);
+			std::optional<IntConstant> visitLogicalNot(const ASTNode &);
+			std::optional<IntConstant> visitBitwiseNot(const ASTNode &);
+			std::optional<IntConstant> visitUnary(const ASTNode &);
+			std::optional<IntConstant> visitCast(const ASTNode &);
+			std::optional<IntConstant> visitConstructorCall(const ASTNode &);
+			std::optional<IntConstant> visitConditionalExpression(const ASTNode &);
+			std::optional<IntConstant> visitNode(const ASTNode &);
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "mead/Token.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mead {
+	class ASTNode;
+
+	enum class Severity {Error, Warning};
+
+	struct Diagnostic {
+		Severity severity = Severity::Error;
+		SourceLocation location;
+		std::string message;
+	};
+
+	/** Collects the problems found while analyzing a program so that analysis can carry on past the first one and report
+	 *  everything in a single pass. Safe to report into from several threads at once. */
+	class DiagnosticEngine {
+		private:
+			mutable std::mutex mutex;
+			std::vector<Diagnostic> diagnostics;
+			size_t errorCount = 0;
+
+		public:
+			void report(Diagnostic);
+			void error(const ASTNode &, std::string message);
+			void warn(const ASTNode &, std::string message);
+
+			size_t getErrorCount() const;
+			inline bool hasErrors() const { return getErrorCount() != 0; }
+			/** Returns the diagnostics ordered by location and then by message, so the order doesn't depend on which thread
+			 *  reported first. */
+			std::vector<Diagnostic> getDiagnostics() const;
+			/** Logs the diagnostics in the order getDiagnostics() returns them. */
+			void print() const;
+			void clear();
+	};
+}
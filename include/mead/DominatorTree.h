@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace mead {
+	class BasicBlock;
+	class Function;
+
+	/** The dominator tree of a function's blocks, or the post-dominator tree if built backwards. Blocks are numbered by
+	 *  their position in reverse post-order from the root and everything else is kept in flat arrays indexed by that
+	 *  number, so queries don't chase pointers. Blocks the root can't reach (or, backwards, that can't reach a return)
+	 *  aren't in the tree. Built with the iterative algorithm of Cooper, Harvey and Kennedy. */
+	class DominatorTree {
+		private:
+			static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+			bool isPost = false;
+			/** The reachable blocks in reverse post-order. Backwards, the root is a virtual exit that isn't included. */
+			std::vector<BasicBlock *> order;
+			/** Each block's position in the order, by block id, or none if it isn't in the tree. */
+			std::vector<size_t> indices;
+			/** Each block's immediate dominator's position, by position, or none for the root and, backwards, for the
+			 *  blocks the virtual exit immediately post-dominates. */
+			std::vector<size_t> immediateDominators;
+			/** The children of each block in the tree, by position. */
+			std::vector<std::vector<BasicBlock *>> children;
+			/** The interval of preorder numbers each block's subtree covers, by position, so dominance is two
+			 *  comparisons. */
+			std::vector<size_t> preorder;
+			std::vector<size_t> subtreeEnd;
+
+			void computeOrder(const Function &);
+			void computeDominators();
+			void computeTree();
+
+			size_t indexOf(const BasicBlock &) const;
+
+		public:
+			/** The function's first block is its entry. */
+			DominatorTree(const Function &, bool is_post = false);
+
+			inline bool getPost() const { return isPost; }
+			inline const auto & getOrder() const { return order; }
+
+			bool contains(const BasicBlock &) const;
+			/** Null for the root and for blocks not in the tree. Backwards, null for blocks only the virtual exit
+			 *  post-dominates. */
+			BasicBlock * getImmediateDominator(const BasicBlock &) const;
+			/** Whether every path from the root to the second block goes through the first. Blocks dominate themselves. */
+			bool dominates(const BasicBlock &, const BasicBlock &) const;
+			bool strictlyDominates(const BasicBlock &, const BasicBlock &) const;
+			/** The blocks the block immediately dominates, in reverse post-order. */
+			const std::vector<BasicBlock *> & getChildren(const BasicBlock &) const;
+			/** The blocks no other block immediately dominates: just the entry, or backwards, the blocks only the virtual
+			 *  exit post-dominates, which include every block that ends the function. */
+			std::vector<BasicBlock *> getRoots() const;
+	};
+}
@@ -1,29 +1,52 @@
 #pragma once
 
+#include "mead/util/Arena.h"
+#include "mead/DominatorTree.h"
 #include "mead/Formattable.h"
+#include "mead/Purity.h"
 #include "mead/Scope.h"
 #include "mead/Symbol.h"
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace mead {
+	class ASTNode;
 	class BasicBlock;
+	class LLVMValue;
 	class Program;
 	class Type;
 
 	class Function: public Symbol, public Formattable {
 		private:
 			std::weak_ptr<Program> weakProgram;
+			/** The name the function has in the module. */
+			std::string symbolName;
 			std::shared_ptr<Type> returnType;
 			std::vector<std::shared_ptr<Type>> argumentTypes;
-			std::shared_ptr<BasicBlock> entryBlock;
-			std::shared_ptr<BasicBlock> exitBlock;
+			/** The values the body knows the arguments by, once it has been emitted. */
+			std::vector<std::shared_ptr<LLVMValue>> parameters;
+			/** Where the instructions of the function's blocks are allocated. */
+			Arena instructionArena;
+			/** The first is the entry. */
 			std::vector<std::shared_ptr<BasicBlock>> blocks;
+			size_t nextBlockId = 0;
+			/** Built when first asked for and dropped whenever a block or an edge is added or removed. */
+			std::unique_ptr<DominatorTree> dominatorTree;
+			std::unique_ptr<DominatorTree> postDominatorTree;
+			/** Starts a symbol table of its own, so the body can be checked on any thread while the global table is only
+			 *  read. */
 			std::shared_ptr<Scope> scope;
+			/** The FunctionDefinition node, or null if the function is only declared. */
+			std::shared_ptr<const ASTNode> definition;
+			/** Inferred from the body before it's compiled. */
+			Purity purity = Purity::Impure;
 
-			void initBlocks();
+			friend class BasicBlock;
+
+			inline size_t takeBlockId() { return nextBlockId++; }
 
 		public:
 			Function(const std::shared_ptr<Program> &program, std::string name, std::shared_ptr<Type> return_type, std::vector<std::shared_ptr<Type>> argument_types);
@@ -34,14 +57,43 @@ namespace mead {
 			Function & operator=(const Function &) = delete;
 			Function & operator=(Function &&) = delete;
 
-			std::shared_ptr<BasicBlock> addBlock();
+			std::shared_ptr<BasicBlock> addBlock(std::string label = {});
+			/** Adds a block created for this function after the existing ones. */
+			void appendBlock(std::shared_ptr<BasicBlock>);
+			/** Disconnects a block other than the entry and drops it. Its instructions stay allocated until the function
+			 *  is destroyed, but branches to it can't be printed anymore. */
+			void removeBlock(BasicBlock &);
+			/** The signature as an LLVM declaration. */
+			std::string getLLVMDeclaration() const;
+			/** The emitted body as an LLVM definition. */
+			std::string getLLVMDefinition(std::string_view linkage = {}) const;
+			/** The name mangled with the parameter types the way the Itanium C++ ABI mangles a free function's. */
+			std::string getMangledName() const;
+			/** The blocks reachable from the entry in reverse post-order, which visits a block before its successors
+			 *  except along back edges. */
+			const std::vector<BasicBlock *> & getReversePostOrder();
+			const DominatorTree & getDominatorTree();
+			const DominatorTree & getPostDominatorTree();
+			/** Drops the analyses of the control flow graph. Adding or removing blocks and edges does this by itself. */
+			void invalidateControlFlow();
 
+			inline const auto & getName() const { return name; }
+			inline const auto & getSymbolName() const { return symbolName; }
+			inline void setSymbolName(std::string new_symbol_name) { symbolName = std::move(new_symbol_name); }
 			inline const auto & getReturnType() const { return returnType; }
 			inline const auto & getArgumentTypes() const { return argumentTypes; }
-			inline auto getEntryBlock() const { return entryBlock; }
-			inline auto getExitBlock() const { return exitBlock; }
+			inline const auto & getParameters() const { return parameters; }
+			inline void setParameters(std::vector<std::shared_ptr<LLVMValue>> new_parameters) { parameters = std::move(new_parameters); }
+			inline const auto & getBlocks() const { return blocks; }
+			/** One more than the largest id of any block created for the function. */
+			inline size_t getBlockIdCount() const { return nextBlockId; }
+			inline Arena & getInstructionArena() { return instructionArena; }
 			inline auto & getScope() { return scope; }
 			inline const auto & getScope() const { return scope; }
+			inline const auto & getDefinition() const { return definition; }
+			inline void setDefinition(std::shared_ptr<const ASTNode> node) { definition = std::move(node); }
+			inline Purity getPurity() const { return purity; }
+			inline void setPurity(Purity new_purity) { purity = new_purity; }
 
 			std::format_context::iterator formatTo(std::format_context &) const override;
 	};
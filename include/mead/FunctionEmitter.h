@@ -0,0 +1,173 @@
+#pragma once
+
+#include "mead/ASTVisitor.h"
+#include "mead/Diagnostics.h"
+#include "mead/LLVMInstruction.h"
+#include "mead/LLVMValue.h"
+#include "mead/SSABuilder.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	class BasicBlock;
+	class Function;
+	class GlobalPool;
+	class IntType;
+	class Scope;
+	class Type;
+	class TypeContext;
+	class Variable;
+	struct RuntimeInitializer;
+
+	/** Lowers a function body to LLVM IR. Locals are put into SSA form as the code is emitted, except those whose address
+	 *  is taken somewhere in the body, which live in stack slots allocated in the entry block. The body has to have
+	 *  been type checked: operations use the types the TypeChecker annotated, and integer semantics match IntConstant's,
+	 *  so code for a global initializer computes what the Interpreter would have.
+	 *  Each emitter only touches its own function and the shared GlobalPool, so bodies can be emitted concurrently. */
+	class FunctionEmitter: public ConstASTVisitor<FunctionEmitter, std::optional<std::pair<LLVMValuePtr, std::shared_ptr<Type>>>> {
+		public:
+			/** An emitted value and its mead type, which is never a reference. The value is null for void. */
+			using Operand = std::pair<LLVMValuePtr, std::shared_ptr<Type>>;
+
+			/** Where an lvalue is: in memory at an address, or in a local kept in SSA form. */
+			struct Place {
+				/** Null for a local in SSA form. */
+				LLVMValuePtr address;
+				/** Null for a place in memory. */
+				const Variable *variable = nullptr;
+				/** The type stored there, which is never a reference. */
+				std::shared_ptr<Type> type;
+			};
+
+		private:
+			Function &function;
+			GlobalPool &globals;
+			TypeContext &context;
+			/** The innermost open scope. */
+			std::shared_ptr<Scope> scope;
+			/** Holds the allocas, which have to dominate every use, and branches to the body block once it's done. */
+			std::shared_ptr<BasicBlock> entry;
+			std::shared_ptr<BasicBlock> body;
+			/** Where instructions are added. */
+			std::shared_ptr<BasicBlock> current;
+			std::vector<LLVMValuePtr> parameters;
+			std::unordered_map<const Variable *, LLVMValuePtr> slots;
+			/** Locals kept in SSA form. */
+			std::unordered_set<const Variable *> promoted;
+			SSABuilder ssa;
+			/** Names that something in the body takes the address of. Locals with these names get stack slots. */
+			std::unordered_set<std::string> addressTaken;
+			/** Counts uses of each stack slot name so that shadowing locals get distinct ones. */
+			std::unordered_map<std::string, size_t> slotNames;
+			size_t nextTemporary = 0;
+			size_t nextLabel = 0;
+			/** Why emission failed. Emission stops at the first failure. */
+			std::optional<Diagnostic> failure;
+
+			std::nullopt_t fail(const ASTNode &, std::string_view reason);
+
+			/** Creates the entry and body blocks and starts adding to the body. */
+			void begin();
+			/** Closes the entry block and hands the parameters to the function. */
+			void finish();
+
+			/** Finds the names of locals whose address the node takes: by .&, by binding a reference to them, or by
+			 *  passing them where some overload of the callee takes a reference. */
+			void findAddressTaken(const ASTNode &);
+
+			std::shared_ptr<BasicBlock> addBlock(std::string_view hint);
+			/** Labels the block, appends it to the function and starts adding to it. Every branch to the block has to be
+			 *  added before this, since it seals the block for SSA construction. */
+			void moveTo(std::shared_ptr<BasicBlock>);
+			/** Returns the current block, or a new one if the current one is already terminated. */
+			BasicBlock & getInsertionBlock();
+			/** Returns the block the branch was added to. */
+			std::shared_ptr<BasicBlock> branch(const std::shared_ptr<BasicBlock> &destination);
+			void branch(const LLVMValuePtr &condition, const std::shared_ptr<BasicBlock> &if_true, const std::shared_ptr<BasicBlock> &if_false);
+			LLVMValuePtr temporary(LLVMTypePtr);
+
+			template <typename T, typename... Args>
+			T * add(Args &&...);
+
+			/** Makes a variable visible in the current scope with an initial value, which is undefined if null. Returns
+			 *  false on failure. */
+			bool declareLocal(const ASTNode &, const std::string &name, std::shared_ptr<Type>, LLVMValuePtr initial);
+			LLVMValuePtr load(const LLVMValuePtr &pointer, const Type &);
+			/** Returns the place an identifier or dereference designates. */
+			std::optional<Place> emitPlace(const ASTNode &);
+			LLVMValuePtr read(const Place &);
+			void write(const Place &, LLVMValuePtr);
+			/** Returns the address an identifier or dereference designates, along with the type stored there. */
+			std::optional<Operand> emitAddress(const ASTNode &);
+			std::optional<Operand> emitExpression(const ASTNode &);
+			/** Emits the statements of a block in a new scope and returns the value of its last one if that's an expression
+			 *  statement. Returns a void Operand otherwise. */
+			std::optional<Operand> emitBlock(const ASTNode &);
+			bool emitStatement(const ASTNode &);
+			bool emitDeclaration(const ASTNode &declaration, const ASTNode *initializer);
+			/** Converts a value to a type for assignment, initialization, argument passing or return. References bind to
+			 *  the address of the expression instead. */
+			std::optional<Operand> emitInitializer(const ASTNode &expression, const std::shared_ptr<Type> &target);
+			/** Converts between integer types the way IntConstant::convert does. */
+			Operand convert(const Operand &, const std::shared_ptr<IntType> &);
+			/** Returns an i1 that's true if the operand is nonzero. */
+			std::optional<LLVMValuePtr> emitTruth(const ASTNode &, const Operand &);
+			LLVMValuePtr emitCompare(LLVMPredicate, const LLVMValuePtr &lhs, const LLVMValuePtr &rhs);
+			/** Zero-extends an i1 to an integer type. */
+			Operand widen(const LLVMValuePtr &truth, const std::shared_ptr<IntType> &);
+
+			template <typename I>
+			Operand emitThreeReg(const Operand &lhs, const Operand &rhs);
+
+			/** Converts both operands to the operation type, which the TypeChecker worked out, and applies the operator. */
+			std::optional<Operand> emitBinary(const ASTNode &, TokenType, Operand lhs, Operand rhs, const ASTNode &lhs_node, const ASTNode &rhs_node, const std::shared_ptr<Type> &operation_type);
+			std::optional<Operand> emitShortCircuit(const Binary &);
+			std::optional<Operand> emitUnary(const ASTNode &);
+			std::optional<Operand> emitStep(const ASTNode &, bool increment, bool prefix);
+			std::optional<Operand> emitConversion(const ASTNode &type_node, const ASTNode &subexpr);
+			std::shared_ptr<Type> getType(const ASTNode &type_node) const;
+
+		public:
+			FunctionEmitter(Function &, GlobalPool &);
+
+			/** Fills in the function's blocks from its definition. Returns false if the body uses something that can't be
+			 *  emitted yet. The function's scope has to be open. */
+			bool emit();
+			/** Emits the function as one that runs each initializer in order and stores the result in its global. */
+			bool emitInitializers(std::span<const RuntimeInitializer>);
+
+			inline const auto & getFailure() const { return failure; }
+
+			std::optional<Operand> visitNumber(const Number &);
+			std::optional<Operand> visitString(const ASTNode &);
+			std::optional<Operand> visitIdentifier(const Identifier &);
+			std::optional<Operand> visitBinary(const Binary &);
+			std::optional<Operand> visitUnaryPlus(const ASTNode &);
+			std::optional<Operand> visitUnaryMinus(const ASTNode &);
+			std::optional<Operand> visitLogicalNot(const ASTNode &);
+			std::optional<Operand> visitBitwiseNot(const ASTNode &);
+			std::optional<Operand> visitCast(const ASTNode &);
+			std::optional<Operand> visitConstructorCall(const ASTNode &);
+			std::optional<Operand> visitConditionalExpression(const ASTNode &);
+			std::optional<Operand> visitAssign(const ASTNode &);
+			std::optional<Operand> visitCompoundAssign(const ASTNode &);
+			std::optional<Operand> visitPrefixIncrement(const ASTNode &);
+			std::optional<Operand> visitPrefixDecrement(const ASTNode &);
+			std::optional<Operand> visitPostfixIncrement(const ASTNode &);
+			std::optional<Operand> visitPostfixDecrement(const ASTNode &);
+			std::optional<Operand> visitComma(const ASTNode &);
+			std::optional<Operand> visitFunctionCall(const FunctionCall &);
+			std::optional<Operand> visitDeref(const Dereference &);
+			std::optional<Operand> visitGetAddress(const GetAddress &);
+			std::optional<Operand> visitNode(const ASTNode &);
+	};
+}
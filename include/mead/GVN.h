@@ -0,0 +1,28 @@
+#pragma once
+
+#include "mead/PassManager.h"
+
+#include <cstddef>
+#include <string_view>
+
+namespace mead {
+	/** Global value numbering over the dominator tree, after Briggs, Cooper and Simpson's dominator-based value
+	 *  numbering. Instructions are hashed by what they compute: their operation, their result type and their
+	 *  operands, with commutative operands put in a fixed order and equal constants treated as the same operand. The
+	 *  blocks are walked down the dominator tree with a scoped table, so an instruction that computes what a
+	 *  dominating one already has is replaced by that one's result. Loads are numbered too, along with the memory
+	 *  state they read: every store and call starts a new state, as does every block with several predecessors, and a
+	 *  store also makes the value it stored available to loads from the same address. Each function gets a budget of
+	 *  instructions, past which the rest of it is left alone so that huge functions can't blow up compile times. */
+	class GVN: public FunctionPass {
+		private:
+			size_t budget;
+
+		public:
+			explicit GVN(size_t budget = 1 << 16):
+				budget(budget) {}
+
+			std::string_view getName() const override { return "gvn"; }
+			AnalysisSet run(Function &, FunctionAnalyses &) const override;
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "mead/LLVMValue.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mead {
+	class Function;
+
+	/** Module-level entities that function bodies emitted on different threads share. Each is emitted once no matter
+	 *  how many bodies use it, under a name that doesn't depend on which body asked for it first, so that the module's
+	 *  text doesn't depend on scheduling. */
+	class GlobalPool {
+		private:
+			mutable std::mutex mutex;
+			/** Contents by name. Ordered so that the constants come out in the same order every time. */
+			std::map<std::string, std::string> strings;
+			std::unordered_set<const Function *> usedFunctions;
+			/** The values of constant globals whose initializers were evaluated at compile time, by name. */
+			std::unordered_map<std::string, LLVMValuePtr> constants;
+
+		public:
+			/** Returns a pointer to a private constant holding the bytes followed by a null terminator. The name is derived
+			 *  from the contents, so identical strings share a constant. */
+			LLVMValuePtr getString(std::string_view bytes);
+
+			/** Records that a function is called from some body. Functions without a body need a declaration if so. */
+			void useFunction(const Function &);
+			bool isUsed(const Function &) const;
+
+			/** Records the value a constant global always has, so that optimizations can use it instead of loading it. */
+			void setConstant(std::string name, LLVMValuePtr);
+			/** Returns null if the global isn't constant or its value isn't known. */
+			LLVMValuePtr getConstant(std::string_view name) const;
+			std::map<std::string, LLVMValuePtr> getConstants() const;
+
+			/** Definitions of the string constants, one per line. */
+			std::string stringsToLLVM() const;
+	};
+}
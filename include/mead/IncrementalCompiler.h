@@ -0,0 +1,126 @@
+#pragma once
+
+#include "mead/ASTNode.h"
+#include "mead/Compiler.h"
+#include "mead/Diagnostics.h"
+#include "mead/LLVMValue.h"
+#include "mead/Purity.h"
+#include "mead/QueryEngine.h"
+#include "mead/Token.h"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mead {
+	/** Compiles source files as memoized queries so that recompiling after an edit only redoes what the edit affects.
+	 *  A file is split into top-level items by matching braces, and only items whose text changed are lexed and parsed
+	 *  again. Each function's IR is compiled on its own against the signatures of the items it refers to, the globals
+	 *  are compiled along with the functions their initializers can reach, and the module is put together from those
+	 *  pieces in the same form Compiler::compile() produces. Not thread-safe. */
+	class IncrementalCompiler {
+		public:
+			enum class ItemKind {Global, FunctionDeclaration, FunctionDefinition};
+
+			struct Item {
+				/** The name, with "#n" appended if n items before it have the same name. */
+				std::string key;
+				std::string name;
+				ItemKind kind{};
+			};
+
+			struct ItemList {
+				std::vector<Item> items;
+				std::unordered_map<std::string, size_t> byKey;
+				/** Every item with each name, in order. Function items with the same name are overloads. */
+				std::unordered_map<std::string, std::vector<size_t>> byName;
+			};
+
+			struct ItemText {
+				std::string text;
+				/** Where the text starts in the file. */
+				SourceLocation start;
+			};
+
+			/** A file's items and their text, split by matching braces without lexing the file. */
+			struct ChunkList {
+				ItemList list;
+				/** Parallel to the list's items. */
+				std::vector<ItemText> texts;
+			};
+
+			struct LexedItem {
+				std::vector<Token> tokens;
+				/** False if lexing stopped before the end of the item. */
+				bool isComplete = false;
+			};
+
+			struct ParsedItem {
+				/** Shared between queries, so it must not be modified. Null if lexing or parsing failed. Locations are
+				 *  relative to the item's start, like its tokens'. */
+				ASTNodePtr node;
+				std::optional<Diagnostic> failure;
+				/** The fingerprint of the tokens it was parsed from. */
+				Fingerprint::Value fingerprint;
+			};
+
+			struct GlobalsPiece {
+				ModulePiece piece;
+				/** The key of the item each section of the piece came from. */
+				std::vector<std::string> keys;
+			};
+
+			struct ModuleResult {
+				std::string ir;
+				std::vector<Diagnostic> diagnostics;
+			};
+
+		private:
+			QueryEngine engine;
+
+			/** Compiling annotates and folds ASTs, so queries that compile parse private copies of items. */
+			static ParsedItem parse(const LexedItem &);
+			static ParsedItem parse(const std::vector<Token> &tokens);
+			static std::string getItemQueryKey(const std::string &file, const std::string &item);
+
+		public:
+			/** Sets a file's contents. Nothing is recompiled until the file is compiled again. */
+			void setSource(const std::string &file, std::string text);
+			/** Prints the diagnostics and returns the module's IR, or an error if there were any errors. */
+			CompilerResult compile(const std::string &file);
+
+			inline QueryEngine & getEngine() { return engine; }
+
+			const ChunkList & getChunks(const std::string &file);
+			/** The items without their text, which only changes if items are added, removed or renamed. */
+			const ItemList & getItems(const std::string &file);
+			/** Kept apart from where the item starts, so that what only depends on the text isn't redone when the item
+			 *  moves. */
+			const std::string & getItemText(const std::string &file, const std::string &item);
+			const SourceLocation & getItemStart(const std::string &file, const std::string &item);
+			/** Locations are relative to the item's start, which is 1:1. */
+			const LexedItem & getItemTokens(const std::string &file, const std::string &item);
+			const ParsedItem & getItemAST(const std::string &file, const std::string &item);
+			/** The distinct identifiers the item uses, in sorted order. */
+			const std::vector<std::string> & getReferences(const std::string &file, const std::string &item);
+			/** The tokens of a declaration of the item, without locations, so that moving the item doesn't change it. */
+			const std::vector<Token> & getSignature(const std::string &file, const std::string &item);
+			/** The mangled name of a function item, which tells overloads apart. Empty if its parameter types are unknown
+			 *  or the item isn't a function. */
+			const std::string & getMangledName(const std::string &file, const std::string &item);
+			/** The purity of each function defined in the file, by item key. Depends on every function, but is cheap. */
+			const std::map<std::string, Purity> & getPurities(const std::string &file);
+			/** The purity of a function item, kept separate from the file's so that functions whose purity didn't change
+			 *  aren't recompiled. */
+			const Purity & getItemPurity(const std::string &file, const std::string &item);
+			/** The value of a constant global item as compiling the globals found it, or null if it isn't known at compile
+			 *  time. Kept separate from the globals so that functions only depend on the values of those they use. */
+			const LLVMValuePtr & getGlobalConstant(const std::string &file, const std::string &item);
+			/** Its diagnostics are relative to the item's start, like the tokens it's compiled from. */
+			const ModulePiece & getFunctionIR(const std::string &file, const std::string &item);
+			const GlobalsPiece & getGlobals(const std::string &file);
+			const ModuleResult & getModule(const std::string &file);
+	};
+}
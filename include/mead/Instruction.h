@@ -1,20 +1,39 @@
 #pragma once
 
-#include <memory>
+#include "mead/util/IntrusiveList.h"
+
 #include <string>
 
 namespace mead {
 	class BasicBlock;
 
-	class Instruction {
+	enum class InstructionKind {Ret, Unreachable, Br, CondBr, ThreeReg, Cast, Alloca, Load, Store, Phi, Call, TwoWayJump};
+
+	/** Instructions live in their function's arena and are linked into their block's list through themselves. */
+	class Instruction: public IntrusiveListNode<Instruction> {
+		private:
+			/** Set by the block the instruction is linked into. */
+			BasicBlock *parent = nullptr;
+
+			friend class BasicBlock;
+
 		protected:
-			std::weak_ptr<BasicBlock> block;
+			InstructionKind kind;
 
-			Instruction(std::weak_ptr<BasicBlock> block);
+			explicit Instruction(InstructionKind kind):
+				kind(kind) {}
 
 		public:
+			Instruction(const Instruction &) = delete;
+			Instruction & operator=(const Instruction &) = delete;
+
 			virtual ~Instruction() = default;
 
+			inline InstructionKind getKind() const { return kind; }
+			inline BasicBlock * getParent() const { return parent; }
+
+			/** Terminators end a basic block. */
+			virtual bool isTerminator() const { return false; }
 			virtual std::string toString() const;
 	};
 }
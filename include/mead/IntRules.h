@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// The implicit conversion and binary operator typing rules for the builtin integer types, precomputed into tables indexed
+// by IntTypeId so that applying them is an array lookup.
+
+namespace mead {
+	/** Identifies a builtin integer type without its constness. Bit 0 is set for signed types and the remaining bits are
+	 *  log2(bit width) - 3, so the ids are dense. */
+	using IntTypeId = uint8_t;
+
+	constexpr size_t intTypeCount = 8;
+	/** The entry in intCommonTypes for operands that have no common type. */
+	constexpr IntTypeId noIntType = 0xff;
+
+	constexpr IntTypeId getIntTypeId(int bit_width, bool is_signed) {
+		return static_cast<IntTypeId>((std::countr_zero(static_cast<unsigned>(bit_width)) - 3) << 1 | is_signed);
+	}
+
+	constexpr int getIntTypeWidth(IntTypeId id) {
+		return 8 << (id >> 1);
+	}
+
+	constexpr bool getIntTypeSigned(IntTypeId id) {
+		return id & 1;
+	}
+
+	namespace detail {
+		/** Integers only convert implicitly to the same type, ignoring const. Literals are handled separately, by
+		 *  intFits. */
+		constexpr bool intConvertsTo(IntTypeId from, IntTypeId to) {
+			return from == to;
+		}
+
+		/** A binary operator's result has the type of whichever operand the other converts to, preferring the left. */
+		constexpr IntTypeId intCommonType(IntTypeId lhs, IntTypeId rhs) {
+			if (intConvertsTo(rhs, lhs))
+				return lhs;
+			if (intConvertsTo(lhs, rhs))
+				return rhs;
+			return noIntType;
+		}
+
+		template <typename T, typename F>
+		constexpr auto makeIntTable(F rule) {
+			std::array<std::array<T, intTypeCount>, intTypeCount> out{};
+			for (size_t i = 0; i < intTypeCount; ++i)
+				for (size_t j = 0; j < intTypeCount; ++j)
+					out[i][j] = rule(static_cast<IntTypeId>(i), static_cast<IntTypeId>(j));
+			return out;
+		}
+
+		template <typename T, typename F>
+		constexpr auto makeIntRow(F rule) {
+			std::array<T, intTypeCount> out{};
+			for (size_t i = 0; i < intTypeCount; ++i)
+				out[i] = rule(static_cast<IntTypeId>(i));
+			return out;
+		}
+	}
+
+	/** Indexed by [from][to]. */
+	inline constexpr auto intConversions = detail::makeIntTable<bool>(detail::intConvertsTo);
+	/** Indexed by [lhs][rhs]. Holds noIntType where the operands have no common type. */
+	inline constexpr auto intCommonTypes = detail::makeIntTable<IntTypeId>(detail::intCommonType);
+
+	inline constexpr auto intMinimums = detail::makeIntRow<int64_t>([](IntTypeId id) -> int64_t {
+		return getIntTypeSigned(id)? -static_cast<int64_t>((uint64_t{1} << (getIntTypeWidth(id) - 1)) - 1) - 1 : 0;
+	});
+
+	inline constexpr auto intMaximums = detail::makeIntRow<uint64_t>([](IntTypeId id) -> uint64_t {
+		const int magnitude_bits = getIntTypeWidth(id) - getIntTypeSigned(id);
+		return 64 <= magnitude_bits? ~uint64_t{} : (uint64_t{1} << magnitude_bits) - 1;
+	});
+
+	/** Returns whether a constant can be converted to a type without changing its value. A negative value is passed as
+	 *  its 64-bit two's complement. */
+	constexpr bool intFits(uint64_t value, bool is_negative, IntTypeId to) {
+		return is_negative? intMinimums[to] <= static_cast<int64_t>(value) : value <= intMaximums[to];
+	}
+
+	static_assert(getIntTypeId(8, false) == 0 && getIntTypeId(64, true) == intTypeCount - 1);
+	static_assert(getIntTypeWidth(getIntTypeId(32, true)) == 32 && !getIntTypeSigned(getIntTypeId(16, false)));
+	static_assert(intConversions[getIntTypeId(32, true)][getIntTypeId(32, true)]);
+	static_assert(!intConversions[getIntTypeId(8, true)][getIntTypeId(32, true)]);
+	static_assert(intCommonTypes[getIntTypeId(16, false)][getIntTypeId(16, false)] == getIntTypeId(16, false));
+	static_assert(intCommonTypes[getIntTypeId(32, true)][getIntTypeId(32, false)] == noIntType);
+	static_assert(intMinimums[getIntTypeId(8, true)] == -128 && intMaximums[getIntTypeId(8, true)] == 127);
+	static_assert(intMinimums[getIntTypeId(64, false)] == 0 && intMaximums[getIntTypeId(64, false)] == ~uint64_t{});
+	static_assert(intFits(255, false, getIntTypeId(8, false)) && !intFits(256, false, getIntTypeId(8, false)));
+	static_assert(intFits(static_cast<uint64_t>(-128), true, getIntTypeId(8, true)));
+	static_assert(!intFits(static_cast<uint64_t>(-1), true, getIntTypeId(64, false)));
+}
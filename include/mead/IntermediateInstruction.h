@@ -3,6 +3,8 @@
 #include "mead/Instruction.h"
 #include "mead/Value.h"
 
+#include <memory>
+
 namespace mead {
 	/** Base class for special instructions that don't directly correspond to an LLVM instruction.
 	 *  Typically, they require special logic (with potential side effects) to replace them with LLVM instructions. */
@@ -20,6 +22,8 @@ namespace mead {
 			ValuePtr condition;
 
 		public:
-			TwoWayJump(std::weak_ptr<BasicBlock> block, std::weak_ptr<BasicBlock> destination, ValuePtr condition);
+			TwoWayJump(std::weak_ptr<BasicBlock> destination, ValuePtr condition);
+
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::TwoWayJump; }
 	};
 }
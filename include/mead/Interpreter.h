@@ -0,0 +1,100 @@
+#pragma once
+
+#include "mead/ASTVisitor.h"
+#include "mead/ConstantFolder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	class Function;
+	class IntType;
+	class Scope;
+	class TypeContext;
+	class Variable;
+
+	/** Evaluates integer expressions at compile time, including calls to mead functions, so that globals initialized by
+	 *  them can be emitted as static data. Evaluation is dynamically checked for purity: reading a global other than a
+	 *  constant with a known value, writing anything but a local, taking addresses, strings, allocation and calls to
+	 *  functions without a body all make it fail, as does running out of steps or call depth. Integer semantics are
+	 *  IntConstant's, which match generated code. Successful calls are memoized by function and argument values. */
+	class Interpreter: public ConstASTVisitor<Interpreter, std::optional<IntConstant>> {
+		public:
+			static constexpr size_t defaultStepBudget = 1'000'000;
+			static constexpr size_t maxDepth = 256;
+
+		private:
+			enum class Flow {Normal, Return, Fail};
+
+			struct Local {
+				std::shared_ptr<IntType> type;
+				/** Empty until the local is assigned. */
+				std::optional<IntConstant> value;
+			};
+
+			struct Frame {
+				std::shared_ptr<IntType> returnType;
+				std::optional<IntConstant> returnValue;
+				/** One map per open block, innermost last. */
+				std::vector<std::map<std::string, Local>> blocks;
+			};
+
+			const Scope &scope;
+			TypeContext &context;
+			size_t stepBudget;
+			size_t steps = 0;
+			std::vector<Frame> frames;
+			std::unordered_map<const Variable *, IntConstant> globals;
+			std::map<std::pair<const Function *, std::vector<uint64_t>>, IntConstant> memo;
+
+			std::optional<IntConstant> evaluateExpression(const ASTNode &);
+			std::optional<IntConstant> evaluateBlock(const ASTNode &);
+			std::optional<IntConstant> evaluateConversion(const ASTNode &type_node, const ASTNode &subexpr);
+			std::optional<IntConstant> call(const Function &, std::vector<IntConstant> arguments);
+			Flow execute(const ASTNode &statement);
+			Flow declare(const ASTNode &declaration, const ASTNode *initializer);
+			std::shared_ptr<IntType> getIntType(const ASTNode &type_node) const;
+			Local * findLocal(const ASTNode &identifier);
+			std::optional<IntConstant> assign(const ASTNode &target, const IntConstant &);
+			std::optional<IntConstant> step(const ASTNode &target, TokenType operation, bool prefix);
+
+		public:
+			/** The scope is where free identifiers are resolved; it should be the program's global scope. */
+			explicit Interpreter(const Scope &, size_t step_budget = defaultStepBudget);
+
+			/** Returns the value of the expression, or nullopt if it can't be evaluated at compile time. Each call gets a
+			 *  fresh step budget. */
+			std::optional<IntConstant> evaluate(const ASTNode &);
+
+			/** Makes a constant global's value available to later evaluations. */
+			void setGlobalValue(const Variable &, IntConstant);
+
+			std::optional<IntConstant> visitNumber(const Number &);
+			std::optional<IntConstant> visitIdentifier(const Identifier &);
+			std::optional<IntConstant> visitBinary(const Binary &);
+			std::optional<IntConstant> visitUnaryPlus(const ASTNode &);
+			std::optional<IntConstant> visitUnaryMinus(const ASTNode &);
+			std::optional<IntConstant> visitLogicalNot(const ASTNode &);
+			std::optional<IntConstant> visitBitwiseNot(const ASTNode &);
+			std::optional<IntConstant> visitUnary(const ASTNode &);
+			std::optional<IntConstant> visitCast(const ASTNode &);
+			std::optional<IntConstant> visitConstructorCall(const ASTNode &);
+			std::optional<IntConstant> visitConditionalExpression(const ASTNode &);
+			std::optional<IntConstant> visitAssign(const ASTNode &);
+			std::optional<IntConstant> visitCompoundAssign(const ASTNode &);
+			std::optional<IntConstant> visitPrefixIncrement(const ASTNode &);
+			std::optional<IntConstant> visitPrefixDecrement(const ASTNode &);
+			std::optional<IntConstant> visitPostfixIncrement(const ASTNode &);
+			std::optional<IntConstant> visitPostfixDecrement(const ASTNode &);
+			std::optional<IntConstant> visitComma(const ASTNode &);
+			std::optional<IntConstant> visitFunctionCall(const FunctionCall &);
+			std::optional<IntConstant> visitNode(const ASTNode &);
+	};
+}
@@ -3,20 +3,83 @@
 #include "mead/Instruction.h"
 #include "mead/LLVMValue.h"
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace mead {
 	class LLVMInstruction: public Instruction {
 		protected:
 			using Instruction::Instruction;
+
+		public:
+			/** The slots of the values the instruction reads, so that passes can inspect and replace them. */
+			virtual std::vector<LLVMValuePtr *> getOperands() { return {}; }
+			/** The value the instruction defines, or null if it doesn't define one. */
+			virtual LLVMValuePtr getResult() const { return nullptr; }
+
+			static bool classof(const Instruction *instruction) { return instruction->getKind() != InstructionKind::TwoWayJump; }
 	};
 
 	class LLVMRet: public LLVMInstruction {
 		private:
-			ValuePtr value;
+			/** Null for ret void. */
+			LLVMValuePtr value;
+
+		public:
+			explicit LLVMRet(LLVMValuePtr value = nullptr);
+
+			bool isTerminator() const override { return true; }
+			std::vector<LLVMValuePtr *> getOperands() override;
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Ret; }
+	};
+
+	class LLVMUnreachable: public LLVMInstruction {
+		public:
+			LLVMUnreachable():
+				LLVMInstruction(InstructionKind::Unreachable) {}
+
+			bool isTerminator() const override { return true; }
+			std::string toString() const override { return "unreachable"; }
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Unreachable; }
+	};
+
+	class LLVMBr: public LLVMInstruction {
+		private:
+			std::weak_ptr<BasicBlock> destination;
 
 		public:
-			LLVMRet(std::weak_ptr<BasicBlock> block, LLVMValuePtr value);
+			explicit LLVMBr(std::weak_ptr<BasicBlock> destination);
+
+			inline const auto & getDestination() const { return destination; }
+			bool isTerminator() const override { return true; }
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Br; }
 	};
 
+	class LLVMCondBr: public LLVMInstruction {
+		private:
+			LLVMValuePtr condition;
+			std::weak_ptr<BasicBlock> ifTrue;
+			std::weak_ptr<BasicBlock> ifFalse;
+
+		public:
+			LLVMCondBr(LLVMValuePtr condition, std::weak_ptr<BasicBlock> if_true, std::weak_ptr<BasicBlock> if_false);
+
+			inline const auto & getCondition() const { return condition; }
+			inline const auto & getIfTrue() const { return ifTrue; }
+			inline const auto & getIfFalse() const { return ifFalse; }
+			bool isTerminator() const override { return true; }
+			std::vector<LLVMValuePtr *> getOperands() override;
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::CondBr; }
+	};
+
+	/** What an LLVMThreeReg computes. */
+	enum class LLVMOpcode {Add, Sub, Mul, SDiv, UDiv, SRem, URem, Shl, LShr, AShr, And, Or, Xor, Icmp};
+
 	class LLVMThreeReg: public LLVMInstruction {
 		protected:
 			LLVMValuePtr left;
@@ -27,9 +90,15 @@ namespace mead {
 			virtual void assertValid() const;
 
 		public:
-			LLVMThreeReg(std::weak_ptr<BasicBlock> block, LLVMValuePtr left, LLVMValuePtr right, LLVMValuePtr result);
+			LLVMThreeReg(LLVMValuePtr left, LLVMValuePtr right, LLVMValuePtr result);
 
+			inline const auto & getLeft() const { return left; }
+			inline const auto & getRight() const { return right; }
+			virtual LLVMOpcode getOpcode() const = 0;
+			std::vector<LLVMValuePtr *> getOperands() override;
+			LLVMValuePtr getResult() const override { return result; }
 			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::ThreeReg; }
 	};
 
 	class LLVMAdd: public LLVMThreeReg {
@@ -38,5 +107,253 @@ namespace mead {
 
 		public:
 			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::Add; }
+	};
+
+	class LLVMSub: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "sub"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::Sub; }
+	};
+
+	class LLVMMul: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "mul"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::Mul; }
+	};
+
+	class LLVMSDiv: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "sdiv"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::SDiv; }
+	};
+
+	class LLVMUDiv: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "udiv"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::UDiv; }
+	};
+
+	class LLVMSRem: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "srem"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::SRem; }
+	};
+
+	class LLVMURem: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "urem"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::URem; }
+	};
+
+	class LLVMShl: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "shl"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::Shl; }
+	};
+
+	class LLVMLShr: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "lshr"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::LShr; }
+	};
+
+	class LLVMAShr: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "ashr"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::AShr; }
+	};
+
+	class LLVMAnd: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "and"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::And; }
+	};
+
+	class LLVMOr: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "or"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::Or; }
+	};
+
+	class LLVMXor: public LLVMThreeReg {
+		protected:
+			std::string getKeyword() const final { return "xor"; }
+
+		public:
+			using LLVMThreeReg::LLVMThreeReg;
+
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::Xor; }
+	};
+
+	enum class LLVMPredicate {Eq, Ne, Slt, Sle, Sgt, Sge, Ult, Ule, Ugt, Uge};
+
+	/** Compares two integers or pointers. The result is an i1. */
+	class LLVMIcmp: public LLVMThreeReg {
+		private:
+			LLVMPredicate predicate;
+
+		protected:
+			std::string getKeyword() const final;
+			void assertValid() const final;
+
+		public:
+			LLVMIcmp(LLVMPredicate predicate, LLVMValuePtr left, LLVMValuePtr right, LLVMValuePtr result);
+
+			inline LLVMPredicate getPredicate() const { return predicate; }
+			LLVMOpcode getOpcode() const final { return LLVMOpcode::Icmp; }
+
+			static bool classof(const Instruction *instruction) {
+				return LLVMThreeReg::classof(instruction) && static_cast<const LLVMThreeReg *>(instruction)->getOpcode() == LLVMOpcode::Icmp;
+			}
+	};
+
+	enum class LLVMCastKind {Trunc, ZExt, SExt};
+
+	class LLVMCast: public LLVMInstruction {
+		private:
+			LLVMCastKind castKind;
+			LLVMValuePtr value;
+			LLVMValuePtr result;
+
+		public:
+			LLVMCast(LLVMCastKind cast_kind, LLVMValuePtr value, LLVMValuePtr result);
+
+			inline LLVMCastKind getCastKind() const { return castKind; }
+			inline const auto & getValue() const { return value; }
+			std::vector<LLVMValuePtr *> getOperands() override;
+			LLVMValuePtr getResult() const override { return result; }
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Cast; }
+	};
+
+	class LLVMAlloca: public LLVMInstruction {
+		private:
+			LLVMTypePtr allocatedType;
+			LLVMValuePtr result;
+
+		public:
+			LLVMAlloca(LLVMTypePtr allocated_type, LLVMValuePtr result);
+
+			LLVMValuePtr getResult() const override { return result; }
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Alloca; }
+	};
+
+	class LLVMLoad: public LLVMInstruction {
+		private:
+			LLVMValuePtr pointer;
+			/** The result's type is the type loaded. */
+			LLVMValuePtr result;
+
+		public:
+			LLVMLoad(LLVMValuePtr pointer, LLVMValuePtr result);
+
+			inline const auto & getPointer() const { return pointer; }
+			std::vector<LLVMValuePtr *> getOperands() override;
+			LLVMValuePtr getResult() const override { return result; }
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Load; }
+	};
+
+	class LLVMStore: public LLVMInstruction {
+		private:
+			LLVMValuePtr value;
+			LLVMValuePtr pointer;
+
+		public:
+			LLVMStore(LLVMValuePtr value, LLVMValuePtr pointer);
+
+			inline const auto & getValue() const { return value; }
+			inline const auto & getPointer() const { return pointer; }
+			std::vector<LLVMValuePtr *> getOperands() override;
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Store; }
+	};
+
+	class LLVMPhi: public LLVMInstruction {
+		public:
+			using Incoming = std::pair<LLVMValuePtr, std::weak_ptr<BasicBlock>>;
+
+		private:
+			std::vector<Incoming> incoming;
+			LLVMValuePtr result;
+
+		public:
+			/** A phi can start without incoming values if they're added before it's printed. */
+			LLVMPhi(std::vector<Incoming> incoming, LLVMValuePtr result);
+
+			inline const auto & getIncoming() const { return incoming; }
+			inline void addIncoming(LLVMValuePtr value, std::weak_ptr<BasicBlock> predecessor) { incoming.emplace_back(std::move(value), std::move(predecessor)); }
+			/** Removes the values that come from a block, for when it stops being a predecessor. */
+			void removeIncoming(const BasicBlock &);
+			std::vector<LLVMValuePtr *> getOperands() override;
+			LLVMValuePtr getResult() const override { return result; }
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Phi; }
+	};
+
+	class LLVMCall: public LLVMInstruction {
+		private:
+			LLVMTypePtr returnType;
+			/** Doesn't include a leading @. */
+			std::string callee;
+			std::vector<LLVMValuePtr> arguments;
+			/** Null for calls to void functions. */
+			LLVMValuePtr result;
+
+		public:
+			LLVMCall(LLVMTypePtr return_type, std::string callee, std::vector<LLVMValuePtr> arguments, LLVMValuePtr result);
+
+			inline const auto & getCallee() const { return callee; }
+			std::vector<LLVMValuePtr *> getOperands() override;
+			LLVMValuePtr getResult() const override { return result; }
+			std::string toString() const override;
+			static bool classof(const Instruction *instruction) { return instruction->getKind() == InstructionKind::Call; }
 	};
 }
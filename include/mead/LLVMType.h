@@ -2,75 +2,100 @@
 
 #include "mead/Formattable.h"
 
-#include <cassert>
 #include <format>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace mead {
+	enum class LLVMTypeKind {Int, Array, Struct, Pointer, Void, Poison};
+
+	class LLVMTypeContext;
+
+	/** LLVM types are uniqued by LLVMTypeContext, so they're only created there and equal types are the same object. */
 	class LLVMType: public Formattable {
 		protected:
-			LLVMType() = default;
+			LLVMTypeKind kind;
+
+			explicit LLVMType(LLVMTypeKind kind):
+				kind(kind) {}
 
 		public:
 			virtual ~LLVMType() = default;
 
+			inline LLVMTypeKind getKind() const { return kind; }
+
 			virtual operator std::string() const;
-			virtual bool operator==(const LLVMType &) const = 0;
+			inline bool operator==(const LLVMType &other) const { return this == &other; }
 	};
 
 	using LLVMTypePtr = std::shared_ptr<LLVMType>;
-	using LLVMTypeWeakPtr = std::weak_ptr<LLVMType>;
 
 	struct LLVMIntType: LLVMType {
 		int bitWidth{};
 
-		explicit LLVMIntType(int bit_width);
-
-		bool operator==(const LLVMType &) const override;
 		std::format_context::iterator formatTo(std::format_context &) const override;
+
+		static bool classof(const LLVMType *type) { return type->getKind() == LLVMTypeKind::Int; }
+
+		private:
+			friend class LLVMTypeContext;
+			explicit LLVMIntType(int bit_width);
 	};
 
 	struct LLVMArrayType: LLVMType {
 		int count{};
 		LLVMTypePtr subtype;
 
-		LLVMArrayType(int count, LLVMTypePtr subtype);
-
-		bool operator==(const LLVMType &) const override;
 		std::format_context::iterator formatTo(std::format_context &) const override;
+
+		static bool classof(const LLVMType *type) { return type->getKind() == LLVMTypeKind::Array; }
+
+		private:
+			friend class LLVMTypeContext;
+			LLVMArrayType(int count, LLVMTypePtr subtype);
 	};
 
 	struct LLVMStructType: LLVMType {
-		std::vector<LLVMTypeWeakPtr> subtypes;
-
-		explicit LLVMStructType(std::vector<LLVMTypeWeakPtr> subtypes);
+		std::vector<LLVMTypePtr> subtypes;
 
-		bool operator==(const LLVMType &) const override;
 		std::format_context::iterator formatTo(std::format_context &) const override;
+
+		static bool classof(const LLVMType *type) { return type->getKind() == LLVMTypeKind::Struct; }
+
+		private:
+			friend class LLVMTypeContext;
+			explicit LLVMStructType(std::vector<LLVMTypePtr> subtypes);
 	};
 
+	/** Pointers are opaque, so there's only one pointer type. */
 	struct LLVMPointerType: LLVMType {
-		LLVMTypePtr subtype;
+		std::format_context::iterator formatTo(std::format_context &) const override;
 
-		LLVMPointerType(LLVMTypePtr subtype);
+		static bool classof(const LLVMType *type) { return type->getKind() == LLVMTypeKind::Pointer; }
 
-		bool operator==(const LLVMType &) const override;
-		std::format_context::iterator formatTo(std::format_context &) const override;
+		private:
+			friend class LLVMTypeContext;
+			LLVMPointerType();
 	};
 
 	struct LLVMVoidType: LLVMType {
-		LLVMVoidType();
-
-		bool operator==(const LLVMType &) const override;
 		std::format_context::iterator formatTo(std::format_context &) const override;
+
+		static bool classof(const LLVMType *type) { return type->getKind() == LLVMTypeKind::Void; }
+
+		private:
+			friend class LLVMTypeContext;
+			LLVMVoidType();
 	};
 
 	struct LLVMPoisonType: LLVMType {
-		LLVMPoisonType();
-
-		bool operator==(const LLVMType &) const override;
 		std::format_context::iterator formatTo(std::format_context &) const override;
+
+		static bool classof(const LLVMType *type) { return type->getKind() == LLVMTypeKind::Poison; }
+
+		private:
+			friend class LLVMTypeContext;
+			LLVMPoisonType();
 	};
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mead/LLVMType.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	/** Creates and owns LLVM types. Types are uniqued by structure (integers by width, arrays by count and element type,
+	 *  structs by element types, and one each of ptr, void and poison), so equal types are always the same object and
+	 *  emitting IR never allocates a type that already exists. LLVM types don't refer to anything in a program, so one
+	 *  context is shared by the whole process. All public methods are safe to call concurrently. */
+	class LLVMTypeContext {
+		private:
+			struct ArrayKeyHash {
+				size_t operator()(const std::pair<int, const LLVMType *> &key) const {
+					return std::hash<const LLVMType *>{}(key.second) * 31 + std::hash<int>{}(key.first);
+				}
+			};
+
+			struct StructKeyHash {
+				size_t operator()(const std::vector<const LLVMType *> &key) const {
+					size_t hash = key.size();
+					for (const LLVMType *type : key)
+						hash = hash * 31 + std::hash<const LLVMType *>{}(type);
+					return hash;
+				}
+			};
+
+			/** The widest integer type kept in the lock-free table. Wider ones are looked up under the lock. */
+			static constexpr int maxTableWidth = 64;
+
+			/** Indexed by bit width. Filled on construction and never modified, so reads don't need the lock. */
+			std::array<std::shared_ptr<LLVMIntType>, maxTableWidth + 1> intTypes;
+			std::shared_ptr<LLVMPointerType> pointerType;
+			std::shared_ptr<LLVMVoidType> voidType;
+			std::shared_ptr<LLVMPoisonType> poisonType;
+			std::unordered_map<int, std::shared_ptr<LLVMIntType>> wideIntTypes;
+			std::unordered_map<std::pair<int, const LLVMType *>, std::shared_ptr<LLVMArrayType>, ArrayKeyHash> arrayTypes;
+			std::unordered_map<std::vector<const LLVMType *>, std::shared_ptr<LLVMStructType>, StructKeyHash> structTypes;
+			std::mutex mutex;
+
+			LLVMTypeContext();
+
+		public:
+			LLVMTypeContext(const LLVMTypeContext &) = delete;
+			LLVMTypeContext(LLVMTypeContext &&) = delete;
+
+			LLVMTypeContext & operator=(const LLVMTypeContext &) = delete;
+			LLVMTypeContext & operator=(LLVMTypeContext &&) = delete;
+
+			static LLVMTypeContext & get();
+
+			std::shared_ptr<LLVMIntType> getInt(int bit_width);
+			inline const std::shared_ptr<LLVMPointerType> & getPointer() const { return pointerType; }
+			inline const std::shared_ptr<LLVMVoidType> & getVoid() const { return voidType; }
+			inline const std::shared_ptr<LLVMPoisonType> & getPoison() const { return poisonType; }
+			/** The element type must have come from this context. */
+			std::shared_ptr<LLVMArrayType> getArray(int count, const LLVMTypePtr &subtype);
+			/** The element types must have come from this context. */
+			std::shared_ptr<LLVMStructType> getStruct(const std::vector<LLVMTypePtr> &subtypes);
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "mead/Formattable.h"
 #include "mead/LLVMType.h"
+#include "mead/LLVMTypeContext.h"
 #include "mead/Value.h"
 
 #include <concepts>
@@ -10,16 +11,25 @@
 #include <string>
 
 namespace mead {
+	enum class LLVMValueKind {Int, Array, Struct, Global, Null, Undef, Local};
+
 	class LLVMValue: public Value, public Formattable {
 		protected:
-			LLVMValue() = default;
+			LLVMValueKind kind;
+
+			explicit LLVMValue(LLVMValueKind kind):
+				kind(kind) {}
 
 		public:
 			virtual ~LLVMValue() = default;
 
+			inline LLVMValueKind getKind() const { return kind; }
+
 			virtual LLVMTypePtr getType() const = 0;
 			/** Includes preceding type. */
 			virtual operator std::string() const;
+			/** Doesn't include the type, as in an operand whose type is given once for all operands. */
+			std::string toString() const override = 0;
 	};
 
 	using LLVMValuePtr = std::shared_ptr<LLVMValue>;
@@ -32,11 +42,18 @@ namespace mead {
 		public:
 			template <std::integral T>
 			LLVMIntValue(T value):
+				LLVMValue(LLVMValueKind::Int),
 				value(value),
-				type(std::make_shared<LLVMIntType>(sizeof(value) * 8)) {}
+				type(LLVMTypeContext::get().getInt(sizeof(value) * 8)) {}
 
+			/** Only the low bit_width bits of the value are used. */
+			LLVMIntValue(uint64_t value, int bit_width);
+
+			inline uint64_t getValue() const { return value; }
 			LLVMTypePtr getType() const override;
+			std::string toString() const override;
 			std::format_context::iterator formatTo(std::format_context &) const override;
+			static bool classof(const LLVMValue *value) { return value->getKind() == LLVMValueKind::Int; }
 	};
 
 	class LLVMArrayValue: public LLVMValue {
@@ -47,8 +64,10 @@ namespace mead {
 		public:
 			LLVMArrayValue(std::vector<LLVMValuePtr> values, LLVMTypePtr type);
 			LLVMTypePtr getType() const override;
+			std::string toString() const override;
 			std::format_context::iterator formatTo(std::format_context &) const override;
 			inline const auto & getValues() const { return values; }
+			static bool classof(const LLVMValue *value) { return value->getKind() == LLVMValueKind::Array; }
 	};
 
 	class LLVMStructValue: public LLVMValue {
@@ -60,8 +79,10 @@ namespace mead {
 			LLVMStructValue(std::vector<LLVMValuePtr> values, LLVMTypePtr type);
 			LLVMStructValue(std::vector<LLVMValuePtr> values);
 			LLVMTypePtr getType() const override;
+			std::string toString() const override;
 			std::format_context::iterator formatTo(std::format_context &) const override;
 			inline const auto & getValues() const { return values; }
+			static bool classof(const LLVMValue *value) { return value->getKind() == LLVMValueKind::Struct; }
 	};
 
 	class LLVMGlobalValue: public LLVMValue {
@@ -73,14 +94,49 @@ namespace mead {
 		public:
 			LLVMGlobalValue(std::string name, LLVMTypePtr type);
 			LLVMTypePtr getType() const override;
+			std::string toString() const override;
 			std::format_context::iterator formatTo(std::format_context &) const override;
 			inline const auto & getName() const { return name; }
+			static bool classof(const LLVMValue *value) { return value->getKind() == LLVMValueKind::Global; }
 	};
 
 	class LLVMNullValue: public LLVMValue {
 		public:
-			LLVMNullValue() = default;
+			LLVMNullValue():
+				LLVMValue(LLVMValueKind::Null) {}
+
 			LLVMTypePtr getType() const override;
+			std::string toString() const override;
 			std::format_context::iterator formatTo(std::format_context &) const override;
+			static bool classof(const LLVMValue *value) { return value->getKind() == LLVMValueKind::Null; }
+	};
+
+	/** A value that can be anything, such as a variable's before it's first assigned. */
+	class LLVMUndefValue: public LLVMValue {
+		private:
+			LLVMTypePtr type;
+
+		public:
+			explicit LLVMUndefValue(LLVMTypePtr type);
+			LLVMTypePtr getType() const override;
+			std::string toString() const override;
+			std::format_context::iterator formatTo(std::format_context &) const override;
+			static bool classof(const LLVMValue *value) { return value->getKind() == LLVMValueKind::Undef; }
+	};
+
+	/** A value local to a function: a register or a parameter. */
+	class LLVMLocalValue: public LLVMValue {
+		private:
+			/** Doesn't include a leading %. */
+			std::string name;
+			LLVMTypePtr type;
+
+		public:
+			LLVMLocalValue(std::string name, LLVMTypePtr type);
+			LLVMTypePtr getType() const override;
+			std::string toString() const override;
+			std::format_context::iterator formatTo(std::format_context &) const override;
+			inline const auto & getName() const { return name; }
+			static bool classof(const LLVMValue *value) { return value->getKind() == LLVMValueKind::Local; }
 	};
 }
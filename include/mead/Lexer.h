@@ -49,6 +49,9 @@ namespace mead {
 			/** Tries to lex one token and remove it from the string view. */
 			bool next(std::string_view &);
 
+			/** Sets where in the source the next character lexed is, for lexing part of a file on its own. */
+			inline void setLocation(SourceLocation location) { currentLocation = location; }
+
 		private:
 			SourceLocation currentLocation{1, 1};
 
@@ -6,6 +6,23 @@
 #include <string>
 
 namespace mead {
+	/** Where the logging functions without a stream argument write on the current thread. Defaults to std::cerr. */
+	inline thread_local std::ostream *logStream = &std::cerr;
+
+	/** Sends the current thread's log output to another stream for its own lifetime, so that work done concurrently can
+	 *  have its diagnostics printed in a fixed order afterwards. */
+	class LogRedirect {
+		private:
+			std::ostream *previous;
+
+		public:
+			explicit LogRedirect(std::ostream &stream): previous(logStream) { logStream = &stream; }
+			~LogRedirect() { logStream = previous; }
+
+			LogRedirect(const LogRedirect &) = delete;
+			LogRedirect & operator=(const LogRedirect &) = delete;
+	};
+
 	template <typename... Args>
 	std::ostream & SUCCESS(std::ostream &stream, const std::format_string<Args...> &format, Args &&...args) {
 		std::print(stream, "\x1b[2m[\x1b[22;32m🗸\x1b[39;2m]\x1b[22m ");
@@ -36,21 +53,21 @@ namespace mead {
 
 	template <typename... Args>
 	std::ostream & SUCCESS(const std::format_string<Args...> &format, Args &&...args) {
-		return SUCCESS(std::cerr, format, std::forward<Args>(args)...);
+		return SUCCESS(*logStream, format, std::forward<Args>(args)...);
 	}
 
 	template <typename... Args>
 	std::ostream & ERROR(const std::format_string<Args...> &format, Args &&...args) {
-		return ERROR(std::cerr, format, std::forward<Args>(args)...);
+		return ERROR(*logStream, format, std::forward<Args>(args)...);
 	}
 
 	template <typename... Args>
 	std::ostream & WARN(const std::format_string<Args...> &format, Args &&...args) {
-		return WARN(std::cerr, format, std::forward<Args>(args)...);
+		return WARN(*logStream, format, std::forward<Args>(args)...);
 	}
 
 	template <typename... Args>
 	std::ostream & INFO(const std::format_string<Args...> &format, Args &&...args) {
-		return INFO(std::cerr, format, std::forward<Args>(args)...);
+		return INFO(*logStream, format, std::forward<Args>(args)...);
 	}
 }
@@ -1,32 +1,71 @@
 #pragma once
 
+#include "mead/NamespacedName.h"
 #include "mead/Symbol.h"
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace mead {
 	class Function;
+	class OverloadSet;
 	class Type;
 
+	/** Lookups resolve names in this namespace and then in each enclosing one. Qualified names (a::b::c) resolve their
+	 *  first component the same way and then descend. Results, including misses, are cached per namespace; the caches
+	 *  of the whole tree are invalidated whenever any namespace in it gains a symbol, so the walk up the parents only
+	 *  happens on the first lookup of a name after a change. */
 	class Namespace: public Symbol, public std::enable_shared_from_this<Namespace> {
 		private:
+			template <typename T>
+			using SymbolMap = std::map<std::string, std::shared_ptr<T>>;
+
+			template <typename T>
+			using ResolutionCache = std::unordered_map<std::string, std::shared_ptr<T>>;
+
 			std::weak_ptr<Namespace> weakParent;
 			std::string name;
+			std::string fullName;
 			std::map<std::string, std::shared_ptr<Symbol>> allSymbols;
-			std::map<std::string, std::shared_ptr<Namespace>> namespaces;
-			std::map<std::string, std::shared_ptr<Type>> types;
-			std::map<std::string, std::shared_ptr<Function>> functions;
+			SymbolMap<Namespace> namespaces;
+			SymbolMap<Type> types;
+			SymbolMap<OverloadSet> functions;
+
+			/** Shared by every namespace in the tree and incremented whenever one of them gains a symbol. */
+			std::shared_ptr<uint64_t> generation;
+			mutable uint64_t cacheGeneration = 0;
+			mutable ResolutionCache<Type> typeCache;
+			mutable ResolutionCache<OverloadSet> functionCache;
+			/** Lookups fill the caches, and function bodies are checked concurrently. */
+			mutable std::mutex cacheMutex;
+
+			void invalidateCaches();
+			const Namespace * descend(const NamespacedName &) const;
+
+			template <typename T>
+			std::shared_ptr<T> resolve(const NamespacedName &, ResolutionCache<T> &, SymbolMap<T> Namespace::*) const;
 
 		public:
 			Namespace(std::string name, std::weak_ptr<Namespace> parent = {});
 
-			std::string getFullName() const;
+			inline const std::string & getName() const { return name; }
+			inline const std::string & getFullName() const { return fullName; }
+			/** Returns null for the global namespace. */
+			inline auto getParent() const { return weakParent.lock(); }
 			std::shared_ptr<Namespace> getNamespace(const std::string &name, bool create = false);
-			std::shared_ptr<Type> getType(const std::string &name) const;
+			std::shared_ptr<Type> getType(const NamespacedName &) const;
+			/** Returns null if there's no function by that name or if the name is overloaded. */
+			std::shared_ptr<Function> getFunction(const NamespacedName &) const;
+			/** Returns the functions by that name, or null if there are none. */
+			std::shared_ptr<const OverloadSet> getOverloads(const NamespacedName &) const;
 			/** Returns whether the type was successfully inserted. */
 			bool insertType(const std::string &name, const std::shared_ptr<Type> &);
+			/** Adds the function to the overloads by that name. Returns false if there's already one with the same
+			 *  parameter types. */
 			bool insertFunction(const std::string &name, const std::shared_ptr<Function> &);
 	};
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace mead {
+	class Function;
+	class Type;
+
+	/** The functions that share a name in a namespace. Overloads are told apart by their parameter types, ignoring
+	 *  constness and references, so each has a key of interned types that can be compared and hashed by address. A
+	 *  call whose argument types are exactly some overload's key is resolved with one hash lookup. Other calls rank
+	 *  each overload's conversions and memoize the outcome for their tuple of argument types, so only the first call
+	 *  with a given tuple pays for the ranking. Resolving is safe to do concurrently; inserting isn't. */
+	class OverloadSet {
+		public:
+			struct Resolution {
+				/** Null if no overload matches or several match equally well. */
+				std::shared_ptr<Function> function;
+				bool isAmbiguous = false;
+			};
+
+		private:
+			using Key = std::vector<const Type *>;
+
+			struct KeyHash {
+				inline size_t operator()(const Key &key) const { return hashKey(key); }
+			};
+
+			/** In the order they were inserted. */
+			std::vector<std::shared_ptr<Function>> functions;
+			/** Parallel to the functions. */
+			std::vector<Key> keys;
+			/** Indices of the functions by the hash of their keys. */
+			std::unordered_multimap<uint64_t, size_t> exactMatches;
+			mutable std::unordered_map<Key, Resolution, KeyHash> memo;
+			mutable std::mutex memoMutex;
+
+			/** Null for unknown types, which match any parameter by conversion. */
+			static const Type * getKeyType(const Type *);
+			static uint64_t hashKey(std::span<const Type * const>);
+			/** How far an argument is from a parameter: 0 for the same type, the number of doublings for an integer
+			 *  widened without a change of sign, and more than any widening for other conversions. Nothing if the
+			 *  argument doesn't convert. */
+			static std::optional<unsigned> getCost(const Type *argument, const Type &parameter);
+			/** Ranks every overload. */
+			Resolution rank(const Key &) const;
+
+		public:
+			OverloadSet() = default;
+
+			OverloadSet(const OverloadSet &) = delete;
+			OverloadSet(OverloadSet &&) = delete;
+
+			OverloadSet & operator=(const OverloadSet &) = delete;
+			OverloadSet & operator=(OverloadSet &&) = delete;
+
+			/** Returns false if an overload with the same parameter types is already in the set. */
+			bool insert(std::shared_ptr<Function>);
+			/** Picks the overload whose parameters the argument types convert to best. Null argument types are unknown.
+			 *  An overload is chosen over the others if none of its arguments cost more and at least one costs less. A
+			 *  set with one function always resolves to it, leaving arity and conversions to the caller. */
+			Resolution resolve(std::span<const std::shared_ptr<Type>> argument_types) const;
+
+			inline size_t size() const { return functions.size(); }
+			/** In the order they were inserted. */
+			inline const auto & getFunctions() const { return functions; }
+			/** Returns the function if there's only one and null otherwise. */
+			std::shared_ptr<Function> getOnly() const;
+	};
+}
@@ -12,6 +12,7 @@
 #include <print>
 #include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mead {
@@ -28,12 +29,22 @@ namespace mead {
 			TypeDB typeDB;
 			/** False if we're inside a context (e.g., arguments list) where the comma operator is forbidden. */
 			bool commaAllowed = true;
+			bool lazyBodies = false;
+			/** The tokens of function bodies that were skipped, including the braces, keyed by the empty Block that stands
+			 *  in for each one. */
+			std::unordered_map<const ASTNode *, std::span<const Token>> skippedBodies;
 
 		public:
 			Parser();
 
 			/** Returns the token where parsing failed if applicable, or nothing otherwise. */
 			std::optional<Token> parse(std::span<const Token> tokens);
+			/** Makes parse() skip over function bodies by matching braces instead of parsing them. Each skipped body is an
+			 *  empty Block until loadBody() is called for its function. The tokens have to outlive the parser. */
+			inline void setLazyBodies(bool value) { lazyBodies = value; }
+			/** Parses a function definition's skipped body into its placeholder Block. Does nothing if the body was never
+			 *  skipped or has already been loaded. Returns the token where parsing failed if applicable. */
+			std::optional<Token> loadBody(ASTNode &definition);
 
 			const auto & getNodes() const { return astNodes; }
 
@@ -51,6 +62,10 @@ namespace mead {
 			ParseResult takeParenthetical(std::span<const Token> &tokens);
 			ParseResult takeTypedVariable(std::span<const Token> &tokens);
 			ParseResult takeBlock(std::span<const Token> &tokens);
+			/** Takes a brace-delimited block without parsing it and returns an empty Block for it. */
+			ParseResult skipBlock(std::span<const Token> &tokens);
+			/** Turns a function body's trailing expression statement into a return statement. */
+			static void addImplicitReturn(const ASTNodePtr &block);
 			ParseResult takeStatement(std::span<const Token> &tokens);
 			ParseResult takeType(std::span<const Token> &tokens, bool include_qualifiers, QualifiedType *);
 			ParseResult takeVariableDeclaration(std::span<const Token> &tokens);
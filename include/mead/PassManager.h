@@ -0,0 +1,157 @@
+#pragma once
+
+#include "mead/Function.h"
+#include "mead/UseLists.h"
+
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	class BasicBlock;
+	class DominatorTree;
+	class ThreadPool;
+
+	/** What the pass manager caches for each function. The control flow analyses are the reverse post-order and both
+	 *  dominator trees, which are all computed from the edges and dropped together. */
+	enum class Analysis {ControlFlow, Uses};
+
+	/** The analyses a pass left valid. */
+	class AnalysisSet {
+		private:
+			unsigned bits = 0;
+
+			constexpr explicit AnalysisSet(unsigned bits):
+				bits(bits) {}
+
+		public:
+			constexpr AnalysisSet() = default;
+
+			constexpr AnalysisSet(std::initializer_list<Analysis> analyses) {
+				for (Analysis analysis : analyses)
+					bits |= 1u << static_cast<unsigned>(analysis);
+			}
+
+			/** For a pass that didn't change anything. */
+			static constexpr AnalysisSet all() { return AnalysisSet(~0u); }
+			static constexpr AnalysisSet none() { return AnalysisSet(); }
+
+			constexpr bool contains(Analysis analysis) const { return bits & (1u << static_cast<unsigned>(analysis)); }
+	};
+
+	/** A function's analyses, each computed when first asked for and kept until a pass doesn't preserve it. */
+	class FunctionAnalyses {
+		private:
+			Function &function;
+			std::unique_ptr<UseLists> uses;
+
+		public:
+			explicit FunctionAnalyses(Function &function):
+				function(function) {}
+
+			inline Function & getFunction() const { return function; }
+
+			const std::vector<BasicBlock *> & getReversePostOrder();
+			const DominatorTree & getDominatorTree();
+			const DominatorTree & getPostDominatorTree();
+			UseLists & getUses();
+
+			/** Drops the analyses that aren't in the set. */
+			void invalidate(AnalysisSet preserved);
+	};
+
+	/** The analyses of every function a module pass is given. */
+	class ModuleAnalyses {
+		private:
+			std::unordered_map<const Function *, std::unique_ptr<FunctionAnalyses>> functions;
+
+		public:
+			FunctionAnalyses & get(Function &);
+			void invalidate(AnalysisSet preserved);
+	};
+
+	class FunctionPass {
+		public:
+			virtual ~FunctionPass() = default;
+
+			/** The name the timing report shows. */
+			virtual std::string_view getName() const = 0;
+			/** Transforms one function and returns the analyses it left valid. Runs concurrently for different functions,
+			 *  so a pass mustn't keep state between runs. */
+			virtual AnalysisSet run(Function &, FunctionAnalyses &) const = 0;
+	};
+
+	class ModulePass {
+		public:
+			virtual ~ModulePass() = default;
+
+			virtual std::string_view getName() const = 0;
+			/** Transforms the functions as a whole and returns the analyses it left valid in all of them. */
+			virtual AnalysisSet run(std::span<const FunctionPtr>, ModuleAnalyses &) = 0;
+	};
+
+	/** Runs a pipeline of passes over the function definitions of a module. Consecutive function passes form a stage
+	 *  that takes each function through all of them in order, with the functions spread over a pool's workers, so a
+	 *  function's IR stays in cache between passes. Module passes run on the calling thread between stages. Analyses
+	 *  are cached per function and dropped after each pass that doesn't say it preserved them. Every pass's runs are
+	 *  timed and the functions it ran on are measured before and after, and the totals accumulate until they're reset,
+	 *  so that the compile time each pass costs and what it buys are visible. */
+	class PassManager {
+		public:
+			struct PassStatistics {
+				std::string name;
+				/** Once per function for a function pass and once per module for a module pass. */
+				size_t runs = 0;
+				/** The wall time of the runs, summed. Function passes run concurrently, so theirs can exceed the time the
+				 *  stage took. */
+				std::chrono::nanoseconds time{0};
+				/** The sizes of the functions the pass ran on, summed. */
+				size_t instructionsBefore = 0;
+				size_t instructionsAfter = 0;
+				size_t blocksBefore = 0;
+				size_t blocksAfter = 0;
+			};
+
+		private:
+			/** Exactly one is set. */
+			struct Entry {
+				std::unique_ptr<FunctionPass> functionPass = nullptr;
+				std::unique_ptr<ModulePass> modulePass = nullptr;
+			};
+
+			std::vector<Entry> pipeline;
+			/** By position in the pipeline. */
+			std::vector<PassStatistics> statistics;
+
+			/** Runs the function passes in [first, last) over the functions. */
+			void runStage(size_t first, size_t last, std::span<const FunctionPtr>, ModuleAnalyses &, ThreadPool &);
+
+		public:
+			void add(std::unique_ptr<FunctionPass>);
+			void add(std::unique_ptr<ModulePass>);
+
+			template <typename P, typename... Args>
+			void add(Args &&...args) {
+				add(std::make_unique<P>(std::forward<Args>(args)...));
+			}
+
+			inline bool empty() const { return pipeline.empty(); }
+			inline const auto & getStatistics() const { return statistics; }
+
+			/** The functions must have been emitted. If a pass throws, the first exception is rethrown once the running
+			 *  passes have finished. */
+			void run(std::span<const FunctionPtr>, ThreadPool &);
+
+			void resetStatistics();
+			/** Prints a line per pass, in pipeline order, with its time and its effect on the IR's size. */
+			void printReport(std::ostream &) const;
+	};
+}
@@ -3,13 +3,19 @@
 #include <memory>
 
 namespace mead {
+	class DiagnosticEngine;
 	class Namespace;
 	class Scope;
+	class SymbolTable;
+	class TypeContext;
 
 	class Program: public std::enable_shared_from_this<Program> {
 		private:
 			std::shared_ptr<Namespace> globalNamespace;
 			std::shared_ptr<Scope> globalScope;
+			std::shared_ptr<SymbolTable> symbolTable;
+			std::shared_ptr<TypeContext> typeContext;
+			std::shared_ptr<DiagnosticEngine> diagnostics;
 
 		public:
 			Program();
@@ -18,6 +24,9 @@ namespace mead {
 
 			std::shared_ptr<Namespace> getGlobalNamespace() const;
 			std::shared_ptr<Scope> getGlobalScope() const;
+			TypeContext & getTypeContext() const;
+			/** Where everything that analyzes the program reports problems. */
+			DiagnosticEngine & getDiagnostics() const;
 	};
 
 	using ProgramPtr = std::shared_ptr<Program>;
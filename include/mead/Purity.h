@@ -0,0 +1,14 @@
+#pragma once
+
+namespace mead {
+	class CallGraph;
+	class ThreadPool;
+
+	/** What a function may do to memory other than its own locals. Ordered so that the greater of two is what a function
+	 *  doing both does. */
+	enum class Purity {Pure, ReadOnly, Impure};
+
+	/** Sets the purity of every function in the graph, working up from callees. Functions outside the graph are assumed
+	 *  to be as impure as their own purity says, which for functions that are only declared is Impure. */
+	void inferPurity(const CallGraph &, ThreadPool &);
+}
@@ -2,20 +2,54 @@
 
 #include "mead/Type.h"
 
-#include <vector>
+#include <cstdint>
+#include <optional>
 
 namespace mead {
+	/** A type held as a value: an unqualified base type shared with every other use of it, plus the qualifiers on top of
+	 *  it. Level 0 is the base type and level i is the i-th pointer around it; each level can be const, and the whole
+	 *  thing can be an lreference. Adding and removing qualifiers never allocates or locks a TypeContext, and two
+	 *  qualified types can be compared member by member. getType() interns the equivalent Type when one is needed. */
 	class QualifiedType {
 		private:
-			std::vector<bool> pointerConsts;
-			bool isConst = false;
+			/** Never const. Null if the base type hasn't been resolved yet. */
+			TypePtr base;
+			/** Bit i is set if level i is const. */
+			uint64_t constMask = 0;
+			uint8_t pointerLevels = 0;
 			bool isReference = false;
-			TypePtr type;
+			bool isReferenceConst = false;
+
+			QualifiedType(TypePtr base, uint64_t const_mask, uint8_t pointer_levels, bool is_reference, bool is_reference_const);
 
 		public:
+			static constexpr size_t maxPointerLevel = 63;
+
 			QualifiedType();
-			QualifiedType(std::vector<bool> pointer_consts, bool is_const, bool is_reference, TypePtr type);
+			/** Splits an interned type into its unqualified base type and its qualifiers. */
+			explicit QualifiedType(const TypePtr &);
+
+			inline const TypePtr & getBase() const { return base; }
+			inline size_t pointerLevel() const { return pointerLevels; }
+			inline bool getReference() const { return isReference; }
+			inline bool isConstAt(size_t level) const { return (constMask >> level) & 1; }
+			/** Returns the constness of the outermost level, which is the reference itself for references. */
+			bool getConst() const;
+
+			QualifiedType withConst(bool) const;
+			/** Returns a pointer to this type. A reference is unwrapped first. */
+			QualifiedType pointerTo(bool is_const = false) const;
+			/** Returns a reference to this type. A reference is unwrapped first. */
+			QualifiedType referenceTo(bool is_const = false) const;
+			QualifiedType withoutReference() const;
+			/** Returns a reference to the pointee, or nullopt if this isn't a pointer. */
+			std::optional<QualifiedType> dereference() const;
+
+			/** Like Type::isExactlyEquivalent, only the outermost level's constness can be ignored. */
+			bool isExactlyEquivalent(const QualifiedType &, bool ignore_const) const;
+			/** Returns the interned Type with these qualifiers, or null if there's no base type. */
+			TypePtr getType() const;
 
-			size_t pointerLevel() const;
+			bool operator==(const QualifiedType &) const = default;
 	};
 }
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	enum class QueryKind {SourceText, Chunks, Items, ItemText, ItemStart, ItemTokens, ItemAST, References, Signature, MangledName, Purities, ItemPurity, GlobalConstant, FunctionIR, Globals, Module};
+
+	constexpr size_t queryKindCount = static_cast<size_t>(QueryKind::Module) + 1;
+
+	std::string_view getQueryKindName(QueryKind);
+
+	struct QueryStats {
+		/** Results that had already been brought up to date in the current revision. */
+		size_t hits = 0;
+		/** Results from an earlier revision that were reused because none of their dependencies had changed. */
+		size_t validations = 0;
+		/** Results computed for the first time. */
+		size_t misses = 0;
+		/** Results computed again because a dependency changed. */
+		size_t recomputations = 0;
+		/** Recomputations that produced the same fingerprint as before, so that nothing depending on them had to be
+		 *  recomputed. */
+		size_t cutoffs = 0;
+	};
+
+	/** A 128-bit FNV-1a hash for summarizing query results. Results with equal fingerprints are treated as equal, which
+	 *  is wide enough that a collision between two different results won't happen by accident. */
+	class Fingerprint {
+		public:
+			struct Value {
+				uint64_t high = 0;
+				uint64_t low = 0;
+
+				bool operator==(const Value &) const = default;
+			};
+
+		private:
+			Value state{0x6c62272e07bb0142, 0x62b821756295c58d};
+
+			/** Multiplies the state by the FNV prime, 2^88 + 0x13b, modulo 2^128. */
+			inline void mix(uint8_t byte) {
+				state.low ^= byte;
+				const uint64_t low_product = (state.low & 0xffffffff) * 0x13b;
+				const uint64_t high_product = (state.low >> 32) * 0x13b + (low_product >> 32);
+				state.high = state.high * 0x13b + (high_product >> 32) + (state.low << 24);
+				state.low = high_product << 32 | (low_product & 0xffffffff);
+			}
+
+		public:
+			inline Fingerprint & add(std::string_view bytes) {
+				add(bytes.size());
+				for (const char byte : bytes)
+					mix(static_cast<uint8_t>(byte));
+				return *this;
+			}
+
+			template <typename T>
+			requires std::is_integral_v<T> || std::is_enum_v<T>
+			inline Fingerprint & add(T value) {
+				auto bits = static_cast<uint64_t>(value);
+				for (int i = 0; i < 8; ++i, bits >>= 8)
+					mix(bits & 0xff);
+				return *this;
+			}
+
+			inline Fingerprint & add(const Value &value) {
+				return add(value.high).add(value.low);
+			}
+
+			inline Value get() const { return state; }
+	};
+
+	/** Memoizes the results of queries and records which queries each one read while it ran. Setting an input starts a
+	 *  new revision. A result from an earlier revision is reused if none of the queries it read have changed since it
+	 *  was last verified, which is checked recursively, bringing those queries up to date first (red-green
+	 *  invalidation). A query that has to be recomputed but comes out with the same fingerprint keeps its old revision,
+	 *  so the queries that read it can still be reused. Not thread-safe. */
+	class QueryEngine {
+		public:
+			using Revision = uint64_t;
+
+		private:
+			struct Computed {
+				std::shared_ptr<const void> value;
+				Fingerprint::Value fingerprint;
+			};
+
+			struct Record {
+				QueryKind kind;
+				std::function<Computed()> compute;
+				Computed result;
+				Revision changedAt = 0;
+				Revision verifiedAt = 0;
+				std::vector<Record *> dependencies;
+				bool isInput = false;
+				/** Set while the query is running, to catch cycles. */
+				bool isActive = false;
+			};
+
+			struct KeyHash {
+				inline size_t operator()(const std::pair<QueryKind, std::string> &key) const {
+					return std::hash<std::string>{}(key.second) * 31 + static_cast<size_t>(key.first);
+				}
+			};
+
+			Revision revision = 1;
+			std::unordered_map<std::pair<QueryKind, std::string>, std::unique_ptr<Record>, KeyHash> records;
+			/** The dependencies of each query that's currently running, innermost last. */
+			std::vector<std::vector<Record *>> frames;
+			std::array<QueryStats, queryKindCount> stats{};
+
+			/** Returns null if the query has never been run. */
+			Record * findRecord(QueryKind, const std::string &key);
+			Record & addRecord(QueryKind, const std::string &key, std::function<Computed()> compute);
+			/** Makes sure the record's result is valid in the current revision. */
+			void refresh(Record &);
+			void execute(Record &);
+			void read(Record &);
+
+		public:
+			/** Sets the value of an input query. Starts a new revision unless the fingerprint is unchanged. */
+			template <typename T>
+			void setInput(QueryKind kind, const std::string &key, T value, Fingerprint::Value fingerprint) {
+				const auto map_key = std::make_pair(kind, key);
+				auto iter = records.find(map_key);
+
+				if (iter != records.end()) {
+					assert(iter->second->isInput);
+					if (iter->second->result.fingerprint == fingerprint)
+						return;
+				} else {
+					iter = records.emplace(map_key, std::make_unique<Record>()).first;
+					iter->second->kind = kind;
+					iter->second->isInput = true;
+				}
+
+				Record &record = *iter->second;
+				record.result = {std::make_shared<const T>(std::move(value)), fingerprint};
+				record.changedAt = record.verifiedAt = ++revision;
+			}
+
+			/** Returns the result of a query, running it only if no valid result is memoized. The query reads other
+			 *  queries through this engine, which is how its dependencies are recorded. The reference stays valid until
+			 *  the next revision. */
+			template <typename T, typename Compute, typename GetFingerprint>
+			const T & get(QueryKind kind, const std::string &key, Compute compute, GetFingerprint get_fingerprint) {
+				Record *record = findRecord(kind, key);
+
+				if (!record) {
+					record = &addRecord(kind, key, [compute = std::move(compute), get_fingerprint = std::move(get_fingerprint)] {
+						auto value = std::make_shared<const T>(compute());
+						const Fingerprint::Value fingerprint = get_fingerprint(*value);
+						return Computed{std::move(value), fingerprint};
+					});
+				}
+
+				read(*record);
+				return *static_cast<const T *>(record->result.value.get());
+			}
+
+			/** Returns the value of an input query, which must have been set. */
+			template <typename T>
+			const T & getInput(QueryKind kind, const std::string &key) {
+				Record *record = findRecord(kind, key);
+				assert(record && record->isInput);
+				read(*record);
+				return *static_cast<const T *>(record->result.value.get());
+			}
+
+			inline Revision getRevision() const { return revision; }
+			inline const QueryStats & getStats(QueryKind kind) const { return stats[static_cast<size_t>(kind)]; }
+			void resetStats();
+			/** One line per kind of query that has been used since the stats were last reset. */
+			std::string statsToString() const;
+	};
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "mead/PassManager.h"
+
+#include <string_view>
+
+namespace mead {
+	class GlobalPool;
+
+	/** Sparse conditional constant propagation, after Wegman and Zadeck, "Constant Propagation with Conditional
+	 *  Branches". Integer values are evaluated optimistically: every value starts out unknown, and a block is only
+	 *  evaluated once a branch that can be taken leads to it, so a phi ignores what comes from blocks that can't run.
+	 *  Afterwards, instructions found to produce constants are replaced by them, conditional branches on constants
+	 *  become unconditional and blocks that can't run are removed, along with whatever only fed what was removed.
+	 *  Operations whose results LLVM leaves undefined, like division by zero, are never folded. Loads from constant
+	 *  globals are folded if a GlobalPool knows their values. */
+	class SCCP: public FunctionPass {
+		private:
+			const GlobalPool *globals;
+
+		public:
+			explicit SCCP(const GlobalPool *globals = nullptr):
+				globals(globals) {}
+
+			std::string_view getName() const override { return "sccp"; }
+			AnalysisSet run(Function &, FunctionAnalyses &) const override;
+	};
+}
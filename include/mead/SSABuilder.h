@@ -0,0 +1,52 @@
+#pragma once
+
+#include "mead/LLVMValue.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	class BasicBlock;
+	class Function;
+	class LLVMPhi;
+	class Variable;
+
+	/** Puts variables into SSA form while their function is being emitted, with the algorithm of Braun et al., "Simple
+	 *  and Efficient Construction of Static Single Assignment Form". A read looks for the variable's definition in its
+	 *  block and then through the block's predecessors, and places phis only where different definitions meet. A block
+	 *  must be sealed once all of its predecessors are known. Reads in a block before then get phis whose operands are
+	 *  filled in when it's sealed. Phis that turn out to merge only one value are removed, and finish() replaces their
+	 *  uses with that value. */
+	class SSABuilder {
+		private:
+			/** The variable's current value at the end of each block, by block id. */
+			std::vector<std::unordered_map<const Variable *, LLVMValuePtr>> definitions;
+			std::vector<bool> sealed;
+			/** Phis made before their block was sealed, by block id. */
+			std::vector<std::vector<std::pair<const Variable *, LLVMPhi *>>> incompletePhis;
+			/** The phis that haven't been removed, by result. */
+			std::unordered_map<const LLVMValue *, LLVMPhi *> phis;
+			/** The phis each phi is an operand of, by result. */
+			std::unordered_map<const LLVMValue *, std::vector<LLVMPhi *>> phiUsers;
+			/** What each removed phi's result stands for. */
+			std::unordered_map<const LLVMValue *, LLVMValuePtr> replacements;
+			size_t nextPhi = 0;
+
+			void reserve(const BasicBlock &);
+			LLVMValuePtr resolve(LLVMValuePtr) const;
+			LLVMPhi & addPhi(const Variable &, BasicBlock &);
+			LLVMValuePtr readRecursive(const Variable &, BasicBlock &);
+			LLVMValuePtr addPhiOperands(const Variable &, LLVMPhi &);
+			LLVMValuePtr tryRemoveTrivialPhi(LLVMPhi &);
+
+		public:
+			void write(const Variable &, BasicBlock &, LLVMValuePtr);
+			LLVMValuePtr read(const Variable &, BasicBlock &);
+			/** Declares that the block will get no more predecessors. */
+			void seal(BasicBlock &);
+			/** Replaces the uses of removed phis in the function's instructions. Every block has to be sealed. */
+			void finish(Function &);
+	};
+}
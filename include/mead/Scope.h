@@ -2,37 +2,54 @@
 
 #include "mead/Variable.h"
 
-#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace mead {
 	class Program;
+	class SymbolTable;
 	class Variable;
 
+	/** A marker for a level of a SymbolTable. A scope's variables are visible while it's open; nested scopes have to be
+	 *  opened and closed in stack order. The root scope is always open. A scope can start a table of its own, in which
+	 *  case names that aren't found in it are resolved in the parent, which is then only read. */
 	class Scope: public std::enable_shared_from_this<Scope> {
 		private:
-			std::map<std::string, std::shared_ptr<Variable>> variables;
+			std::shared_ptr<SymbolTable> symbols;
+			/** The scope names missing from this scope's table are looked up in. Null if there's no enclosing table. */
+			const Scope *outer = nullptr;
 			std::weak_ptr<Program> weakProgram;
 			/** Will be empty for the root scope. */
 			std::weak_ptr<Scope> weakParent;
 			std::vector<std::shared_ptr<Scope>> subscopes;
+			/** Variables declared directly in this scope, in declaration order, so that they can be pushed again if the
+			 *  scope is reopened. */
+			std::vector<std::pair<std::string, std::shared_ptr<Variable>>> variables;
 			ssize_t depth = 0;
+			bool isOpen = false;
 
 		public:
-			Scope(std::weak_ptr<Program>);
+			Scope(std::weak_ptr<Program>, std::shared_ptr<SymbolTable>);
 			Scope(const std::shared_ptr<Scope> &);
+			/** Creates a child scope that starts a new symbol table. */
+			Scope(const std::shared_ptr<Scope> &, std::shared_ptr<SymbolTable>);
 
 			std::shared_ptr<Program> getProgram() const;
+			/** Resolves the name in this scope and its ancestors. The scope has to be open. */
 			std::shared_ptr<Variable> getVariable(const std::string &name) const;
-			/** Returns whether the variable was successfully inserted. */
+			/** Returns whether the variable was successfully inserted. The scope has to be open. */
 			bool insertVariable(const std::string &name, std::shared_ptr<Variable> variable);
 			std::shared_ptr<Scope> addScope();
 
+			void open();
+			void close();
+
 			inline const auto & getVariables() const { return variables; }
 			inline const auto & getSubscopes() const { return subscopes; }
 			inline auto getDepth() const { return depth; }
+			inline bool getOpen() const { return isOpen; }
 
 			/** Returns whether the variable was successfully inserted. */
 			template <typename... Args>
@@ -42,5 +59,18 @@ namespace mead {
 			}
 	};
 
+	/** Keeps a scope open for its own lifetime. */
+	class ScopeGuard {
+		private:
+			Scope &scope;
+
+		public:
+			explicit ScopeGuard(Scope &scope): scope(scope) { scope.open(); }
+			~ScopeGuard() { scope.close(); }
+
+			ScopeGuard(const ScopeGuard &) = delete;
+			ScopeGuard & operator=(const ScopeGuard &) = delete;
+	};
+
 	using ScopePtr = std::shared_ptr<Scope>;
 }
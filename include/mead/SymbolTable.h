@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mead {
+	class Scope;
+	class Variable;
+
+	/** A block-structured symbol table shared by all scopes of a program. Each name maps to a stack of the declarations
+	 *  that are visible under it, innermost last. Opening a scope pushes its declarations and closing it pops them, so a
+	 *  lookup is a single hash probe no matter how deeply scopes are nested. */
+	class SymbolTable {
+		private:
+			struct Binding {
+				const Scope *scope;
+				ssize_t depth;
+				std::shared_ptr<Variable> variable;
+			};
+
+			std::unordered_map<std::string, std::vector<Binding>> bindings;
+
+		public:
+			/** Returns false if the scope already declares the name. */
+			bool push(const std::string &name, const Scope &, std::shared_ptr<Variable>);
+			void pop(const std::string &name, const Scope &);
+
+			/** Returns the innermost declaration of the name in a scope no deeper than the given depth. Open scopes form a
+			 *  chain, so this is the declaration visible from the open scope at that depth. */
+			std::shared_ptr<Variable> lookup(const std::string &name, ssize_t depth) const;
+	};
+}
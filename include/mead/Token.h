@@ -32,6 +32,9 @@ namespace mead {
 		Token();
 		Token(TokenType type, std::string value, SourceLocation location);
 	};
+
+	/** Returns the binary operator a compound assignment applies, or TokenType::Invalid if it isn't one. */
+	TokenType getCompoundOperator(TokenType);
 }
 
 template <>
@@ -1,38 +1,76 @@
 #pragma once
 
 #include "mead/Formattable.h"
+#include "mead/IntRules.h"
 #include "mead/LLVMType.h"
 #include "mead/Symbol.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace mead {
 	class Namespace;
+	class TypeContext;
 
 	class Type;
 	using TypePtr = std::shared_ptr<Type>;
 
+	enum class TypeKind {Int, Void, Pointer, LReference, Class, Invalid};
+
+	/** Types are immutable once created. Types created by a TypeContext are interned, so two structurally identical
+	 *  types from the same context are the same object. */
 	class Type: public Symbol, public Formattable, public std::enable_shared_from_this<Type> {
+		private:
+			friend class QualifiedType;
+			friend class TypeContext;
+			/** Null for types that weren't created by a TypeContext. */
+			TypeContext *context = nullptr;
+			/** The interned non-const variant of this type. Points to itself for non-const types. */
+			const Type *nonConstVariant = this;
+			/** Names are built on first use rather than on construction, and then kept for the type's lifetime. */
+			mutable std::once_flag nameFlag;
+			mutable std::once_flag mangledNameFlag;
+			mutable std::string cachedName;
+			mutable std::string cachedMangledName;
+
 		protected:
+			TypeKind kind;
 			bool isConst = false;
-			Type(std::string name, bool is_const);
+			Type(TypeKind kind, std::string name, bool is_const);
 			const char * getConstSuffix() const;
 
+			virtual std::string getNameImpl() const = 0;
+			/** Returns the type's encoding, which is a prefix-free string that depends only on the type's structure. */
+			virtual std::string getMangledNameImpl() const = 0;
+			/** Structural comparison used for types that aren't interned in a shared context. */
+			virtual bool isExactlyEquivalentImpl(const Type &, bool ignore_const) const = 0;
+			virtual bool isConvertibleToImpl(const Type &) const;
+
 		public:
 			virtual ~Type() = default;
 
-			virtual std::string getName() const = 0;
-			virtual TypePtr copy() const = 0;
+			inline TypeKind getKind() const { return kind; }
+			const std::string & getName() const;
+			/** Returns an identifier-safe encoding of the type, modelled on the Itanium C++ ABI's. Equivalent types have
+			 *  the same mangled name. */
+			const std::string & getMangledName() const;
 			virtual operator std::string() const;
 			virtual LLVMTypePtr toLLVM() const = 0;
 			virtual bool getConst() const;
-			virtual void setConst(bool);
-			virtual bool isExactlyEquivalent(const Type &, bool ignore_const) const = 0;
-			virtual bool isConvertibleTo(const Type &) const;
+			/** Returns the interned variant of this type with the given constness. */
+			TypePtr withConst(bool) const;
+			/** The interned variant without const, which identifies the type up to constness by address. Itself for
+			 *  types that aren't interned. */
+			inline const Type & getNonConstVariant() const { return *nonConstVariant; }
+			TypeContext & getContext() const;
+			inline bool isInterned() const { return context != nullptr; }
+			bool isExactlyEquivalent(const Type &, bool ignore_const) const;
+			bool isConvertibleTo(const Type &) const;
 			virtual TypePtr unwrapLReference();
 			/** Returns nullptr if the type can't be dereferenced. */
 			virtual TypePtr dereference() const;
+			std::format_context::iterator formatTo(std::format_context &) const override;
 	};
 
 
@@ -40,92 +78,117 @@ namespace mead {
 		private:
 			int bitWidth{};
 			bool isSigned{};
+			IntTypeId id{};
 			char getPrefix() const;
-			std::string getNameImpl() const;
+
+		protected:
+			std::string getNameImpl() const override;
+			std::string getMangledNameImpl() const override;
+			bool isExactlyEquivalentImpl(const Type &, bool ignore_const) const override;
+			bool isConvertibleToImpl(const Type &) const override;
 
 		public:
 			IntType(int bit_width, bool is_signed, bool is_const = false);
 
 			inline int getBitWidth() const { return bitWidth; }
-			std::string getName() const override;
-			TypePtr copy() const override;
-			bool isExactlyEquivalent(const Type &, bool ignore_const) const override;
+			inline bool getSigned() const { return isSigned; }
+			/** Indexes the tables in IntRules.h. */
+			inline IntTypeId getId() const { return id; }
 			LLVMTypePtr toLLVM() const override;
-			std::format_context::iterator formatTo(std::format_context &) const override;
+
+			static bool classof(const Type *type) { return type->getKind() == TypeKind::Int; }
 	};
 
 	class VoidType: public Type {
+		protected:
+			std::string getNameImpl() const override;
+			std::string getMangledNameImpl() const override;
+			bool isExactlyEquivalentImpl(const Type &, bool ignore_const) const override;
+
 		public:
 			explicit VoidType(bool is_const = false);
 
-			std::string getName() const override;
-			TypePtr copy() const override;
-			bool isExactlyEquivalent(const Type &, bool ignore_const) const override;
 			LLVMTypePtr toLLVM() const override;
-			std::format_context::iterator formatTo(std::format_context &) const override;
+
+			static bool classof(const Type *type) { return type->getKind() == TypeKind::Void; }
 	};
 
 	class PointerType: public Type {
 		private:
 			TypePtr subtype;
-			std::string getNameImpl() const;
+
+		protected:
+			std::string getNameImpl() const override;
+			std::string getMangledNameImpl() const override;
+			bool isExactlyEquivalentImpl(const Type &, bool ignore_const) const override;
+			bool isConvertibleToImpl(const Type &) const override;
 
 		public:
 			explicit PointerType(const TypePtr &subtype, bool is_const = false);
 
-			std::string getName() const override;
-			TypePtr copy() const override;
-			bool isExactlyEquivalent(const Type &, bool ignore_const) const override;
-			bool isConvertibleTo(const Type &) const override;
+			inline const auto & getSubtype() const { return subtype; }
 			LLVMTypePtr toLLVM() const override;
 			TypePtr dereference() const override;
-			std::format_context::iterator formatTo(std::format_context &) const override;
+
+			static bool classof(const Type *type) { return type->getKind() == TypeKind::Pointer; }
 	};
 
 	class LReferenceType: public Type {
 		private:
 			TypePtr subtype;
-			std::string getNameImpl() const;
+
+		protected:
+			std::string getNameImpl() const override;
+			std::string getMangledNameImpl() const override;
+			bool isExactlyEquivalentImpl(const Type &, bool ignore_const) const override;
+			bool isConvertibleToImpl(const Type &) const override;
 
 		public:
 			explicit LReferenceType(const TypePtr &subtype, bool is_const = false);
 
-			std::string getName() const override;
-			TypePtr copy() const override;
-			bool isExactlyEquivalent(const Type &, bool ignore_const) const override;
-			bool isConvertibleTo(const Type &) const override;
+			inline const auto & getSubtype() const { return subtype; }
 			LLVMTypePtr toLLVM() const override;
 			TypePtr unwrapLReference() override;
-			std::format_context::iterator formatTo(std::format_context &) const override;
 
 			static std::shared_ptr<LReferenceType> wrap(const TypePtr &);
+
+			static bool classof(const Type *type) { return type->getKind() == TypeKind::LReference; }
 	};
 
 	class ClassType: public Type {
 		private:
 			std::weak_ptr<Namespace> owner;
-			std::string getNameImpl() const;
 			// TODO: fields
 
+		protected:
+			std::string getNameImpl() const override;
+			std::string getMangledNameImpl() const override;
+			bool isExactlyEquivalentImpl(const Type &, bool ignore_const) const override;
+
 		public:
 			ClassType(std::string name, std::weak_ptr<Namespace> owner, bool is_const = false);
 
 			Namespace & getNamespace() const;
-			std::string getName() const override;
-			TypePtr copy() const override;
-			bool isExactlyEquivalent(const Type &, bool ignore_const) const override;
+			inline auto getOwner() const { return owner.lock(); }
+			/** Returns the name without the namespace qualification or const suffix. */
+			inline const std::string & getBaseName() const { return name; }
 			LLVMTypePtr toLLVM() const override;
 			std::format_context::iterator formatTo(std::format_context &) const override;
+
+			static bool classof(const Type *type) { return type->getKind() == TypeKind::Class; }
 	};
 
 	class InvalidType: public Type {
+		protected:
+			std::string getNameImpl() const override;
+			std::string getMangledNameImpl() const override;
+			bool isExactlyEquivalentImpl(const Type &, bool ignore_const) const override;
+
 		public:
 			explicit InvalidType(bool is_const = false);
 
-			std::string getName() const override;
-			TypePtr copy() const override;
-			bool isExactlyEquivalent(const Type &, bool ignore_const) const override;
 			LLVMTypePtr toLLVM() const override;
-			std::format_context::iterator formatTo(std::format_context &) const override;
+
+			static bool classof(const Type *type) { return type->getKind() == TypeKind::Invalid; }
 	};
 }
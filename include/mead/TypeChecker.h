@@ -0,0 +1,114 @@
+#pragma once
+
+#include "mead/error/ResolutionError.h"
+#include "mead/error/TypeError.h"
+#include "mead/ASTVisitor.h"
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mead {
+	class DiagnosticEngine;
+	class Function;
+	class IntType;
+	class Scope;
+	class Type;
+	class TypeContext;
+	class Variable;
+
+	/** Annotates expressions with their types and constness and checks how values are used: that initializers,
+	 *  assignments, arguments and return values convert to their targets, that names resolve and that calls pick an
+	 *  overload. Each visit method handles one node whose subexpressions are already annotated; check() drives them in
+	 *  post-order. Problems are reported to the program's DiagnosticEngine and checking carries on: an expression with
+	 *  an error is annotated with the invalid type, and nothing that uses it is reported again. Function bodies are
+	 *  checked in full before they're emitted, so every error in a body is reported and the emitter can rely on the
+	 *  annotations. */
+	class TypeChecker: public ConstASTVisitor<TypeChecker> {
+		private:
+			const Scope &scope;
+			DiagnosticEngine &diagnostics;
+			TypeContext &context;
+			/** The function whose body is being checked, or null outside of function bodies. */
+			const Function *function = nullptr;
+			/** The locals declared so far in the body, one map for each open block with the innermost last. They're
+			 *  looked up before the scope's variables. */
+			std::vector<std::unordered_map<std::string, std::shared_ptr<Variable>>> locals;
+			size_t errorCount = 0;
+
+			void error(const ASTNode &, std::string message);
+			void annotateInvalid(const Expression &);
+			std::shared_ptr<Type> getStatedType(const ASTNode &type_node) const;
+
+			std::expected<std::shared_ptr<Variable>, ResolutionError> resolve(const Identifier &) const;
+			/** Checks that the definition's initializer converts to its stated type. Succeeds without checking anything if
+			 *  the initializer already had an error. */
+			std::expected<void, TypeError> checkInitializer(const VariableDefinition &) const;
+			/** Checks that an annotated expression converts to a type for initialization, assignment, argument passing or
+			 *  return. References bind to an identifier or dereference of the same type instead. */
+			void checkConversion(const ASTNode &expression, const std::shared_ptr<Type> &target);
+			/** Checks that an annotated expression can be tested for being nonzero. */
+			void checkTruth(const ASTNode &expression);
+			/** Returns the annotated identifier or dereference that something modifies or takes the address of. Returns
+			 *  null after reporting an error if the node isn't one, and null without reporting anything if it already
+			 *  had an error. */
+			const Expression * getPlace(const ASTNode &node, std::string_view use);
+
+			void checkStatement(const ASTNode &);
+			void checkBlock(const ASTNode &);
+			void checkDeclaration(const ASTNode &declaration, const ASTNode *initializer);
+			/** Declares a local in the innermost block. Returns false after reporting an error if it's already there. */
+			bool declareLocal(const ASTNode &, const std::string &name, std::shared_ptr<Type>);
+
+			void checkUnary(const Expression &);
+			void checkStep(const Expression &);
+			void checkCast(const Expression &, const ASTNode &type_node, const ASTNode &subexpr);
+
+		public:
+			explicit TypeChecker(const Scope &);
+
+			/** Annotates every expression in the tree in a single post-order pass over an explicit stack, so each node is
+			 *  typed exactly once and nothing recurses deeply. Subtrees that are already annotated are skipped, as are
+			 *  nested statements other than the blocks of conditional expressions, which are checked in their own
+			 *  scopes. Returns the root's type if the root is an expression and nullptr otherwise. */
+			std::shared_ptr<Type> check(const ASTNode &root);
+
+			/** Checks every statement in the body of a function definition, with its parameters declared. The function's
+			 *  scope has to be open. Returns whether no errors were found. */
+			bool checkFunction(const Function &);
+
+			inline size_t getErrorCount() const { return errorCount; }
+
+			/** Returns the type integer operands are converted to for a binary operator, or null if there's none. The
+			 *  rules are the Interpreter's: a literal takes the other side's type if its value fits, and otherwise the
+			 *  common type comes from the table. */
+			static std::shared_ptr<IntType> getOperationType(const ASTNode &lhs, const std::shared_ptr<IntType> &lhs_type, const ASTNode &rhs, const std::shared_ptr<IntType> &rhs_type);
+
+			void visitAssign(const Expression &);
+			void visitBinary(const Binary &);
+			void visitBitwiseNot(const Expression &);
+			void visitCast(const Expression &);
+			void visitComma(const Expression &);
+			void visitCompoundAssign(const Expression &);
+			void visitConditionalExpression(const Expression &);
+			void visitConstructorCall(const Expression &);
+			void visitDeref(const Dereference &);
+			void visitFunctionCall(const FunctionCall &);
+			void visitGetAddress(const GetAddress &);
+			void visitIdentifier(const Identifier &);
+			void visitLogicalNot(const Expression &);
+			void visitNumber(const Number &);
+			void visitPostfixDecrement(const Expression &);
+			void visitPostfixIncrement(const Expression &);
+			void visitPrefixDecrement(const Expression &);
+			void visitPrefixIncrement(const Expression &);
+			void visitString(const Expression &);
+			void visitUnaryMinus(const Expression &);
+			void visitUnaryPlus(const Expression &);
+			void visitVariableDefinition(const VariableDefinition &);
+	};
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "mead/Type.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace mead {
+	class Namespace;
+
+	/** Creates and owns types. Types are interned by structure (kind, subtype, constness, bit width), so equivalent types
+	 *  are always the same object and can be compared by address. All public methods are safe to call concurrently. */
+	class TypeContext {
+		private:
+			struct PairHash {
+				template <typename A, typename B>
+				size_t operator()(const std::pair<A, B> &pair) const {
+					return std::hash<A>{}(pair.first) * 31 + std::hash<B>{}(pair.second);
+				}
+			};
+
+			struct ClassKey {
+				const Namespace *owner;
+				std::string name;
+				bool isConst;
+
+				bool operator==(const ClassKey &) const = default;
+			};
+
+			struct ClassKeyHash {
+				size_t operator()(const ClassKey &key) const {
+					return (std::hash<const Namespace *>{}(key.owner) * 31 + std::hash<std::string>{}(key.name)) * 2 + key.isConst;
+				}
+			};
+
+			/** Indexed by [IntTypeId][is_const]. Filled on construction and never modified, so reads don't need the lock. */
+			std::array<std::array<std::shared_ptr<IntType>, 2>, intTypeCount> intTypes;
+			std::array<std::shared_ptr<VoidType>, 2> voidTypes;
+			std::array<std::shared_ptr<InvalidType>, 2> invalidTypes;
+			std::unordered_map<std::pair<const Type *, bool>, std::shared_ptr<PointerType>, PairHash> pointerTypes;
+			std::unordered_map<std::pair<const Type *, bool>, std::shared_ptr<LReferenceType>, PairHash> lreferenceTypes;
+			std::unordered_map<ClassKey, std::shared_ptr<ClassType>, ClassKeyHash> classTypes;
+			/** Memoized results of isConvertibleTo for pairs of interned types. */
+			std::unordered_map<std::pair<const Type *, const Type *>, bool, PairHash> conversions;
+			/** Recursive because creating a const type creates its non-const variant first. */
+			std::recursive_mutex mutex;
+
+			template <typename T>
+			const std::shared_ptr<T> & adopt(const std::shared_ptr<T> &, const Type *non_const_variant);
+
+		public:
+			TypeContext();
+
+			TypeContext(const TypeContext &) = delete;
+			TypeContext(TypeContext &&) = delete;
+
+			TypeContext & operator=(const TypeContext &) = delete;
+			TypeContext & operator=(TypeContext &&) = delete;
+
+			std::shared_ptr<IntType> getInt(int bit_width, bool is_signed, bool is_const = false);
+			inline const std::shared_ptr<IntType> & getIntById(IntTypeId id, bool is_const = false) const { return intTypes[id][is_const]; }
+			std::shared_ptr<VoidType> getVoid(bool is_const = false);
+			std::shared_ptr<InvalidType> getInvalid(bool is_const = false);
+			std::shared_ptr<PointerType> getPointer(const TypePtr &subtype, bool is_const = false);
+			/** If the subtype is itself an lreference, it's unwrapped first. */
+			std::shared_ptr<LReferenceType> getLReference(const TypePtr &subtype, bool is_const = false);
+			std::shared_ptr<ClassType> getClass(const std::string &name, const std::shared_ptr<Namespace> &owner, bool is_const = false);
+
+			/** Returns the interned variant of an interned type with the given constness. */
+			TypePtr withConst(const Type &, bool is_const);
+			/** Looks up or computes whether one interned type is convertible to another. */
+			bool isConvertible(const Type &from, const Type &to);
+	};
+}
@@ -4,13 +4,17 @@
 #include "mead/Type.h"
 
 #include <map>
+#include <memory>
 
 namespace mead {
+	class TypeContext;
+
 	class TypeDB {
 		private:
+			std::shared_ptr<TypeContext> context;
 			std::map<NamespacedName, TypePtr> types;
 
-			static std::map<NamespacedName, TypePtr> getDefaultTypes();
+			static std::map<NamespacedName, TypePtr> getDefaultTypes(TypeContext &);
 
 		public:
 			TypeDB();
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "mead/LLVMValue.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace mead {
+	class Function;
+	class LLVMInstruction;
+
+	/** Where each value is defined and read in a function, found by scanning the operands of its LLVM instructions.
+	 *  Values are told apart by identity, so a constant written out twice is two values with a use each. Uses point at
+	 *  operand slots, so adding incoming values to a phi invalidates the phi's; forget() it first and add() it again
+	 *  after. */
+	class UseLists {
+		public:
+			struct Use {
+				LLVMInstruction *user;
+				LLVMValuePtr *operand;
+			};
+
+		private:
+			std::unordered_map<const LLVMValue *, std::vector<Use>> uses;
+			std::unordered_map<const LLVMValue *, LLVMInstruction *> definitions;
+
+		public:
+			explicit UseLists(Function &);
+
+			/** In block order and then instruction order, as of when they were found. */
+			const std::vector<Use> & getUses(const LLVMValue &) const;
+			inline bool hasUses(const LLVMValue &value) const { return !getUses(value).empty(); }
+			/** Null for parameters and for values defined outside the function. */
+			LLVMInstruction * getDefinition(const LLVMValue &) const;
+
+			/** Records an instruction that was added to the function. */
+			void add(LLVMInstruction &);
+			/** Drops an instruction's uses and definition, for when it's about to be removed or changed. Uses of its result
+			 *  are kept. */
+			void forget(LLVMInstruction &);
+			/** Points every use of a value at another one. */
+			void replaceAllUses(const LLVMValue &, const LLVMValuePtr &replacement);
+	};
+}
@@ -1,13 +1,15 @@
 #pragma once
 
 #include <format>
-#include <stdexcept>
+#include <string>
 
 namespace mead {
-	struct ResolutionError: std::runtime_error {
+	/** A name that doesn't refer to anything in scope. Reported as a diagnostic rather than thrown. */
+	struct ResolutionError {
 		std::string symbol;
+		std::string message;
 
 		ResolutionError(std::string symbol):
-			std::runtime_error(std::format("Failed to resolve \"{}\"", symbol)), symbol(std::move(symbol)) {}
+			symbol(std::move(symbol)), message(std::format("Unknown variable {}", this->symbol)) {}
 	};
 }
@@ -1,15 +1,16 @@
 #pragma once
 
-#include <format>
 #include <memory>
-#include <stdexcept>
+#include <string>
 
 namespace mead {
 	class Type;
 
-	struct TypeError: std::runtime_error {
+	/** A value that doesn't convert to the type it's used as. Reported as a diagnostic rather than thrown. */
+	struct TypeError {
 		std::shared_ptr<Type> from;
 		std::shared_ptr<Type> to;
+		std::string message;
 
 		TypeError(std::shared_ptr<Type> from, std::shared_ptr<Type> to);
 	};
@@ -6,11 +6,9 @@ namespace mead {
 	class Binary: public Expression {
 		public:
 			Binary(Token);
+			static bool classof(const ASTNode *node) { return node->type == NodeType::Binary; }
 
 			ExpressionPtr getLHS() const;
 			ExpressionPtr getRHS() const;
-
-			std::shared_ptr<Type> getType(const Scope &) const override;
-			bool isConstant(const Scope &) const override;
 	};
 }
@@ -6,7 +6,6 @@ namespace mead {
 	class Block: public Statement {
 		public:
 			Block(Token token);
-
-			bool compile(Compiler &, Function &, Scope &, std::shared_ptr<BasicBlock>) final;
+			static bool classof(const ASTNode *node) { return node->type == NodeType::Block; }
 	};
 }
\ No newline at end of file
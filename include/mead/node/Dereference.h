@@ -6,8 +6,6 @@ namespace mead {
 	class Dereference: public Expression {
 		public:
 			Dereference(Token);
-
-			std::shared_ptr<Type> getType(const Scope &) const override;
-			bool isConstant(const Scope &) const override;
+			static bool classof(const ASTNode *node) { return node->type == NodeType::Deref; }
 	};
 }
@@ -9,16 +9,32 @@ namespace mead {
 	class Type;
 
 	class Expression: public ASTNode {
-		protected:
-			using ASTNode::ASTNode;
+		private:
+			/** Set by the TypeChecker. Each node sits in exactly one scope, so the annotations stay valid for as long as
+			 *  the node is in the tree. */
+			mutable std::shared_ptr<Type> annotatedType;
+			mutable bool annotatedConstant = false;
+			mutable bool annotated = false;
+
+			void annotate(std::shared_ptr<Type>, bool is_constant) const;
+
+			friend class TypeChecker;
 
 		public:
-			virtual std::shared_ptr<Type> getType(const Scope &) const = 0;
+			using ASTNode::ASTNode;
+
+			/** Returns the type annotation, type checking the expression first if necessary. */
+			std::shared_ptr<Type> getType(const Scope &) const;
 			/** Returns whether the expression can be evaluated at compile time. */
-			virtual bool isConstant(const Scope &) const = 0;
+			bool isConstant(const Scope &) const;
+
+			inline const auto & getAnnotatedType() const { return annotatedType; }
+			inline bool isAnnotated() const { return annotated; }
+
+			static bool classof(const ASTNode *node) { return getNodeCategory(node->type) == NodeCategory::Expression; }
 
 			// TODO: getAddress or compileAddress or some better name
 	};
 
 	using ExpressionPtr = std::shared_ptr<Expression>;
-}
\ No newline at end of file
+}
@@ -1,16 +1,27 @@
 #pragma once
 
 #include "mead/node/Expression.h"
+#include "mead/OverloadSet.h"
+
+#include <memory>
 
 namespace mead {
+	class Identifier;
+	class Namespace;
+
 	class FunctionCall: public Expression {
 		public:
 			FunctionCall(Token);
+			static bool classof(const ASTNode *node) { return node->type == NodeType::FunctionCall; }
 
 			ASTNodePtr getFunction() const;
 			ASTNodePtr getArgs() const;
-
-			std::shared_ptr<Type> getType(const Scope &) const override;
-			bool isConstant(const Scope &) const override;
+			/** Returns the callee if it's named by an identifier, or null otherwise. */
+			const Identifier * getCalleeName() const;
+			/** Returns the functions the callee names, or null if it doesn't name any in the namespace. */
+			std::shared_ptr<const OverloadSet> getOverloads(const Namespace &) const;
+			/** Picks the overload the call resolves to in the scope's program. The arguments are only type checked if
+			 *  the name is overloaded. */
+			OverloadSet::Resolution resolveCallee(const Scope &) const;
 	};
 }
@@ -6,8 +6,6 @@ namespace mead {
 	class GetAddress: public Expression {
 		public:
 			GetAddress(Token);
-
-			std::shared_ptr<Type> getType(const Scope &) const override;
-			bool isConstant(const Scope &) const;
+			static bool classof(const ASTNode *node) { return node->type == NodeType::GetAddress; }
 	};
 }
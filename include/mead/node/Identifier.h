@@ -6,9 +6,7 @@ namespace mead {
 	class Identifier: public Expression {
 		public:
 			Identifier(Token);
-
-			std::shared_ptr<Type> getType(const Scope &) const override;
-			bool isConstant(const Scope &) const override;
+			static bool classof(const ASTNode *node) { return node->type == NodeType::Identifier; }
 
 			inline const std::string & getIdentifier() const { return token.value; }
 	};
@@ -3,6 +3,9 @@
 #include "mead/node/Expression.h"
 
 #include <concepts>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 
 
@@ -19,16 +22,31 @@ namespace mead {
 	F parseNumber(std::string_view view);
 
 
+	class IntType;
+	class TypeContext;
+
 	class Number: public Expression {
+		private:
+			/** Set for numbers produced by constant folding. Literals from the source are i64 const. */
+			std::shared_ptr<IntType> literalType;
+
 		public:
 			Number(Token);
-
-			std::shared_ptr<Type> getType(const Scope &) const override;
-			bool isConstant(const Scope &) const override;
+			Number(Token, std::shared_ptr<IntType> literal_type);
+			static bool classof(const ASTNode *node) { return node->type == NodeType::Number; }
 
 			template <typename T>
 			T getNumber() const {
 				return parseNumber<T>(token.value);
 			}
+
+			/** Parses decimal, hexadecimal (0x) and octal (leading 0) literals, skipping digit separators. A leading minus
+			 *  sign, which only folded numbers have, negates the value with wraparound. Empty if the digits don't fit in
+			 *  64 bits. */
+			std::optional<uint64_t> getValue() const;
+			/** Whether the number was produced by constant folding rather than written in the source. Only source
+			 *  literals take the type of whatever they're combined with. */
+			inline bool isFolded() const { return literalType != nullptr; }
+			std::shared_ptr<IntType> getIntType(TypeContext &) const;
 	};
 }
@@ -11,6 +11,7 @@ namespace mead {
 	class Return: public Statement {
 		public:
 			Return(Token token);
+			static bool classof(const ASTNode *node) { return node->type == NodeType::ReturnStatement; }
 
 			std::shared_ptr<Expression> getExpression() const;
 	};
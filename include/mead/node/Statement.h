@@ -2,19 +2,12 @@
 
 #include "mead/ASTNode.h"
 
-#include <memory>
-
 namespace mead {
-	class BasicBlock;
-	class Compiler;
-	class Function;
-	class Scope;
-
 	class Statement: public ASTNode {
 		protected:
 			using ASTNode::ASTNode;
 
 		public:
-			virtual bool compile(Compiler &, Function &, Scope &, std::shared_ptr<BasicBlock>);
+			static bool classof(const ASTNode *node) { return getNodeCategory(node->type) == NodeCategory::Statement; }
 	};
 }
\ No newline at end of file
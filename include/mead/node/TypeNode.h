@@ -1,15 +1,27 @@
 #pragma once
 
 #include "mead/ASTNode.h"
+#include "mead/NamespacedName.h"
 
 namespace mead {
 	class Namespace;
+	class QualifiedType;
 	class Type;
 
 	class TypeNode: public ASTNode {
+		private:
+			/** The possibly qualified name of the base type. The token is only its last component. */
+			NamespacedName name;
+
 		public:
 			TypeNode(Token);
+			TypeNode(Token, NamespacedName);
+			static bool classof(const ASTNode *node) { return node->type == NodeType::Type; }
 
+			inline const auto & getName() const { return name; }
+			/** Resolves the base type from the given namespace and applies the qualifiers without interning anything. */
+			QualifiedType getQualifiedType(const std::shared_ptr<Namespace> &) const;
+			/** Resolves the base type from the given namespace and applies the qualifiers. */
 			std::shared_ptr<Type> getType(const std::shared_ptr<Namespace> &) const;
 	};
 }
@@ -11,9 +11,9 @@ namespace mead {
 	class VariableDefinition: public Statement {
 		public:
 			VariableDefinition(Token token);
+			static bool classof(const ASTNode *node) { return node->type == NodeType::VariableDefinition; }
 
 			const std::string & getVariableName() const;
 			std::shared_ptr<Expression> getExpression() const;
-			bool compile(Compiler &, Function &, Scope &, std::shared_ptr<BasicBlock>) final;
 	};
 }
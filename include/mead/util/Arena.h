@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	/** Allocates objects by bumping a pointer through large chunks, which are all freed when the arena is destroyed.
+	 *  Objects that need destroying are destroyed then too, newest first, and never before. Not thread-safe. */
+	class Arena {
+		private:
+			struct Destructor {
+				void *object;
+				void (*destroy)(void *);
+			};
+
+			static constexpr size_t chunkSize = 4096;
+
+			std::vector<std::unique_ptr<std::byte[]>> chunks;
+			std::byte *next = nullptr;
+			std::byte *end = nullptr;
+			std::vector<Destructor> destructors;
+
+			void * allocate(size_t size, size_t alignment) {
+				auto misalignment = reinterpret_cast<uintptr_t>(next) & (alignment - 1);
+				std::byte *start = next + (misalignment? alignment - misalignment : 0);
+
+				if (!next || end < start + size) {
+					// Objects too big for a chunk get one of their own, which leaves the current chunk in use.
+					const size_t chunk_size = std::max(chunkSize, size + alignment);
+					std::byte *chunk = chunks.emplace_back(new std::byte[chunk_size]).get();
+					misalignment = reinterpret_cast<uintptr_t>(chunk) & (alignment - 1);
+					start = chunk + (misalignment? alignment - misalignment : 0);
+					if (chunk_size == chunkSize || !next) {
+						next = start + size;
+						end = chunk + chunk_size;
+					}
+					return start;
+				}
+
+				next = start + size;
+				return start;
+			}
+
+		public:
+			Arena() = default;
+
+			Arena(const Arena &) = delete;
+			Arena(Arena &&) = delete;
+
+			Arena & operator=(const Arena &) = delete;
+			Arena & operator=(Arena &&) = delete;
+
+			~Arena() {
+				for (auto iter = destructors.rbegin(); iter != destructors.rend(); ++iter)
+					iter->destroy(iter->object);
+			}
+
+			template <typename T, typename... Args>
+			T * create(Args &&...args) {
+				T *out = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+				if constexpr (!std::is_trivially_destructible_v<T>)
+					destructors.push_back({out, [](void *object) { static_cast<T *>(object)->~T(); }});
+				return out;
+			}
+	};
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+
+// LLVM-style checked casts. A class participates by providing `static bool classof(const Base *)`, which inspects the
+// base's kind discriminator instead of going through RTTI.
+
+namespace mead {
+	namespace detail {
+		template <typename T>
+		struct IsSharedPtr: std::false_type {};
+
+		template <typename T>
+		struct IsSharedPtr<std::shared_ptr<T>>: std::true_type {};
+
+		/** Types that the reference overloads should accept, so that pointers and shared_ptrs go to their own overloads. */
+		template <typename T>
+		concept Castable = !std::is_pointer_v<T> && !IsSharedPtr<std::remove_cv_t<T>>::value;
+	}
+
+	template <typename To, typename From>
+	inline bool isa(From *value) {
+		assert(value);
+		if constexpr (std::is_base_of_v<To, From>)
+			return true;
+		else
+			return To::classof(value);
+	}
+
+	template <typename To, detail::Castable From>
+	inline bool isa(const From &value) {
+		return isa<To>(&value);
+	}
+
+	template <typename To, typename From>
+	inline bool isa(const std::shared_ptr<From> &value) {
+		return isa<To>(value.get());
+	}
+
+	/** Like isa, but returns false for null instead of asserting. */
+	template <typename To, typename From>
+	inline bool isa_and_present(From *value) {
+		return value && isa<To>(value);
+	}
+
+	template <typename To, typename From>
+	inline bool isa_and_present(const std::shared_ptr<From> &value) {
+		return isa_and_present<To>(value.get());
+	}
+
+	template <typename To, typename From>
+	inline auto cast(From *value) -> std::conditional_t<std::is_const_v<From>, const To *, To *> {
+		assert(isa<To>(value));
+		return static_cast<std::conditional_t<std::is_const_v<From>, const To *, To *>>(value);
+	}
+
+	template <typename To, detail::Castable From>
+	inline auto cast(From &value) -> std::conditional_t<std::is_const_v<From>, const To &, To &> {
+		return *cast<To>(&value);
+	}
+
+	template <typename To, typename From>
+	inline std::shared_ptr<To> cast(const std::shared_ptr<From> &value) {
+		assert(isa<To>(value));
+		return std::static_pointer_cast<To>(value);
+	}
+
+	/** Returns null if the value isn't an instance of To. The value itself must not be null. */
+	template <typename To, typename From>
+	inline auto dyn_cast(From *value) -> std::conditional_t<std::is_const_v<From>, const To *, To *> {
+		return isa<To>(value)? cast<To>(value) : nullptr;
+	}
+
+	template <typename To, typename From>
+	inline std::shared_ptr<To> dyn_cast(const std::shared_ptr<From> &value) {
+		return isa<To>(value)? std::static_pointer_cast<To>(value) : nullptr;
+	}
+
+	/** Like dyn_cast, but passes null through instead of asserting. */
+	template <typename To, typename From>
+	inline auto dyn_cast_if_present(From *value) -> std::conditional_t<std::is_const_v<From>, const To *, To *> {
+		return value? dyn_cast<To>(value) : nullptr;
+	}
+
+	template <typename To, typename From>
+	inline std::shared_ptr<To> dyn_cast_if_present(const std::shared_ptr<From> &value) {
+		return value? dyn_cast<To>(value) : nullptr;
+	}
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace mead {
+	template <typename T>
+	class IntrusiveList;
+
+	/** The links a type needs to be in an IntrusiveList. A node can only be in one list at a time. */
+	template <typename T>
+	class IntrusiveListNode {
+		private:
+			T *previous = nullptr;
+			T *next = nullptr;
+
+			friend class IntrusiveList<T>;
+
+		public:
+			inline T * getPrevious() const { return previous; }
+			inline T * getNext() const { return next; }
+	};
+
+	/** A doubly linked list of nodes it doesn't own, linked through the nodes themselves so that nothing is allocated
+	 *  per node. Inserting, removing and splicing are constant time. */
+	template <typename T>
+	class IntrusiveList {
+		private:
+			T *head = nullptr;
+			T *tail = nullptr;
+
+			static IntrusiveListNode<T> & links(T &node) { return static_cast<IntrusiveListNode<T> &>(node); }
+
+			template <typename U>
+			class Iterator {
+				private:
+					U *node = nullptr;
+					const IntrusiveList *list = nullptr;
+
+				public:
+					using iterator_category = std::bidirectional_iterator_tag;
+					using value_type = std::remove_const_t<U>;
+					using difference_type = std::ptrdiff_t;
+					using pointer = U *;
+					using reference = U &;
+
+					Iterator() = default;
+					Iterator(U *node, const IntrusiveList *list):
+						node(node), list(list) {}
+
+					inline U & operator*() const { return *node; }
+					inline U * operator->() const { return node; }
+					inline U * get() const { return node; }
+
+					Iterator & operator++() { node = node->getNext(); return *this; }
+					Iterator operator++(int) { Iterator out = *this; ++*this; return out; }
+					// Going back from the end gives the last node.
+					Iterator & operator--() { node = node? node->getPrevious() : list->tail; return *this; }
+					Iterator operator--(int) { Iterator out = *this; --*this; return out; }
+
+					bool operator==(const Iterator &other) const { return node == other.node; }
+			};
+
+		public:
+			using iterator = Iterator<T>;
+			using const_iterator = Iterator<const T>;
+
+			IntrusiveList() = default;
+
+			IntrusiveList(const IntrusiveList &) = delete;
+			IntrusiveList & operator=(const IntrusiveList &) = delete;
+
+			inline bool empty() const { return !head; }
+			inline T & front() const { assert(head); return *head; }
+			inline T & back() const { assert(tail); return *tail; }
+
+			inline iterator begin() { return {head, this}; }
+			inline iterator end() { return {nullptr, this}; }
+			inline const_iterator begin() const { return {head, this}; }
+			inline const_iterator end() const { return {nullptr, this}; }
+
+			/** Links an unlinked node in front of another node of this list, or at the end if that's null. */
+			void insertBefore(T *position, T &node) {
+				auto &node_links = links(node);
+				assert(!node_links.previous && !node_links.next && head != &node);
+
+				node_links.next = position;
+				node_links.previous = position? links(*position).previous : tail;
+
+				if (node_links.previous)
+					links(*node_links.previous).next = &node;
+				else
+					head = &node;
+
+				if (position)
+					links(*position).previous = &node;
+				else
+					tail = &node;
+			}
+
+			void insertAfter(T &position, T &node) {
+				insertBefore(links(position).next, node);
+			}
+
+			void pushBack(T &node) {
+				insertBefore(nullptr, node);
+			}
+
+			/** Unlinks a node of this list. */
+			void remove(T &node) {
+				auto &node_links = links(node);
+
+				if (node_links.previous)
+					links(*node_links.previous).next = node_links.next;
+				else
+					head = node_links.next;
+
+				if (node_links.next)
+					links(*node_links.next).previous = node_links.previous;
+				else
+					tail = node_links.previous;
+
+				node_links.previous = node_links.next = nullptr;
+			}
+
+			/** Moves the nodes of another list from first up to but not including last, or to the end if last is null, in
+			 *  front of position, or at the end if that's null. Position mustn't be one of the nodes moved. */
+			void splice(T *position, IntrusiveList &other, T &first, T *last) {
+				T *last_moved = last? links(*last).previous : other.tail;
+				assert(last_moved);
+
+				// Unlink the range from the other list.
+				T *before = links(first).previous;
+				if (before)
+					links(*before).next = last;
+				else
+					other.head = last;
+				if (last)
+					links(*last).previous = before;
+				else
+					other.tail = before;
+
+				// Link it into this one.
+				T *after = position;
+				T *new_before = position? links(*position).previous : tail;
+				links(first).previous = new_before;
+				links(*last_moved).next = after;
+				if (new_before)
+					links(*new_before).next = &first;
+				else
+					head = &first;
+				if (after)
+					links(*after).previous = last_moved;
+				else
+					tail = last_moved;
+			}
+	};
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	/** A fixed set of worker threads that take submitted tasks in submission order. A pool without workers runs each
+	 *  task on the submitting thread before submit() returns. Pending tasks are finished before the pool is destroyed. */
+	class ThreadPool {
+		private:
+			std::vector<std::thread> workers;
+			std::queue<std::function<void()>> tasks;
+			std::mutex mutex;
+			std::condition_variable condition;
+			bool stopping = false;
+
+			void work() {
+				for (;;) {
+					std::function<void()> task;
+
+					{
+						std::unique_lock lock(mutex);
+						condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+						if (tasks.empty())
+							return;
+						task = std::move(tasks.front());
+						tasks.pop();
+					}
+
+					task();
+				}
+			}
+
+		public:
+			explicit ThreadPool(size_t thread_count = std::thread::hardware_concurrency()) {
+				workers.reserve(thread_count);
+				for (size_t i = 0; i < thread_count; ++i)
+					workers.emplace_back([this] { work(); });
+			}
+
+			~ThreadPool() {
+				{
+					std::lock_guard lock(mutex);
+					stopping = true;
+				}
+
+				condition.notify_all();
+
+				for (std::thread &worker : workers)
+					worker.join();
+			}
+
+			ThreadPool(const ThreadPool &) = delete;
+			ThreadPool(ThreadPool &&) = delete;
+
+			ThreadPool & operator=(const ThreadPool &) = delete;
+			ThreadPool & operator=(ThreadPool &&) = delete;
+
+			inline size_t size() const { return workers.size(); }
+
+			/** Returns a future for the task's result. Exceptions thrown by the task are rethrown by the future. */
+			template <typename F>
+			auto submit(F &&function) -> std::future<std::invoke_result_t<F>> {
+				using R = std::invoke_result_t<F>;
+				// std::function needs a copyable target, and packaged_task isn't one.
+				auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(function));
+				std::future<R> future = task->get_future();
+
+				if (workers.empty()) {
+					(*task)();
+					return future;
+				}
+
+				{
+					std::lock_guard lock(mutex);
+					tasks.emplace([task] { (*task)(); });
+				}
+
+				condition.notify_one();
+				return future;
+			}
+	};
+}
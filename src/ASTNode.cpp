@@ -1,63 +1,21 @@
+#include "mead/node/Expression.h"
 #include "mead/ASTNode.h"
 
 #include <cassert>
 #include <print>
 
 namespace mead {
-	std::map<NodeType, const char *> nodeTypes{
-		{NodeType::Invalid, "Invalid"},
-		{NodeType::FunctionPrototype, "FunctionPrototype"},
-		{NodeType::FunctionDeclaration, "FunctionDeclaration"},
-		{NodeType::FunctionDefinition, "FunctionDefinition"},
-		{NodeType::FunctionCall, "FunctionCall"},
-		{NodeType::VariableDeclaration, "VariableDeclaration"},
-		{NodeType::VariableDefinition, "VariableDefinition"},
-		{NodeType::Identifier, "Identifier"},
-		{NodeType::Type, "Type"},
-		{NodeType::Block, "Block"},
-		{NodeType::Const, "Const"},
-		{NodeType::Pointer, "Pointer"},
-		{NodeType::LReference, "LReference"},
-		{NodeType::PrefixIncrement, "PrefixIncrement"},
-		{NodeType::PrefixDecrement, "PrefixDecrement"},
-		{NodeType::PostfixIncrement, "PostfixIncrement"},
-		{NodeType::PostfixDecrement, "PostfixDecrement"},
-		{NodeType::ConstructorCall, "Constructor"},
-		{NodeType::UnaryExpression, "Unary"},
-		{NodeType::Cast, "Cast"},
-		{NodeType::Sizeof, "Sizeof"},
-		{NodeType::SingleNew, "SingleNew"},
-		{NodeType::ArrayNew, "ArrayNew"},
-		{NodeType::EmptyPrime, "EmptyPrime"},
-		{NodeType::EmptyStatement, "EmptyStatement"},
-		{NodeType::Scope, "Scope"},
-		{NodeType::Expressions, "Expressions"},
-		{NodeType::Subscript, "Subscript"},
-		{NodeType::Number, "Number"},
-		{NodeType::String, "String"},
-		{NodeType::Binary, "Binary"},
-		{NodeType::AccessMember, "AccessMember"},
-		{NodeType::Deref, "Deref"},
-		{NodeType::GetAddress, "GetAddress"},
-		{NodeType::UnaryPlus, "UnaryPlus"},
-		{NodeType::UnaryMinus, "UnaryMinus"},
-		{NodeType::LogicalNot, "LogicalNot"},
-		{NodeType::BitwiseNot, "BitwiseNot"},
-		{NodeType::Delete, "Delete"},
-		{NodeType::Assign, "Assign"},
-		{NodeType::CompoundAssign, "CompoundAssign"},
-		{NodeType::ConditionalExpression, "ConditionalExpression"},
-		{NodeType::Comma, "Comma"},
-		{NodeType::ExpressionStatement, "ExpressionStatement"},
-		{NodeType::IfStatement, "IfStatement"},
-		{NodeType::ReturnStatement, "ReturnStatement"},
-	};
-
 	ASTNode::ASTNode() = default;
 
 	ASTNode::ASTNode(NodeType type, Token token, std::weak_ptr<ASTNode> parent):
 		type(type), token(std::move(token)), weakParent(std::move(parent)) {}
 
+	std::shared_ptr<ASTNode> ASTNode::make(NodeType type, Token token) {
+		if (getNodeCategory(type) == NodeCategory::Expression)
+			return std::make_shared<Expression>(type, std::move(token));
+		return std::make_shared<ASTNode>(type, std::move(token));
+	}
+
 	std::shared_ptr<ASTNode> ASTNode::reparent(std::weak_ptr<ASTNode> new_parent) {
 		auto self = shared_from_this();
 
@@ -91,10 +49,27 @@ namespace mead {
 		weakParent.reset();
 	}
 
+	void ASTNode::replaceWith(const std::shared_ptr<ASTNode> &replacement) {
+		ASTNodePtr parent = weakParent.lock();
+		assert(parent);
+		assert(replacement->weakParent.expired());
+
+		auto self = shared_from_this();
+		for (ASTNodePtr &child : parent->children) {
+			if (child == self) {
+				child = replacement;
+				break;
+			}
+		}
+
+		replacement->weakParent = parent;
+		weakParent.reset();
+	}
+
 	std::ostream & ASTNode::debug(std::ostream &stream, size_t padding) const {
 		std::string node_name;
-		if (auto iter = nodeTypes.find(type); iter != nodeTypes.end())
-			node_name = iter->second;
+		if (const char *name = getNodeTypeName(type))
+			node_name = name;
 		else
 			node_name = std::format("\x1b[31m[NodeType={}?]\x1b[39m", static_cast<int>(type));
 		std::println(stream, "{}{}: {}", std::string(padding, ' '), node_name, token);
@@ -1,21 +1,60 @@
 #include "mead/BasicBlock.h"
+#include "mead/Function.h"
+
+#include <algorithm>
 
 namespace mead {
-	BasicBlock::BasicBlock(Function &parent):
-		parent(&parent) {}
+	BasicBlock::BasicBlock(Function &parent, std::string label):
+		parent(&parent), arena(&parent.getInstructionArena()), id(parent.takeBlockId()), label(std::move(label)) {}
 
 	void BasicBlock::connectTo(BasicBlock &other) {
-		out.insert(other.weak_from_this());
-		other.in.insert(weak_from_this());
+		assert(other.parent == parent);
+
+		// Blocks have few edges, so a linear search beats anything with more indirection.
+		if (std::ranges::find(successors, &other) != successors.end())
+			return;
+
+		successors.push_back(&other);
+		other.predecessors.push_back(this);
+		parent->invalidateControlFlow();
 	}
 
 	void BasicBlock::disconnect(BasicBlock &other) {
-		auto weak_other = other.weak_from_this();
-		in.erase(weak_other);
-		out.erase(weak_other);
+		std::erase(successors, &other);
+		std::erase(predecessors, &other);
+		std::erase(other.successors, this);
+		std::erase(other.predecessors, this);
+		parent->invalidateControlFlow();
+	}
+
+	bool BasicBlock::isTerminated() const {
+		return !instructions.empty() && instructions.back().isTerminator();
+	}
+
+	std::string BasicBlock::toString() const {
+		std::string out = label + ":\n";
+		for (const Instruction &instruction : instructions) {
+			out += "  ";
+			out += instruction.toString();
+			out += '\n';
+		}
+		return out;
+	}
+
+	void BasicBlock::remove(Instruction &instruction) {
+		assert(instruction.parent == this);
+		instructions.remove(instruction);
+		instruction.parent = nullptr;
+	}
+
+	void BasicBlock::splice(Instruction *position, BasicBlock &from, Instruction &first, Instruction *last) {
+		assert(from.parent == parent);
+		assert(first.parent == &from && (!last || last->parent == &from));
+		assert(!position || position->parent == this);
+
+		for (Instruction *instruction = &first; instruction != last; instruction = instruction->getNext())
+			instruction->parent = this;
 
-		auto weak_self = weak_from_this();
-		other.in.erase(weak_self);
-		other.out.erase(weak_self);
+		instructions.splice(position, from.instructions, first, last);
 	}
 }
@@ -0,0 +1,217 @@
+#include "mead/node/FunctionCall.h"
+#include "mead/util/Casting.h"
+#include "mead/util/ThreadPool.h"
+#include "mead/ASTNode.h"
+#include "mead/CallGraph.h"
+#include "mead/Namespace.h"
+#include "mead/OverloadSet.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+namespace mead {
+	CallGraph::CallGraph(std::vector<FunctionPtr> functions, const Namespace &ns) {
+		nodes.reserve(functions.size());
+
+		for (FunctionPtr &function : functions) {
+			assert(function->getDefinition());
+			indices.emplace(function.get(), nodes.size());
+			nodes.emplace_back().function = std::move(function);
+		}
+
+		for (Node &node : nodes)
+			findCalls(node, ns);
+
+		findComponents();
+	}
+
+	const CallGraph::Node * CallGraph::find(const Function &function) const {
+		auto iter = indices.find(&function);
+		return iter == indices.end()? nullptr : &nodes[iter->second];
+	}
+
+	void CallGraph::findCalls(Node &node, const Namespace &ns) {
+		std::unordered_set<const Function *> seen;
+		std::vector<const ASTNode *> stack{node.function->getDefinition()->at(1).get()};
+
+		while (!stack.empty()) {
+			const ASTNode *current = stack.back();
+			stack.pop_back();
+
+			if (auto call = dyn_cast<FunctionCall>(current)) {
+				std::shared_ptr<const OverloadSet> overloads = call->getOverloads(ns);
+
+				if (!overloads) {
+					node.hasUnresolvedCalls = true;
+				} else {
+					// Overloads are resolved while bodies are compiled, so until then the call could be to any of them.
+					for (const FunctionPtr &callee : overloads->getFunctions()) {
+						if (!seen.insert(callee.get()).second)
+							continue;
+						if (auto iter = indices.find(callee.get()); iter != indices.end())
+							node.callees.push_back(iter->second);
+						else
+							node.externalCallees.push_back(callee);
+					}
+				}
+
+				// The callee's name isn't a use of anything.
+				stack.push_back(call->getArgs().get());
+				continue;
+			}
+
+			for (const ASTNodePtr &child : *current)
+				stack.push_back(child.get());
+		}
+	}
+
+	void CallGraph::findComponents() {
+		constexpr size_t unvisited = std::numeric_limits<size_t>::max();
+
+		struct Frame {
+			size_t node;
+			size_t nextCallee = 0;
+		};
+
+		std::vector<size_t> order(nodes.size(), unvisited);
+		std::vector<size_t> lowLink(nodes.size());
+		std::vector<bool> isOnStack(nodes.size());
+		std::vector<size_t> stack;
+		std::vector<Frame> frames;
+		size_t next_order = 0;
+
+		for (size_t root = 0; root < nodes.size(); ++root) {
+			if (order[root] != unvisited)
+				continue;
+
+			frames.push_back({root});
+
+			while (!frames.empty()) {
+				Frame &frame = frames.back();
+				const size_t index = frame.node;
+
+				if (frame.nextCallee == 0 && order[index] == unvisited) {
+					order[index] = lowLink[index] = next_order++;
+					stack.push_back(index);
+					isOnStack[index] = true;
+				}
+
+				const std::vector<size_t> &callees = nodes[index].callees;
+
+				if (frame.nextCallee < callees.size()) {
+					const size_t callee = callees[frame.nextCallee++];
+					if (order[callee] == unvisited)
+						frames.push_back({callee});
+					else if (isOnStack[callee])
+						lowLink[index] = std::min(lowLink[index], order[callee]);
+					continue;
+				}
+
+				frames.pop_back();
+				if (!frames.empty())
+					lowLink[frames.back().node] = std::min(lowLink[frames.back().node], lowLink[index]);
+
+				if (lowLink[index] != order[index])
+					continue;
+
+				// A component is completed only after every component reachable from it, so they come out callees first.
+				Component &component = components.emplace_back();
+				component.index = components.size() - 1;
+
+				size_t member;
+				do {
+					member = stack.back();
+					stack.pop_back();
+					isOnStack[member] = false;
+					nodes[member].component = component.index;
+					component.members.push_back(member);
+				} while (member != index);
+
+				std::ranges::reverse(component.members);
+			}
+		}
+
+		for (Component &component : components) {
+			for (const size_t member : component.members) {
+				for (const size_t callee : nodes[member].callees) {
+					const size_t callee_component = nodes[callee].component;
+					if (callee_component == component.index)
+						component.isRecursive = true;
+					else if (std::ranges::find(component.callees, callee_component) == component.callees.end())
+						component.callees.push_back(callee_component);
+				}
+			}
+
+			std::ranges::sort(component.callees);
+		}
+	}
+
+	void CallGraph::forEachBottomUp(ThreadPool &pool, const std::function<void(const Component &)> &function) const {
+		if (pool.size() == 0) {
+			for (const Component &component : components)
+				function(component);
+			return;
+		}
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		// How many callees of each component haven't finished yet.
+		std::vector<size_t> waiting(components.size());
+		std::vector<std::vector<size_t>> callers(components.size());
+		size_t running = 0;
+		size_t finished = 0;
+		std::exception_ptr error;
+
+		for (const Component &component : components) {
+			waiting[component.index] = component.callees.size();
+			for (const size_t callee : component.callees)
+				callers[callee].push_back(component.index);
+		}
+
+		// Called with the mutex held.
+		std::function<void(size_t)> start = [&](size_t index) {
+			++running;
+			pool.submit([&, index] {
+				std::exception_ptr thrown;
+
+				try {
+					function(components[index]);
+				} catch (...) {
+					thrown = std::current_exception();
+				}
+
+				std::lock_guard lock(mutex);
+				--running;
+				++finished;
+
+				if (thrown && !error)
+					error = std::move(thrown);
+
+				if (!error)
+					for (const size_t caller : callers[index])
+						if (--waiting[caller] == 0)
+							start(caller);
+
+				// Notifying under the lock keeps the condition alive until this is done with it.
+				condition.notify_all();
+			});
+		};
+
+		std::unique_lock lock(mutex);
+
+		for (const Component &component : components)
+			if (component.callees.empty())
+				start(component.index);
+
+		condition.wait(lock, [&] { return running == 0 && (error || finished == components.size()); });
+
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
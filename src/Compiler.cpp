@@ -1,144 +1,532 @@
-#include "mead/error/TypeError.h"
 #include "mead/node/Block.h"
 #include "mead/node/Expression.h"
 #include "mead/node/Identifier.h"
 #include "mead/node/TypeNode.h"
+#include "mead/util/Casting.h"
+#include "mead/CallGraph.h"
 #include "mead/Compiler.h"
+#include "mead/ConstantFolder.h"
+#include "mead/Diagnostics.h"
 #include "mead/Function.h"
+#include "mead/FunctionEmitter.h"
+#include "mead/GVN.h"
+#include "mead/Interpreter.h"
 #include "mead/Logging.h"
 #include "mead/Namespace.h"
+#include "mead/OverloadSet.h"
+#include "mead/Purity.h"
+#include "mead/SCCP.h"
 #include "mead/Scope.h"
+#include "mead/TypeChecker.h"
+#include "mead/TypeContext.h"
 
 #include <cassert>
+#include <future>
+#include <optional>
 #include <sstream>
+#include <unordered_map>
+
+namespace {
+	/** The constructor's definition followed by its registration. */
+	std::string renderConstructor(const mead::Function &constructor) {
+		return constructor.getLLVMDefinition("internal ") + "\n@llvm.global_ctors = appending global [1 x { i32, ptr, ptr }] [{ i32, ptr, ptr } { i32 65535, ptr @__mead_init, ptr null }]";
+	}
+}
 
 namespace mead {
-	Compiler::Compiler(): program(std::make_shared<Program>()) {
+	Compiler::Compiler(size_t thread_count):
+	program(std::make_shared<Program>()), pool(thread_count) {
 		program->init();
+		interpreter = std::make_unique<Interpreter>(*program->getGlobalScope());
+		passes.add<SCCP>(&globals);
+		passes.add<GVN>();
+		// Forwarding stored values to loads can leave operations whose operands are all constants.
+		passes.add<SCCP>(&globals);
 	}
 
 	CompilerResult Compiler::compile(std::span<const ASTNodePtr> nodes) {
+		DiagnosticEngine &diagnostics = program->getDiagnostics();
+		diagnostics.clear();
+
+		std::vector<ASTNodePtr> reachable;
+		unparsedBodies.clear();
+		if (!roots.empty()) {
+			reachable = findReachable(nodes);
+			nodes = reachable;
+		}
+
+		const size_t first_initializer = runtimeInitializers.size();
+		std::vector<std::string> sections;
+		// The section each pending body goes in. A definition's section stays empty until the body pass fills it in.
+		std::vector<size_t> body_sections;
+
+		for (const ASTNodePtr &node : nodes) {
+			CompilerResult result = visit(*node);
+
+			if (!result)
+				return result;
+
+			while (body_sections.size() < pendingBodies.size())
+				body_sections.push_back(sections.size());
+
+			sections.push_back(std::move(result.value()));
+		}
+
+		// Bodies are compiled knowing what their callees may do.
+		mead::inferPurity(CallGraph(pendingBodies, *program->getGlobalNamespace()), pool);
+
+		// Each task returns its result and its diagnostics.
+		auto capture = [](auto &&emit) {
+			std::stringstream diagnostics;
+			LogRedirect redirect(diagnostics);
+			auto result = emit();
+			return std::pair{std::move(result), diagnostics.str()};
+		};
+
+		std::vector<std::future<std::pair<bool, std::string>>> bodies;
+		bodies.reserve(pendingBodies.size());
+
+		for (const FunctionPtr &function : pendingBodies)
+			bodies.push_back(pool.submit([this, capture, function] { return capture([&] { return emitBody(*function); }); }));
+
+		auto initializers = std::span<const RuntimeInitializer>(runtimeInitializers).subspan(first_initializer);
+		std::future<std::pair<FunctionPtr, std::string>> constructor = pool.submit([this, capture, initializers] {
+			return capture([&] { return emitRuntimeInitializers(initializers); });
+		});
+
+		std::vector<FunctionPtr> functions = std::move(pendingBodies);
+		pendingBodies.clear();
+
+		// Every task has to finish before an exception from one of them can leave this function.
+		for (const auto &body : bodies)
+			body.wait();
+		constructor.wait();
+
+		for (auto &body : bodies)
+			*logStream << body.get().second;
+
+		auto [constructor_function, constructor_diagnostics] = constructor.get();
+		*logStream << constructor_diagnostics;
+
+		// Everything was analyzed even if something failed, so this is every problem in the input.
+		diagnostics.print();
+		if (const size_t errors = diagnostics.getErrorCount())
+			return std::unexpected(CompilerError{std::format("{} error{}", errors, errors == 1? "" : "s"), nullptr});
+
+		// Without errors, every body was emitted.
+		if (constructor_function)
+			functions.push_back(constructor_function);
+		passes.run(functions, pool);
+		if (constructor_function)
+			functions.pop_back();
+
+		std::vector<std::future<std::string>> rendered;
+		rendered.reserve(functions.size());
+		for (const FunctionPtr &function : functions)
+			rendered.push_back(pool.submit([function] { return function->getLLVMDefinition(); }));
+
+		for (const auto &body : rendered)
+			body.wait();
+
+		for (size_t i = 0; i < rendered.size(); ++i)
+			sections[body_sections[i]] = rendered[i].get();
+
 		std::stringstream out;
 
+		for (const std::string &section : sections)
+			if (!section.empty())
+				out << section << '\n';
+
+		out << globals.stringsToLLVM();
+
+		for (const FunctionPtr &function : externalFunctions)
+			if (globals.isUsed(*function))
+				out << function->getLLVMDeclaration() << '\n';
+
+		if (constructor_function)
+			out << renderConstructor(*constructor_function) << '\n';
+
+		return out.str();
+	}
+
+	ModulePiece Compiler::compileGlobals(std::span<const ASTNodePtr> nodes) {
+		program->getDiagnostics().clear();
+
+		const size_t first_initializer = runtimeInitializers.size();
+		ModulePiece piece;
+
+		for (const ASTNodePtr &node : nodes)
+			piece.sections.push_back(visit(*node).value_or(std::string{}));
+
+		pendingBodies.clear();
+
+		if (FunctionPtr constructor = emitRuntimeInitializers(std::span<const RuntimeInitializer>(runtimeInitializers).subspan(first_initializer))) {
+			passes.run(std::span(&constructor, 1), pool);
+			piece.constructor = renderConstructor(*constructor);
+		}
+
+		finishPiece(piece);
+		piece.constants = globals.getConstants();
+		return piece;
+	}
+
+	std::vector<Purity> Compiler::inferPurity(std::span<const ASTNodePtr> nodes) {
+		program->getDiagnostics().clear();
+
+		for (const ASTNodePtr &node : nodes)
+			if (node->type == NodeType::FunctionDeclaration || node->type == NodeType::FunctionDefinition)
+				visit(*node);
+
+		mead::inferPurity(CallGraph(pendingBodies, *program->getGlobalNamespace()), pool);
+
+		std::unordered_map<const ASTNode *, Purity> by_definition;
+		for (const FunctionPtr &function : pendingBodies)
+			by_definition.emplace(function->getDefinition().get(), function->getPurity());
+
+		std::vector<Purity> out;
 		for (const ASTNodePtr &node : nodes) {
-			CompilerResult result;
+			auto iter = by_definition.find(node.get());
+			out.push_back(iter == by_definition.end()? Purity::Impure : iter->second);
+		}
+
+		pendingBodies.clear();
+		return out;
+	}
+
+	std::optional<std::string> Compiler::getMangledName(const ASTNode &node) {
+		assert(node.type == NodeType::FunctionDeclaration || node.type == NodeType::FunctionDefinition);
 
-			switch (node->type) {
+		const ASTNode &prototype = *node.front();
+		NamespacePtr ns = program->getGlobalNamespace();
+		std::vector<TypePtr> argument_types;
+
+		for (size_t i = 2; i < prototype.size(); ++i) {
+			TypePtr type = cast<TypeNode>(prototype.at(i)->at(1))->getType(ns);
+			if (!type)
+				return std::nullopt;
+			argument_types.push_back(std::move(type));
+		}
+
+		const std::string &name = cast<Identifier>(prototype.front())->getIdentifier();
+		return Function(program, name, program->getTypeContext().getVoid(), std::move(argument_types)).getMangledName();
+	}
+
+	ModulePiece Compiler::compileFunction(std::span<const ASTNodePtr> declarations, const ASTNodePtr &definition, Purity purity, const std::map<std::string, LLVMValuePtr> &constants) {
+		program->getDiagnostics().clear();
+
+		// The declarations' own sections belong to other pieces.
+		for (const ASTNodePtr &node : declarations)
+			visit(*node);
+
+		// Declarations leave out initializers, so the constants compile() would know about are given instead.
+		for (const auto &[name, value] : constants)
+			globals.setConstant(name, value);
+
+		assert(definition->type == NodeType::FunctionDefinition);
+		pendingBodies.clear();
+		visit(*definition);
+
+		ModulePiece piece;
+		piece.sections.emplace_back();
+		for (const FunctionPtr &function : pendingBodies) {
+			function->setPurity(purity);
+			if (emitBody(*function)) {
+				passes.run(std::span(&function, 1), pool);
+				piece.sections.back() = function->getLLVMDefinition();
+			} else {
+				piece.sections.back() = function->getLLVMDeclaration();
+			}
+		}
+
+		pendingBodies.clear();
+		finishPiece(piece);
+		return piece;
+	}
+
+	void Compiler::finishPiece(ModulePiece &piece) {
+		piece.strings = globals.stringsToLLVM();
+
+		for (const FunctionPtr &function : externalFunctions)
+			if (globals.isUsed(*function))
+				piece.externalDeclarations.emplace(function->getSymbolName(), function->getLLVMDeclaration());
+
+		piece.diagnostics = program->getDiagnostics().getDiagnostics();
+	}
+
+	void Compiler::setRoots(std::vector<std::string> new_roots, BodyLoader loader) {
+		roots = std::move(new_roots);
+		bodyLoader = std::move(loader);
+	}
+
+	std::vector<ASTNodePtr> Compiler::findReachable(std::span<const ASTNodePtr> nodes) {
+		DiagnosticEngine &diagnostics = program->getDiagnostics();
+
+		auto get_defined_name = [](const ASTNode &node) -> const std::string * {
+			const ASTNode *identifier_parent = nullptr;
+
+			switch (node.type) {
 				case NodeType::VariableDeclaration:
-				case NodeType::VariableDefinition:
-					result = compileGlobalVariable(node);
+					identifier_parent = &node;
 					break;
+				case NodeType::VariableDefinition:
 				case NodeType::FunctionDeclaration:
 				case NodeType::FunctionDefinition:
-					result = compileFunction(node);
+					identifier_parent = node.front().get();
 					break;
 				default:
-					// throw std::runtime_error("Unhandled node: " + std::string(nodeTypes.at(node->type)));
-					// node->debug();
-					;
+					return nullptr;
 			}
 
-			if (!result)
-				return result;
+			auto identifier = dyn_cast<Identifier>(identifier_parent->front());
+			assert(identifier);
+			return &identifier->getIdentifier();
+		};
 
-			out << result.value() << '\n';
+		// A name can belong to several nodes, e.g. a function's overloads.
+		std::unordered_map<std::string, std::vector<size_t>> definitions;
+		std::vector<bool> reached(nodes.size());
+
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			if (const std::string *name = get_defined_name(*nodes[i]))
+				definitions[*name].push_back(i);
+			else
+				reached[i] = true;
 		}
 
-		return out.str();
+		std::vector<size_t> worklist;
+
+		auto reach = [&](const std::string &name) {
+			auto iter = definitions.find(name);
+			if (iter == definitions.end())
+				return false;
+
+			for (size_t index : iter->second) {
+				if (!reached[index]) {
+					reached[index] = true;
+					worklist.push_back(index);
+				}
+			}
+
+			return true;
+		};
+
+		// Roots come from the command line rather than the source, so there's no location to give.
+		for (const std::string &root : roots)
+			if (!reach(root))
+				diagnostics.report({Severity::Warning, {}, std::format("Root {} isn't defined", root)});
+
+		std::vector<const ASTNode *> stack;
+
+		while (!worklist.empty()) {
+			const size_t index = worklist.back();
+			worklist.pop_back();
+			ASTNode &node = *nodes[index];
+
+			if (node.type == NodeType::FunctionDefinition && bodyLoader) {
+				if (std::optional<Token> failure = bodyLoader(node)) {
+					diagnostics.report({Severity::Error, failure->location, std::format("Failed to parse the body of {}", *get_defined_name(node))});
+					// The function stays in, so that its callers still find it.
+					unparsedBodies.insert(&node);
+					continue;
+				}
+			}
+
+			// Locals that share a name with a global make this overestimate, which only costs compile time.
+			stack.push_back(&node);
+			while (!stack.empty()) {
+				const ASTNode *current = stack.back();
+				stack.pop_back();
+
+				if (auto identifier = dyn_cast<Identifier>(current))
+					reach(identifier->getIdentifier());
+
+				for (const ASTNodePtr &child : *current)
+					stack.push_back(child.get());
+			}
+		}
+
+		std::vector<ASTNodePtr> out;
+
+		for (size_t i = 0; i < nodes.size(); ++i)
+			if (reached[i])
+				out.push_back(nodes[i]);
+
+		return out;
 	}
 
-	CompilerResult Compiler::compileGlobalVariable(const ASTNodePtr &node) {
-		const bool is_declaration = node->type == NodeType::VariableDeclaration;
-		const bool is_definition  = node->type == NodeType::VariableDefinition;
+	CompilerResult Compiler::compileGlobalVariable(const ASTNode &node) {
+		const bool is_declaration = node.type == NodeType::VariableDeclaration;
+		const bool is_definition  = node.type == NodeType::VariableDefinition;
 
 		// node->debug(INFO("Global variable:\n"), 4) << '\n';
 
 		assert(is_declaration || is_definition);
 
-		ASTNodePtr declaration_node = is_declaration? node : node->front();
-		auto declaration_id = std::dynamic_pointer_cast<Identifier>(declaration_node->front());
+		const ASTNode &declaration_node = is_declaration? node : *node.front();
+		auto declaration_id = dyn_cast<Identifier>(declaration_node.front());
 		assert(declaration_id);
 
 
 		auto scope = program->getGlobalScope();
 		auto ns = program->getGlobalNamespace();
-
-		if (is_definition) {
-			// INFO("Expr type: {}\n", getType(*scope, node->at(1)));
-		}
+		DiagnosticEngine &diagnostics = program->getDiagnostics();
+		// The declaration pass runs on one thread, so any new errors came from this global.
+		const size_t previous_errors = diagnostics.getErrorCount();
 
 		const std::string &identifier = declaration_id->getIdentifier();
 
-		auto type_node = std::dynamic_pointer_cast<TypeNode>(declaration_node->at(1));
+		auto type_node = dyn_cast<TypeNode>(declaration_node.at(1));
 		assert(type_node);
 
 		TypePtr stated_type = type_node->getType(ns);
+		if (!stated_type) {
+			diagnostics.error(*type_node, std::format("Unknown type {}", std::string(type_node->getName())));
+			return {};
+		}
+
+		auto int_type = dyn_cast<IntType>(stated_type);
+		std::optional<IntConstant> value;
+		bool is_valid = true;
 
 		if (is_definition) {
-			TypePtr expr_type = getType(*scope, node->at(1));
-			if (expr_type && !expr_type->isConvertibleTo(*stated_type)) {
-				throw TypeError(std::move(expr_type), std::move(stated_type));
-			}
+			TypeChecker(*scope).check(node);
+			is_valid = diagnostics.getErrorCount() == previous_errors;
+			if (int_type && is_valid)
+				if ((value = interpreter->evaluate(*node.at(1))))
+					value = value->convert(int_type);
 		}
 
 		VariablePtr new_variable = std::make_shared<Variable>(identifier, stated_type);
-		bool inserted = scope->insertVariable(identifier, new_variable);
-		assert(inserted);
+		if (!scope->insertVariable(identifier, new_variable)) {
+			diagnostics.error(*declaration_id, std::format("Redefinition of {}", identifier));
+			return {};
+		}
+
+		// Globals with initializers evaluable at compile time are emitted as static data and don't need to be initialized
+		// at runtime.
+		if (value) {
+			if (stated_type->getConst()) {
+				interpreter->setGlobalValue(*new_variable, *value);
+				globals.setConstant(identifier, value->toLLVM());
+			}
+			return std::format("@{} = {} {}", identifier, stated_type->getConst()? "constant" : "global", *value->toLLVM());
+		}
+
+		// An initializer with errors is left out, which leaves the global zeroed. Compilation fails anyway, but the
+		// global stays declared so that uses of it don't produce errors of their own.
+		if (is_definition && is_valid)
+			runtimeInitializers.push_back({new_variable, node.at(1)});
+
+		// Anything else starts out zeroed. Definitions get their values when the module's constructor runs.
+		if (int_type)
+			return std::format("@{} = global {}", identifier, *IntConstant(0, int_type).toLLVM());
+
+		if (isa<PointerType>(stated_type) || isa<LReferenceType>(stated_type))
+			return std::format("@{} = global ptr null", identifier);
 
 		return std::format("[\x1b[2mglobal.\x1b[22m {}]", new_variable);
 	}
 
-	CompilerResult Compiler::compileFunction(const ASTNodePtr &node) {
-		const bool is_declaration = node->type == NodeType::FunctionDeclaration;
-		const bool is_definition  = node->type == NodeType::FunctionDefinition;
+	CompilerResult Compiler::declareFunction(const ASTNode &node) {
+		const bool is_declaration = node.type == NodeType::FunctionDeclaration;
+		const bool is_definition  = node.type == NodeType::FunctionDefinition;
 
 		// node->debug(INFO("Function:\n"), 4) << '\n';
 
 		assert(is_declaration || is_definition);
 
-		ASTNodePtr prototype = node->front();
+		ASTNodePtr prototype = node.front();
 
-		auto identifier = std::dynamic_pointer_cast<Identifier>(prototype->front());
+		auto identifier = dyn_cast<Identifier>(prototype->front());
 		assert(identifier);
 
-		auto return_type_node = std::dynamic_pointer_cast<TypeNode>(prototype->at(1));
+		auto return_type_node = dyn_cast<TypeNode>(prototype->at(1));
 		assert(return_type_node);
 
 		NamespacePtr ns = program->getGlobalNamespace();
-		TypePtr return_type = return_type_node->getType(ns);
+		DiagnosticEngine &diagnostics = program->getDiagnostics();
+		bool is_valid = true;
+
+		auto resolve = [&](const TypeNode &type_node) {
+			TypePtr type = type_node.getType(ns);
+			if (!type) {
+				diagnostics.error(type_node, std::format("Unknown type {}", std::string(type_node.getName())));
+				is_valid = false;
+			}
+			return type;
+		};
+
+		TypePtr return_type = resolve(*return_type_node);
 		std::vector<TypePtr> argument_types;
 
 		for (size_t i = 2; i < prototype->size(); ++i) {
-			auto argument_type_node = std::dynamic_pointer_cast<TypeNode>(prototype->at(i)->at(1));
+			auto argument_type_node = dyn_cast<TypeNode>(prototype->at(i)->at(1));
 			assert(argument_type_node);
-			argument_types.push_back(argument_type_node->getType(ns));
+			argument_types.push_back(resolve(*argument_type_node));
 		}
 
+		if (!is_valid)
+			return {};
+
 		std::string name = identifier->getIdentifier();
 		auto function = std::make_shared<Function>(program, name, std::move(return_type), std::move(argument_types));
-		bool inserted = ns->insertFunction(name, function);
-		assert(inserted);
+		if (!ns->insertFunction(name, function)) {
+			diagnostics.error(*identifier, std::format("Redefinition of function {}", name));
+			return {};
+		}
 
-		if (is_definition) {
-			auto block = std::dynamic_pointer_cast<Block>(node->at(1));
-			assert(block);
-			if (!block->compile(*this, *function, *function->getScope(), function->addBlock())) {
-				ERROR("Failed to compile function {}", name);
-			}
+		// Overloads need distinct names in the module. A function that isn't overloaded keeps its own, so that it can
+		// be linked against by name. Bodies are emitted after every declaration is in, so none uses a stale name.
+		if (std::shared_ptr<const OverloadSet> overloads = ns->getOverloads(name); overloads->size() > 1)
+			for (const FunctionPtr &overload : overloads->getFunctions())
+				overload->setSymbolName(overload->getMangledName());
+
+		// A definition's section is filled in by the body pass. Declarations are only emitted if something calls them.
+		if (is_definition && !unparsedBodies.contains(&node)) {
+			assert(isa<Block>(node.at(1).get()));
+			function->setDefinition(node.shared_from_this());
+			pendingBodies.push_back(function);
+		} else {
+			externalFunctions.push_back(function);
 		}
 
-		return std::format("[\x1b[2mfunction.\x1b[22m {}]", function);
+		return {};
 	}
 
-	TypePtr Compiler::getType(Scope &scope, const ASTNodePtr &node) {
-		auto expression = std::dynamic_pointer_cast<Expression>(node);
+	bool Compiler::emitBody(Function &function) {
+		auto block = cast<Block>(function.getDefinition()->at(1));
+		ConstantFolder(*function.getScope()).fold(*block);
+		ScopeGuard guard(*function.getScope());
+
+		// Every error in the body is reported here, and a body with errors isn't emitted.
+		if (!TypeChecker(*function.getScope()).checkFunction(function))
+			return false;
+
+		FunctionEmitter emitter(function, globals);
+		if (emitter.emit())
+			return true;
+
+		Diagnostic failure = *emitter.getFailure();
+		failure.message = std::format("In function {}: {}", function.getName(), failure.message);
+		program->getDiagnostics().report(std::move(failure));
+		return false;
+	}
+
+	FunctionPtr Compiler::emitRuntimeInitializers(std::span<const RuntimeInitializer> initializers) {
+		if (initializers.empty())
+			return nullptr;
+
+		auto constructor = std::make_shared<Function>(program, "__mead_init", program->getTypeContext().getVoid(), std::vector<TypePtr>{});
+		ScopeGuard guard(*constructor->getScope());
 
-		if (!expression) {
-			ERROR("Not an expression:\n");
-			node->debug(std::cerr, 4) << '\n';
-			assert(expression);
+		FunctionEmitter emitter(*constructor, globals);
+		if (!emitter.emitInitializers(initializers)) {
+			Diagnostic failure = *emitter.getFailure();
+			failure.message = "In a global initializer: " + failure.message;
+			program->getDiagnostics().report(std::move(failure));
+			return nullptr;
 		}
 
-		return expression->getType(scope);
+		return constructor;
 	}
 }
@@ -0,0 +1,270 @@
+#include "mead/ConstantFolder.h"
+#include "mead/Namespace.h"
+#include "mead/Program.h"
+#include "mead/Scope.h"
+#include "mead/Type.h"
+#include "mead/TypeContext.h"
+
+#include <cassert>
+#include <vector>
+
+namespace {
+	uint64_t mask(int bit_width) {
+		return 64 <= bit_width? ~uint64_t{} : (uint64_t{1} << bit_width) - 1;
+	}
+}
+
+namespace mead {
+	IntConstant::IntConstant(uint64_t bits, std::shared_ptr<IntType> type):
+	bits(bits & mask(type->getBitWidth())), type(std::move(type)) {
+		assert(this->type);
+	}
+
+	int64_t IntConstant::getSigned() const {
+		const int shift = 64 - type->getBitWidth();
+		return static_cast<int64_t>(bits << shift) >> shift;
+	}
+
+	IntConstant IntConstant::convert(std::shared_ptr<IntType> new_type) const {
+		return {type->getSigned()? static_cast<uint64_t>(getSigned()) : bits, std::move(new_type)};
+	}
+
+	bool IntConstant::fits(const IntType &target) const {
+		const bool is_negative = type->getSigned() && getSigned() < 0;
+		return intFits(is_negative? static_cast<uint64_t>(getSigned()) : bits, is_negative, target.getId());
+	}
+
+	std::string IntConstant::toString() const {
+		return type->getSigned()? std::to_string(getSigned()) : std::to_string(bits);
+	}
+
+	LLVMValuePtr IntConstant::toLLVM() const {
+		return std::make_shared<LLVMIntValue>(bits, type->getBitWidth());
+	}
+
+	std::optional<IntConstant> IntConstant::applyBinary(TokenType operation, const IntConstant &lhs, const IntConstant &rhs) {
+		// The result type follows the same rule as the type checker.
+		const IntTypeId common = intCommonTypes[lhs.type->getId()][rhs.type->getId()];
+		if (common == noIntType)
+			return std::nullopt;
+		// Whichever operand has the common type lends it to the result, so the result keeps that operand's constness.
+		const std::shared_ptr<IntType> &type = common == lhs.type->getId()? lhs.type : rhs.type;
+
+		const IntConstant a = lhs.convert(type);
+		const IntConstant b = rhs.convert(type);
+		const int bit_width = type->getBitWidth();
+		const bool is_signed = type->getSigned();
+
+		auto make = [&](uint64_t bits) {
+			return IntConstant(bits, type);
+		};
+
+		auto compare = [&](auto &&comparator) {
+			return make(is_signed? comparator(a.getSigned(), b.getSigned()) : comparator(a.getUnsigned(), b.getUnsigned()));
+		};
+
+		switch (operation) {
+			using enum TokenType;
+
+			case Plus:  return make(a.getUnsigned() + b.getUnsigned());
+			case Minus: return make(a.getUnsigned() - b.getUnsigned());
+			case Star:  return make(a.getUnsigned() * b.getUnsigned());
+
+			case Slash:
+			case Percent: {
+				if (!b.isTrue())
+					return std::nullopt;
+
+				const bool is_division = operation == Slash;
+
+				if (!is_signed)
+					return make(is_division? a.getUnsigned() / b.getUnsigned() : a.getUnsigned() % b.getUnsigned());
+
+				if (a.getSigned() == intMinimums[type->getId()] && b.getSigned() == -1)
+					return std::nullopt;
+
+				return make(is_division? a.getSigned() / b.getSigned() : a.getSigned() % b.getSigned());
+			}
+
+			case LeftShift:
+			case RightShift: {
+				const uint64_t amount = b.getUnsigned();
+				if (is_signed && b.getSigned() < 0)
+					return std::nullopt;
+				if (static_cast<uint64_t>(bit_width) <= amount)
+					return std::nullopt;
+
+				if (operation == LeftShift)
+					return make(a.getUnsigned() << amount);
+
+				return make(is_signed? a.getSigned() >> amount : a.getUnsigned() >> amount);
+			}
+
+			case Ampersand: return make(a.getUnsigned() & b.getUnsigned());
+			case Pipe:      return make(a.getUnsigned() | b.getUnsigned());
+			case Xor:       return make(a.getUnsigned() ^ b.getUnsigned());
+
+			case DoubleEquals: return make(a.getUnsigned() == b.getUnsigned());
+			case NotEqual:     return make(a.getUnsigned() != b.getUnsigned());
+			case OpeningAngle: return compare([](auto x, auto y) { return x < y; });
+			case Leq:          return compare([](auto x, auto y) { return x <= y; });
+			case ClosingAngle: return compare([](auto x, auto y) { return x > y; });
+			case Geq:          return compare([](auto x, auto y) { return x >= y; });
+
+			case Spaceship:
+				return compare([](auto x, auto y) { return static_cast<uint64_t>(x < y? -1 : y < x? 1 : 0); });
+
+			case DoubleAmpersand: return make(a.isTrue() && b.isTrue());
+			case DoublePipe:      return make(a.isTrue() || b.isTrue());
+
+			default:
+				return std::nullopt;
+		}
+	}
+
+	std::optional<IntConstant> IntConstant::applyUnary(NodeType operation, const IntConstant &value) {
+		switch (operation) {
+			case NodeType::UnaryPlus:  return value;
+			case NodeType::UnaryMinus: return IntConstant(-value.bits, value.type);
+			case NodeType::LogicalNot: return IntConstant(!value.isTrue(), value.type);
+			case NodeType::BitwiseNot: return IntConstant(~value.bits, value.type);
+			default:
+				return std::nullopt;
+		}
+	}
+
+	ConstantFolder::ConstantFolder(const Scope &scope):
+		scope(scope), context(scope.getProgram()->getTypeContext()) {}
+
+	std::optional<IntConstant> ConstantFolder::evaluate(const ASTNode &node) {
+		if (auto iter = cache.find(&node); iter != cache.end())
+			return iter->second;
+
+		std::optional<IntConstant> result = visit(node);
+		cache.emplace(&node, result);
+		return result;
+	}
+
+	size_t ConstantFolder::fold(ASTNode &root) {
+		size_t replaced = 0;
+		// Keeps replaced subtrees alive until the walk is done so that no cached address gets reused.
+		std::vector<ASTNodePtr> detached;
+		std::vector<ASTNode *> stack;
+
+		for (const ASTNodePtr &child : root)
+			stack.push_back(child.get());
+
+		while (!stack.empty()) {
+			ASTNode *node = stack.back();
+			stack.pop_back();
+
+			if (node->type != NodeType::Number) {
+				if (std::optional<IntConstant> value = evaluate(*node)) {
+					auto number = std::make_shared<Number>(Token(TokenType::IntegerLiteral, value->toString(), node->location()), value->getType());
+					detached.push_back(node->shared_from_this());
+					node->replaceWith(number);
+					++replaced;
+					continue;
+				}
+			}
+
+			for (const ASTNodePtr &child : *node)
+				stack.push_back(child.get());
+		}
+
+		cache.clear();
+		return replaced;
+	}
+
+	std::optional<IntConstant> ConstantFolder::evaluateBlock(const ASTNode &block) {
+		// A block has a value if it's a single expression statement.
+		if (block.type != NodeType::Block || block.size() != 1)
+			return std::nullopt;
+
+		const ASTNode &statement = *block.front();
+		if (statement.type != NodeType::ExpressionStatement || statement.size() != 1)
+			return std::nullopt;
+
+		return evaluate(*statement.front());
+	}
+
+	std::optional<IntConstant> ConstantFolder::evaluateConversion(const ASTNode &type_node, const ASTNode &subexpr) {
+		const auto *type = dyn_cast<TypeNode>(&type_node);
+		if (!type)
+			return std::nullopt;
+
+		std::optional<IntConstant> value = evaluate(subexpr);
+		if (!value)
+			return std::nullopt;
+
+		auto int_type = dyn_cast_if_present<IntType>(type->getType(scope.getProgram()->getGlobalNamespace()));
+		if (!int_type)
+			return std::nullopt;
+
+		return value->convert(std::move(int_type));
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitNumber(const Number &node) {
+		// Literals that are too large are left for the emitter to report.
+		std::optional<uint64_t> value = node.getValue();
+		if (!value)
+			return std::nullopt;
+		return IntConstant(*value, node.getIntType(context));
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitBinary(const Binary &node) {
+		std::optional<IntConstant> lhs = evaluate(*node.at(0));
+		if (!lhs)
+			return std::nullopt;
+
+		std::optional<IntConstant> rhs = evaluate(*node.at(1));
+		if (!rhs)
+			return std::nullopt;
+
+		return IntConstant::applyBinary(node.token.type, *lhs, *rhs);
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitUnaryPlus(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitUnaryMinus(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitLogicalNot(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitBitwiseNot(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitUnary(const ASTNode &node) {
+		if (std::optional<IntConstant> value = evaluate(*node.front()))
+			return IntConstant::applyUnary(node.type, *value);
+		return std::nullopt;
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitCast(const ASTNode &node) {
+		return evaluateConversion(*node.at(0), *node.at(1));
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitConstructorCall(const ASTNode &node) {
+		const ASTNode &args = *node.at(1);
+		if (args.size() != 1)
+			return std::nullopt;
+		return evaluateConversion(*node.at(0), *args.front());
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitConditionalExpression(const ASTNode &node) {
+		std::optional<IntConstant> condition = evaluate(*node.at(0));
+		if (!condition)
+			return std::nullopt;
+		return evaluateBlock(*node.at(condition->isTrue()? 1 : 2));
+	}
+
+	std::optional<IntConstant> ConstantFolder::visitNode(const ASTNode &) {
+		return std::nullopt;
+	}
+}
@@ -0,0 +1,57 @@
+#include "mead/ASTNode.h"
+#include "mead/Diagnostics.h"
+#include "mead/Logging.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace mead {
+	void DiagnosticEngine::report(Diagnostic diagnostic) {
+		std::lock_guard lock(mutex);
+		if (diagnostic.severity == Severity::Error)
+			++errorCount;
+		diagnostics.push_back(std::move(diagnostic));
+	}
+
+	void DiagnosticEngine::error(const ASTNode &node, std::string message) {
+		report({Severity::Error, node.location(), std::move(message)});
+	}
+
+	void DiagnosticEngine::warn(const ASTNode &node, std::string message) {
+		report({Severity::Warning, node.location(), std::move(message)});
+	}
+
+	size_t DiagnosticEngine::getErrorCount() const {
+		std::lock_guard lock(mutex);
+		return errorCount;
+	}
+
+	std::vector<Diagnostic> DiagnosticEngine::getDiagnostics() const {
+		std::vector<Diagnostic> out;
+		{
+			std::lock_guard lock(mutex);
+			out = diagnostics;
+		}
+
+		std::ranges::sort(out, [](const Diagnostic &a, const Diagnostic &b) {
+			return std::tie(a.location.line, a.location.column, a.message, a.severity) < std::tie(b.location.line, b.location.column, b.message, b.severity);
+		});
+
+		return out;
+	}
+
+	void DiagnosticEngine::print() const {
+		for (const Diagnostic &diagnostic : getDiagnostics()) {
+			if (diagnostic.severity == Severity::Error)
+				ERROR("{} {}", diagnostic.location, diagnostic.message);
+			else
+				WARN("{} {}", diagnostic.location, diagnostic.message);
+		}
+	}
+
+	void DiagnosticEngine::clear() {
+		std::lock_guard lock(mutex);
+		diagnostics.clear();
+		errorCount = 0;
+	}
+}
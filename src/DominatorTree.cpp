@@ -0,0 +1,189 @@
+#include "mead/BasicBlock.h"
+#include "mead/DominatorTree.h"
+#include "mead/Function.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace mead {
+	DominatorTree::DominatorTree(const Function &function, bool is_post):
+	isPost(is_post) {
+		computeOrder(function);
+		computeDominators();
+		computeTree();
+	}
+
+	void DominatorTree::computeOrder(const Function &function) {
+		indices.assign(function.getBlockIdCount(), none);
+
+		const auto &blocks = function.getBlocks();
+		if (blocks.empty())
+			return;
+
+		auto next = [this](const BasicBlock &block) -> const std::vector<BasicBlock *> & {
+			return isPost? block.getPredecessors() : block.getSuccessors();
+		};
+
+		std::vector<BasicBlock *> roots;
+		if (isPost) {
+			for (const auto &block : blocks)
+				if (block->getSuccessors().empty())
+					roots.push_back(block.get());
+		} else {
+			roots.push_back(blocks.front().get());
+		}
+
+		std::vector<bool> visited(indices.size());
+		std::vector<std::pair<BasicBlock *, size_t>> stack;
+
+		// Post-order, so the reverse is a topological order of everything but back edges.
+		for (BasicBlock *root : roots) {
+			visited[root->getId()] = true;
+			stack.push_back({root, 0});
+
+			while (!stack.empty()) {
+				auto &[block, next_edge] = stack.back();
+				const std::vector<BasicBlock *> &edges = next(*block);
+
+				if (next_edge < edges.size()) {
+					BasicBlock *target = edges[next_edge++];
+					if (!visited[target->getId()]) {
+						visited[target->getId()] = true;
+						stack.push_back({target, 0});
+					}
+					continue;
+				}
+
+				order.push_back(block);
+				stack.pop_back();
+			}
+		}
+
+		std::ranges::reverse(order);
+		for (size_t i = 0; i < order.size(); ++i)
+			indices[order[i]->getId()] = i;
+	}
+
+	void DominatorTree::computeDominators() {
+		// Backwards, the root is a virtual exit that every block ending the function leads to, numbered before them all.
+		const size_t offset = isPost? 1 : 0;
+		std::vector<size_t> dominators(order.size() + offset, none);
+		immediateDominators.assign(order.size(), none);
+		if (dominators.empty())
+			return;
+		dominators[0] = 0;
+
+		auto intersect = [&dominators](size_t lhs, size_t rhs) {
+			while (lhs != rhs) {
+				while (lhs > rhs)
+					lhs = dominators[lhs];
+				while (rhs > lhs)
+					rhs = dominators[rhs];
+			}
+			return lhs;
+		};
+
+		for (bool changed = true; changed;) {
+			changed = false;
+
+			for (size_t i = 1 - offset; i < order.size(); ++i) {
+				const BasicBlock &block = *order[i];
+				const std::vector<BasicBlock *> &sources = isPost? block.getSuccessors() : block.getPredecessors();
+				size_t dominator = sources.empty()? 0 : none;
+
+				for (const BasicBlock *source : sources) {
+					const size_t index = indices[source->getId()];
+					if (index == none || dominators[index + offset] == none)
+						continue;
+					dominator = dominator == none? index + offset : intersect(index + offset, dominator);
+				}
+
+				if (dominator != dominators[i + offset]) {
+					dominators[i + offset] = dominator;
+					changed = true;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < order.size(); ++i)
+			if (i + offset != 0 && dominators[i + offset] >= offset)
+				immediateDominators[i] = dominators[i + offset] - offset;
+	}
+
+	void DominatorTree::computeTree() {
+		children.assign(order.size(), {});
+		preorder.assign(order.size(), 0);
+		subtreeEnd.assign(order.size(), 0);
+
+		// Children come out in reverse post-order because parents are visited in it.
+		for (size_t i = 0; i < order.size(); ++i)
+			if (immediateDominators[i] != none)
+				children[immediateDominators[i]].push_back(order[i]);
+
+		size_t next_number = 0;
+		std::vector<std::pair<size_t, size_t>> stack;
+
+		for (size_t i = 0; i < order.size(); ++i) {
+			if (immediateDominators[i] != none)
+				continue;
+
+			preorder[i] = next_number++;
+			stack.push_back({i, 0});
+
+			while (!stack.empty()) {
+				auto &[index, next_child] = stack.back();
+
+				if (next_child < children[index].size()) {
+					const size_t child = indices[children[index][next_child++]->getId()];
+					preorder[child] = next_number++;
+					stack.push_back({child, 0});
+					continue;
+				}
+
+				subtreeEnd[index] = next_number;
+				stack.pop_back();
+			}
+		}
+	}
+
+	size_t DominatorTree::indexOf(const BasicBlock &block) const {
+		return block.getId() < indices.size()? indices[block.getId()] : none;
+	}
+
+	bool DominatorTree::contains(const BasicBlock &block) const {
+		return indexOf(block) != none;
+	}
+
+	BasicBlock * DominatorTree::getImmediateDominator(const BasicBlock &block) const {
+		const size_t index = indexOf(block);
+		if (index == none || immediateDominators[index] == none)
+			return nullptr;
+		return order[immediateDominators[index]];
+	}
+
+	bool DominatorTree::dominates(const BasicBlock &dominator, const BasicBlock &block) const {
+		const size_t dominator_index = indexOf(dominator), index = indexOf(block);
+		if (dominator_index == none || index == none)
+			return false;
+		return preorder[dominator_index] <= preorder[index] && preorder[index] < subtreeEnd[dominator_index];
+	}
+
+	bool DominatorTree::strictlyDominates(const BasicBlock &dominator, const BasicBlock &block) const {
+		return &dominator != &block && dominates(dominator, block);
+	}
+
+	const std::vector<BasicBlock *> & DominatorTree::getChildren(const BasicBlock &block) const {
+		static const std::vector<BasicBlock *> empty;
+		const size_t index = indexOf(block);
+		return index == none? empty : children[index];
+	}
+
+	std::vector<BasicBlock *> DominatorTree::getRoots() const {
+		std::vector<BasicBlock *> out;
+		for (size_t i = 0; i < order.size(); ++i)
+			if (immediateDominators[i] == none)
+				out.push_back(order[i]);
+		return out;
+	}
+}
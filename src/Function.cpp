@@ -1,24 +1,105 @@
 #include "mead/BasicBlock.h"
 #include "mead/Function.h"
+#include "mead/LLVMValue.h"
 #include "mead/Logging.h"
 #include "mead/Program.h"
 #include "mead/Scope.h"
+#include "mead/SymbolTable.h"
 #include "mead/Type.h"
 #include "mead/Util.h"
 
+#include <cassert>
+
 namespace mead {
 	Function::Function(const std::shared_ptr<Program> &program, std::string name, std::shared_ptr<Type> return_type, std::vector<std::shared_ptr<Type>> argument_types):
-	Symbol(std::move(name)), weakProgram(program), returnType(std::move(return_type)), argumentTypes(std::move(argument_types)), scope(std::make_shared<Scope>(program->getGlobalScope())) {
-		initBlocks();
+		Symbol(std::move(name)), weakProgram(program), symbolName(this->name), returnType(std::move(return_type)), argumentTypes(std::move(argument_types)), scope(std::make_shared<Scope>(program->getGlobalScope(), std::make_shared<SymbolTable>())) {}
+
+	std::shared_ptr<BasicBlock> Function::addBlock(std::string label) {
+		invalidateControlFlow();
+		return blocks.emplace_back(std::make_shared<BasicBlock>(*this, std::move(label)));
+	}
+
+	void Function::appendBlock(std::shared_ptr<BasicBlock> block) {
+		assert(block->getParent() == this);
+		invalidateControlFlow();
+		blocks.push_back(std::move(block));
+	}
+
+	void Function::removeBlock(BasicBlock &block) {
+		assert(block.getParent() == this);
+		assert(blocks.empty() || blocks.front().get() != &block);
+
+		// Copied, since disconnecting changes the lists.
+		for (BasicBlock *predecessor : std::vector(block.getPredecessors()))
+			predecessor->disconnect(block);
+		for (BasicBlock *successor : std::vector(block.getSuccessors()))
+			block.disconnect(*successor);
+
+		std::erase_if(blocks, [&](const std::shared_ptr<BasicBlock> &other) { return other.get() == &block; });
+		invalidateControlFlow();
+	}
+
+	void Function::invalidateControlFlow() {
+		dominatorTree.reset();
+		postDominatorTree.reset();
+	}
+
+	const std::vector<BasicBlock *> & Function::getReversePostOrder() {
+		return getDominatorTree().getOrder();
 	}
 
-	void Function::initBlocks() {
-		entryBlock = std::make_shared<BasicBlock>(*this);
-		exitBlock = std::make_shared<BasicBlock>(*this);
+	const DominatorTree & Function::getDominatorTree() {
+		if (!dominatorTree)
+			dominatorTree = std::make_unique<DominatorTree>(*this);
+		return *dominatorTree;
 	}
 
-	std::shared_ptr<BasicBlock> Function::addBlock() {
-		return blocks.emplace_back(std::make_shared<BasicBlock>(*this));
+	const DominatorTree & Function::getPostDominatorTree() {
+		if (!postDominatorTree)
+			postDominatorTree = std::make_unique<DominatorTree>(*this, true);
+		return *postDominatorTree;
+	}
+
+	std::string Function::getLLVMDeclaration() const {
+		std::vector<LLVMTypePtr> llvm_argument_types;
+		llvm_argument_types.reserve(argumentTypes.size());
+		for (const TypePtr &argument_type : argumentTypes)
+			llvm_argument_types.push_back(argument_type->toLLVM());
+		return std::format("declare {} @{}({})", returnType->toLLVM(), symbolName, join(llvm_argument_types));
+	}
+
+	std::string Function::getLLVMDefinition(std::string_view linkage) const {
+		std::string_view attributes;
+		switch (purity) {
+			case Purity::Pure:     attributes = " readnone"; break;
+			case Purity::ReadOnly: attributes = " readonly"; break;
+			case Purity::Impure:   break;
+		}
+
+		std::string out = std::format("define {}{} @{}({}){} {{\n", linkage, returnType->toLLVM(), symbolName, join(parameters), attributes);
+
+		bool first = true;
+		for (const auto &block : blocks) {
+			if (!first)
+				out += '\n';
+			first = false;
+			out += block->toString();
+		}
+
+		return out + "}";
+	}
+
+	std::string Function::getMangledName() const {
+		std::string out = std::format("_Z{}{}", name.size(), name);
+
+		if (argumentTypes.empty())
+			return out + 'v';
+
+		// As in C++, top-level qualifiers on parameters aren't part of the signature.
+		for (const TypePtr &argument_type : argumentTypes)
+			out += argument_type->getNonConstVariant().getMangledName();
+
+		return out;
 	}
 
 	std::format_context::iterator Function::formatTo(std::format_context &ctx) const {
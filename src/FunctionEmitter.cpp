@@ -0,0 +1,973 @@
+#include "mead/BasicBlock.h"
+#include "mead/Compiler.h"
+#include "mead/ConstantFolder.h"
+#include "mead/Function.h"
+#include "mead/FunctionEmitter.h"
+#include "mead/GlobalPool.h"
+#include "mead/LLVMInstruction.h"
+#include "mead/LLVMTypeContext.h"
+#include "mead/Namespace.h"
+#include "mead/OverloadSet.h"
+#include "mead/Program.h"
+#include "mead/Scope.h"
+#include "mead/Type.h"
+#include "mead/TypeChecker.h"
+#include "mead/TypeContext.h"
+#include "mead/Util.h"
+#include "mead/Variable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+
+namespace {
+	mead::LLVMTypePtr getPointerType() {
+		return mead::LLVMTypeContext::get().getPointer();
+	}
+
+	/** Decodes the escape sequences the lexer accepts in a string literal token, quotes included. */
+	std::string unescape(std::string_view literal) {
+		assert(2 <= literal.size());
+		literal = literal.substr(1, literal.size() - 2);
+
+		std::string out;
+		out.reserve(literal.size());
+
+		for (size_t i = 0; i < literal.size(); ++i) {
+			if (literal[i] != '\\' || i + 1 == literal.size()) {
+				out += literal[i];
+				continue;
+			}
+
+			switch (const char escaped = literal[++i]) {
+				case '0': out += '\0';   break;
+				case 'a': out += '\a';   break;
+				case 'b': out += '\b';   break;
+				case 'e': out += '\x1b'; break;
+				case 'f': out += '\f';   break;
+				case 'n': out += '\n';   break;
+				case 'r': out += '\r';   break;
+				case 't': out += '\t';   break;
+				default:  out += escaped;
+			}
+		}
+
+		return out;
+	}
+}
+
+namespace mead {
+	template <typename T, typename... Args>
+	T * FunctionEmitter::add(Args &&...args) {
+		return getInsertionBlock().add<T>(std::forward<Args>(args)...);
+	}
+
+	FunctionEmitter::FunctionEmitter(Function &function, GlobalPool &globals):
+		function(function), globals(globals), context(function.getScope()->getProgram()->getTypeContext()), scope(function.getScope()) {}
+
+	bool FunctionEmitter::emit() {
+		const auto &definition = function.getDefinition();
+		assert(definition);
+		assert(scope->getOpen());
+
+		findAddressTaken(*definition->at(1));
+		begin();
+
+		// Parameters follow the name and return type in the prototype. Each is a local like any other, initialized with
+		// the argument.
+		const ASTNode &prototype = *definition->front();
+		const auto &argument_types = function.getArgumentTypes();
+
+		for (size_t i = 0; i < argument_types.size(); ++i) {
+			const ASTNode &parameter = *prototype.at(i + 2);
+			const auto *identifier = dyn_cast<Identifier>(parameter.front().get());
+			assert(identifier);
+
+			auto value = std::make_shared<LLVMLocalValue>(identifier->getIdentifier(), argument_types[i]->toLLVM());
+			if (!declareLocal(parameter, identifier->getIdentifier(), argument_types[i], value))
+				return false;
+
+			parameters.push_back(std::move(value));
+		}
+
+		if (!emitStatement(*definition->at(1)))
+			return false;
+
+		// Falling off the end of a function that returns a value is undefined.
+		if (!current->isTerminated()) {
+			if (isa<VoidType>(function.getReturnType()))
+				add<LLVMRet>();
+			else
+				add<LLVMUnreachable>();
+		}
+
+		finish();
+		return true;
+	}
+
+	bool FunctionEmitter::emitInitializers(std::span<const RuntimeInitializer> initializers) {
+		assert(scope->getOpen());
+
+		for (const RuntimeInitializer &initializer : initializers)
+			findAddressTaken(*initializer.initializer);
+
+		begin();
+
+		for (const RuntimeInitializer &initializer : initializers) {
+			const Variable &variable = *initializer.variable;
+			std::optional<Operand> value = emitInitializer(*initializer.initializer, variable.getType());
+			if (!value)
+				return false;
+			add<LLVMStore>(value->first, std::make_shared<LLVMGlobalValue>(variable.getName(), getPointerType()));
+		}
+
+		add<LLVMRet>();
+		finish();
+		return true;
+	}
+
+	void FunctionEmitter::begin() {
+		entry = addBlock("entry");
+		moveTo(entry);
+		body = addBlock("body");
+		// The branch is only added once the entry block's allocas are, but the body has to be sealed with its edge.
+		entry->connectTo(*body);
+		moveTo(body);
+	}
+
+	void FunctionEmitter::findAddressTaken(const ASTNode &root) {
+		const Namespace &ns = *scope->getProgram()->getGlobalNamespace();
+		const bool returns_reference = isa<LReferenceType>(function.getReturnType());
+		std::vector<const ASTNode *> stack{&root};
+
+		auto take = [this](const ASTNode &node) {
+			if (const auto *identifier = dyn_cast<Identifier>(&node))
+				addressTaken.insert(identifier->getIdentifier());
+		};
+
+		while (!stack.empty()) {
+			const ASTNode &node = *stack.back();
+			stack.pop_back();
+
+			switch (node.type) {
+				case NodeType::GetAddress:
+					take(*node.front());
+					break;
+
+				case NodeType::VariableDefinition: {
+					const ASTNode &type_node = *node.at(0)->at(1);
+					if (std::ranges::any_of(type_node, [](const ASTNodePtr &child) { return child->type == NodeType::LReference; }))
+						take(*node.at(1));
+					break;
+				}
+
+				case NodeType::ReturnStatement:
+					if (returns_reference)
+						take(*node.front());
+					break;
+
+				case NodeType::FunctionCall: {
+					auto call = cast<FunctionCall>(&node);
+					const ASTNode &args = *call->getArgs();
+					if (std::shared_ptr<const OverloadSet> overloads = call->getOverloads(ns))
+						for (const FunctionPtr &overload : overloads->getFunctions())
+							for (size_t i = 0; i < args.size() && i < overload->getArgumentTypes().size(); ++i)
+								if (isa<LReferenceType>(overload->getArgumentTypes()[i]))
+									take(*args.at(i));
+					break;
+				}
+
+				default:
+					break;
+			}
+
+			for (const ASTNodePtr &child : node)
+				stack.push_back(child.get());
+		}
+	}
+
+	void FunctionEmitter::finish() {
+		entry->add<LLVMBr>(body);
+		ssa.finish(function);
+		function.setParameters(std::move(parameters));
+	}
+
+	std::nullopt_t FunctionEmitter::fail(const ASTNode &node, std::string_view reason) {
+		if (!failure)
+			failure = Diagnostic{Severity::Error, node.location(), std::string(reason)};
+		return std::nullopt;
+	}
+
+	std::shared_ptr<BasicBlock> FunctionEmitter::addBlock(std::string_view hint) {
+		// The hint stands in for the label until the block is placed.
+		return std::make_shared<BasicBlock>(function, std::string(hint));
+	}
+
+	void FunctionEmitter::moveTo(std::shared_ptr<BasicBlock> block) {
+		// Labels are numbered in placement order so that they read in order in the output.
+		block->setLabel(std::format("{}.{}", block->getLabel(), nextLabel++));
+		function.appendBlock(block);
+		ssa.seal(*block);
+		current = std::move(block);
+	}
+
+	BasicBlock & FunctionEmitter::getInsertionBlock() {
+		// Code after a return is unreachable but still has to go somewhere.
+		if (current->isTerminated())
+			moveTo(addBlock("dead"));
+		return *current;
+	}
+
+	std::shared_ptr<BasicBlock> FunctionEmitter::branch(const std::shared_ptr<BasicBlock> &destination) {
+		BasicBlock &block = getInsertionBlock();
+		block.add<LLVMBr>(destination);
+		block.connectTo(*destination);
+		return block.shared_from_this();
+	}
+
+	void FunctionEmitter::branch(const LLVMValuePtr &condition, const std::shared_ptr<BasicBlock> &if_true, const std::shared_ptr<BasicBlock> &if_false) {
+		BasicBlock &block = getInsertionBlock();
+		block.add<LLVMCondBr>(condition, if_true, if_false);
+		block.connectTo(*if_true);
+		block.connectTo(*if_false);
+	}
+
+	LLVMValuePtr FunctionEmitter::temporary(LLVMTypePtr type) {
+		return std::make_shared<LLVMLocalValue>(std::format("t.{}", nextTemporary++), std::move(type));
+	}
+
+	bool FunctionEmitter::declareLocal(const ASTNode &node, const std::string &name, std::shared_ptr<Type> type, LLVMValuePtr initial) {
+		if (!isa<IntType>(type) && !isa<PointerType>(type) && !isa<LReferenceType>(type)) {
+			fail(node, std::format("Can't declare a local of type {} yet", type));
+			return false;
+		}
+
+		auto variable = std::make_shared<Variable>(name, type);
+		if (!scope->insertVariable(name, variable)) {
+			fail(node, std::format("Redefinition of {}", name));
+			return false;
+		}
+
+		// A reference is never itself the target of an address, since binding to it binds to what it refers to.
+		if (!addressTaken.contains(name) || isa<LReferenceType>(type)) {
+			promoted.insert(variable.get());
+			ssa.write(*variable, getInsertionBlock(), initial? std::move(initial) : std::make_shared<LLVMUndefValue>(type->toLLVM()));
+			return true;
+		}
+
+		size_t &uses = slotNames[name];
+		auto slot = std::make_shared<LLVMLocalValue>(uses == 0? name + ".addr" : std::format("{}.addr.{}", name, uses), getPointerType());
+		++uses;
+
+		entry->add<LLVMAlloca>(type->toLLVM(), slot);
+		slots.emplace(variable.get(), slot);
+		if (initial)
+			add<LLVMStore>(std::move(initial), slot);
+		return true;
+	}
+
+	LLVMValuePtr FunctionEmitter::load(const LLVMValuePtr &pointer, const Type &type) {
+		LLVMValuePtr out = temporary(type.toLLVM());
+		add<LLVMLoad>(pointer, out);
+		return out;
+	}
+
+	std::optional<FunctionEmitter::Place> FunctionEmitter::emitPlace(const ASTNode &node) {
+		if (const auto *identifier = dyn_cast<Identifier>(&node)) {
+			VariablePtr variable = scope->getVariable(identifier->getIdentifier());
+			if (!variable)
+				return fail(node, std::format("Unknown variable {}", identifier->getIdentifier()));
+
+			Place place{nullptr, nullptr, variable->getType()};
+			if (promoted.contains(variable.get()))
+				place.variable = variable.get();
+			else if (auto iter = slots.find(variable.get()); iter != slots.end())
+				place.address = iter->second;
+			else
+				place.address = std::make_shared<LLVMGlobalValue>(variable->getName(), getPointerType());
+
+			// A reference's storage holds the address of what it refers to.
+			if (auto reference = dyn_cast<LReferenceType>(variable->getType()))
+				return Place{read(place), nullptr, reference->getSubtype()};
+
+			return place;
+		}
+
+		if (const auto *dereference = dyn_cast<Dereference>(&node)) {
+			std::optional<Operand> pointer = emitExpression(*dereference->front());
+			if (!pointer)
+				return std::nullopt;
+
+			auto pointer_type = dyn_cast_if_present<PointerType>(pointer->second);
+			if (!pointer_type)
+				return fail(node, "Dereferenced expression isn't a pointer");
+
+			return Place{pointer->first, nullptr, pointer_type->getSubtype()};
+		}
+
+		return fail(node, std::format("Can't take the address of {}", getNodeTypeName(node.type)));
+	}
+
+	LLVMValuePtr FunctionEmitter::read(const Place &place) {
+		if (place.variable)
+			return ssa.read(*place.variable, getInsertionBlock());
+		return load(place.address, *place.type);
+	}
+
+	void FunctionEmitter::write(const Place &place, LLVMValuePtr value) {
+		if (place.variable)
+			ssa.write(*place.variable, getInsertionBlock(), std::move(value));
+		else
+			add<LLVMStore>(std::move(value), place.address);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitAddress(const ASTNode &node) {
+		std::optional<Place> place = emitPlace(node);
+		if (!place)
+			return std::nullopt;
+
+		// findAddressTaken should have given it a stack slot.
+		if (place->variable)
+			return fail(node, std::format("Can't take the address of {}, which isn't in memory", place->variable->getName()));
+
+		return Operand{std::move(place->address), std::move(place->type)};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitExpression(const ASTNode &node) {
+		return visit(node);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitBlock(const ASTNode &block) {
+		ScopePtr outer = scope;
+		scope = outer->addScope();
+		ScopeGuard guard(*scope);
+
+		std::optional<Operand> result = Operand{nullptr, context.getVoid()};
+
+		for (const ASTNodePtr &statement : block) {
+			if (statement == block.back() && statement->type == NodeType::ExpressionStatement)
+				result = emitExpression(*statement->front());
+			else if (!emitStatement(*statement))
+				result = std::nullopt;
+
+			if (!result)
+				break;
+		}
+
+		scope = std::move(outer);
+		return result;
+	}
+
+	bool FunctionEmitter::emitStatement(const ASTNode &statement) {
+		switch (statement.type) {
+			case NodeType::Block:
+				return emitBlock(statement).has_value();
+
+			case NodeType::VariableDeclaration:
+				return emitDeclaration(statement, nullptr);
+
+			case NodeType::VariableDefinition:
+				return emitDeclaration(*statement.at(0), statement.at(1).get());
+
+			case NodeType::ExpressionStatement:
+				return emitExpression(*statement.front()).has_value();
+
+			case NodeType::ReturnStatement: {
+				const auto &return_type = function.getReturnType();
+
+				if (isa<VoidType>(return_type)) {
+					if (!emitExpression(*statement.front()))
+						return false;
+					add<LLVMRet>();
+					return true;
+				}
+
+				std::optional<Operand> value = emitInitializer(*statement.front(), return_type);
+				if (!value)
+					return false;
+				add<LLVMRet>(value->first);
+				return true;
+			}
+
+			case NodeType::IfStatement: {
+				std::optional<Operand> condition = emitExpression(*statement.at(0));
+				if (!condition)
+					return false;
+
+				std::optional<LLVMValuePtr> truth = emitTruth(*statement.at(0), *condition);
+				if (!truth)
+					return false;
+
+				const bool has_else = statement.size() == 3;
+				auto then_block = addBlock("then");
+				auto else_block = has_else? addBlock("else") : nullptr;
+				auto end_block = addBlock("end");
+
+				branch(*truth, then_block, has_else? else_block : end_block);
+
+				moveTo(then_block);
+				if (!emitStatement(*statement.at(1)))
+					return false;
+				if (!current->isTerminated())
+					branch(end_block);
+
+				if (has_else) {
+					moveTo(else_block);
+					if (!emitStatement(*statement.at(2)))
+						return false;
+					if (!current->isTerminated())
+						branch(end_block);
+				}
+
+				moveTo(end_block);
+				return true;
+			}
+
+			case NodeType::EmptyStatement:
+				return true;
+
+			default:
+				fail(statement, std::format("Can't emit {} statements yet", getNodeTypeName(statement.type)));
+				return false;
+		}
+	}
+
+	bool FunctionEmitter::emitDeclaration(const ASTNode &declaration, const ASTNode *initializer) {
+		const auto *identifier = dyn_cast<Identifier>(declaration.at(0).get());
+		assert(identifier);
+
+		std::shared_ptr<Type> type = getType(*declaration.at(1));
+		if (!type) {
+			fail(declaration, "Unknown type");
+			return false;
+		}
+
+		if (isa<LReferenceType>(type) && !initializer) {
+			fail(declaration, std::format("Reference {} has no initializer", identifier->getIdentifier()));
+			return false;
+		}
+
+		// The initializer is emitted before the local is declared, so a name in it that the local shadows refers to the
+		// outer variable.
+		std::optional<Operand> value;
+		if (initializer && !(value = emitInitializer(*initializer, type)))
+			return false;
+
+		return declareLocal(declaration, identifier->getIdentifier(), type, value? value->first : nullptr);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitInitializer(const ASTNode &expression, const std::shared_ptr<Type> &target) {
+		if (auto reference = dyn_cast<LReferenceType>(target)) {
+			std::optional<Operand> address = emitAddress(expression);
+			if (!address)
+				return std::nullopt;
+
+			const auto &subtype = reference->getSubtype();
+			if (!address->second->isExactlyEquivalent(*subtype, true) || (address->second->getConst() && !subtype->getConst()))
+				return fail(expression, std::format("Can't bind {} to {}", address->second, target));
+
+			return Operand{address->first, target};
+		}
+
+		std::optional<Operand> value = emitExpression(expression);
+		if (!value)
+			return std::nullopt;
+
+		if (auto int_type = dyn_cast<IntType>(target)) {
+			if (!isa<IntType>(value->second))
+				return fail(expression, std::format("Can't convert {} to {}", value->second, target));
+			return convert(*value, int_type);
+		}
+
+		if (isa<PointerType>(target)) {
+			if (!value->second->isConvertibleTo(*target))
+				return fail(expression, std::format("Can't convert {} to {}", value->second, target));
+			return Operand{value->first, target};
+		}
+
+		return fail(expression, std::format("Can't initialize a {} yet", target));
+	}
+
+	FunctionEmitter::Operand FunctionEmitter::convert(const Operand &operand, const std::shared_ptr<IntType> &target) {
+		auto source = cast<IntType>(operand.second);
+
+		if (const auto *constant = dyn_cast<LLVMIntValue>(operand.first.get()))
+			return {IntConstant(constant->getValue(), source).convert(target).toLLVM(), target};
+
+		const int source_width = source->getBitWidth();
+		const int target_width = target->getBitWidth();
+
+		if (source_width == target_width)
+			return {operand.first, target};
+
+		LLVMCastKind kind = LLVMCastKind::Trunc;
+		if (source_width < target_width)
+			kind = source->getSigned()? LLVMCastKind::SExt : LLVMCastKind::ZExt;
+
+		LLVMValuePtr out = temporary(target->toLLVM());
+		add<LLVMCast>(kind, operand.first, out);
+		return {std::move(out), target};
+	}
+
+	std::optional<LLVMValuePtr> FunctionEmitter::emitTruth(const ASTNode &node, const Operand &operand) {
+		LLVMValuePtr zero;
+
+		if (auto int_type = dyn_cast_if_present<IntType>(operand.second)) {
+			if (const auto *constant = dyn_cast<LLVMIntValue>(operand.first.get()))
+				return std::make_shared<LLVMIntValue>(constant->getValue() != 0, 1);
+			zero = std::make_shared<LLVMIntValue>(0, int_type->getBitWidth());
+		} else if (isa_and_present<PointerType>(operand.second)) {
+			zero = std::make_shared<LLVMNullValue>();
+		} else {
+			return fail(node, "Condition isn't an integer or a pointer");
+		}
+
+		return emitCompare(LLVMPredicate::Ne, operand.first, zero);
+	}
+
+	LLVMValuePtr FunctionEmitter::emitCompare(LLVMPredicate predicate, const LLVMValuePtr &lhs, const LLVMValuePtr &rhs) {
+		LLVMValuePtr out = temporary(LLVMTypeContext::get().getInt(1));
+		add<LLVMIcmp>(predicate, lhs, rhs, out);
+		return out;
+	}
+
+	FunctionEmitter::Operand FunctionEmitter::widen(const LLVMValuePtr &truth, const std::shared_ptr<IntType> &type) {
+		LLVMValuePtr out = temporary(type->toLLVM());
+		add<LLVMCast>(LLVMCastKind::ZExt, truth, out);
+		return {std::move(out), type};
+	}
+
+	template <typename I>
+	FunctionEmitter::Operand FunctionEmitter::emitThreeReg(const Operand &lhs, const Operand &rhs) {
+		LLVMValuePtr out = temporary(lhs.first->getType());
+		add<I>(lhs.first, rhs.first, out);
+		return {std::move(out), lhs.second};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitBinary(const ASTNode &node, TokenType operation, Operand lhs, Operand rhs, const ASTNode &lhs_node, const ASTNode &rhs_node, const std::shared_ptr<Type> &operation_type) {
+		auto type = dyn_cast_if_present<IntType>(operation_type);
+		if (!type || !isa<IntType>(lhs.second) || !isa<IntType>(rhs.second))
+			return fail(node, std::format("Can't emit operations on {} and {} yet", lhs.second, rhs.second));
+
+		lhs = convert(lhs, type);
+		rhs = convert(rhs, type);
+
+		const bool is_signed = type->getSigned();
+
+		auto compare = [&](LLVMPredicate signed_predicate, LLVMPredicate unsigned_predicate) {
+			return widen(emitCompare(is_signed? signed_predicate : unsigned_predicate, lhs.first, rhs.first), type);
+		};
+
+		switch (operation) {
+			using enum TokenType;
+
+			case Plus:       return emitThreeReg<LLVMAdd>(lhs, rhs);
+			case Minus:      return emitThreeReg<LLVMSub>(lhs, rhs);
+			case Star:       return emitThreeReg<LLVMMul>(lhs, rhs);
+			case Slash:      return is_signed? emitThreeReg<LLVMSDiv>(lhs, rhs) : emitThreeReg<LLVMUDiv>(lhs, rhs);
+			case Percent:    return is_signed? emitThreeReg<LLVMSRem>(lhs, rhs) : emitThreeReg<LLVMURem>(lhs, rhs);
+			case LeftShift:  return emitThreeReg<LLVMShl>(lhs, rhs);
+			case RightShift: return is_signed? emitThreeReg<LLVMAShr>(lhs, rhs) : emitThreeReg<LLVMLShr>(lhs, rhs);
+			case Ampersand:  return emitThreeReg<LLVMAnd>(lhs, rhs);
+			case Pipe:       return emitThreeReg<LLVMOr>(lhs, rhs);
+			case Xor:        return emitThreeReg<LLVMXor>(lhs, rhs);
+
+			case DoubleEquals: return compare(LLVMPredicate::Eq, LLVMPredicate::Eq);
+			case NotEqual:     return compare(LLVMPredicate::Ne, LLVMPredicate::Ne);
+			case OpeningAngle: return compare(LLVMPredicate::Slt, LLVMPredicate::Ult);
+			case Leq:          return compare(LLVMPredicate::Sle, LLVMPredicate::Ule);
+			case ClosingAngle: return compare(LLVMPredicate::Sgt, LLVMPredicate::Ugt);
+			case Geq:          return compare(LLVMPredicate::Sge, LLVMPredicate::Uge);
+
+			case Spaceship: {
+				// (lhs > rhs) - (lhs < rhs)
+				Operand greater = compare(LLVMPredicate::Sgt, LLVMPredicate::Ugt);
+				Operand less = compare(LLVMPredicate::Slt, LLVMPredicate::Ult);
+				return emitThreeReg<LLVMSub>(greater, less);
+			}
+
+			// Only compound assignments get here; they evaluate both sides.
+			case DoubleAmpersand:
+			case DoublePipe: {
+				std::optional<LLVMValuePtr> lhs_truth = emitTruth(lhs_node, lhs);
+				std::optional<LLVMValuePtr> rhs_truth = emitTruth(rhs_node, rhs);
+				if (!lhs_truth || !rhs_truth)
+					return std::nullopt;
+				Operand lhs_bit{*lhs_truth, nullptr};
+				Operand rhs_bit{*rhs_truth, nullptr};
+				return widen((operation == DoubleAmpersand? emitThreeReg<LLVMAnd>(lhs_bit, rhs_bit) : emitThreeReg<LLVMOr>(lhs_bit, rhs_bit)).first, type);
+			}
+
+			default:
+				return fail(node, std::format("Can't emit operator {}", node.token.value));
+		}
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitShortCircuit(const Binary &node) {
+		const bool is_and = node.token.type == TokenType::DoubleAmpersand;
+
+		std::optional<Operand> lhs = emitExpression(*node.at(0));
+		if (!lhs)
+			return std::nullopt;
+
+		std::optional<LLVMValuePtr> lhs_truth = emitTruth(*node.at(0), *lhs);
+		if (!lhs_truth)
+			return std::nullopt;
+
+		auto rhs_block = addBlock(is_and? "and.rhs" : "or.rhs");
+		auto end_block = addBlock(is_and? "and.end" : "or.end");
+		std::shared_ptr<BasicBlock> lhs_end = current;
+
+		if (is_and)
+			branch(*lhs_truth, rhs_block, end_block);
+		else
+			branch(*lhs_truth, end_block, rhs_block);
+
+		moveTo(rhs_block);
+
+		std::optional<Operand> rhs = emitExpression(*node.at(1));
+		if (!rhs)
+			return std::nullopt;
+
+		std::optional<LLVMValuePtr> rhs_truth = emitTruth(*node.at(1), *rhs);
+		if (!rhs_truth)
+			return std::nullopt;
+
+		auto type = dyn_cast_if_present<IntType>(node.getAnnotatedType());
+		if (!type)
+			return fail(node, std::format("Can't emit operations on {} and {} yet", lhs->second, rhs->second));
+
+		std::shared_ptr<BasicBlock> rhs_end = branch(end_block);
+		moveTo(end_block);
+
+		LLVMValuePtr phi = temporary(LLVMTypeContext::get().getInt(1));
+		add<LLVMPhi>(std::vector<LLVMPhi::Incoming>{{std::make_shared<LLVMIntValue>(!is_and, 1), lhs_end}, {*rhs_truth, rhs_end}}, phi);
+		return widen(phi, type);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitUnary(const ASTNode &node) {
+		std::optional<Operand> operand = emitExpression(*node.front());
+		if (!operand)
+			return std::nullopt;
+
+		auto type = dyn_cast_if_present<IntType>(operand->second);
+		if (!type)
+			return fail(node, std::format("Operand of {} isn't an integer", getNodeTypeName(node.type)));
+
+		const int bit_width = type->getBitWidth();
+
+		switch (node.type) {
+			case NodeType::UnaryPlus:
+				return operand;
+
+			case NodeType::UnaryMinus:
+				return emitThreeReg<LLVMSub>({std::make_shared<LLVMIntValue>(0, bit_width), type}, *operand);
+
+			case NodeType::LogicalNot:
+				return widen(emitCompare(LLVMPredicate::Eq, operand->first, std::make_shared<LLVMIntValue>(0, bit_width)), type);
+
+			case NodeType::BitwiseNot:
+				return emitThreeReg<LLVMXor>(*operand, {std::make_shared<LLVMIntValue>(~uint64_t{}, bit_width), type});
+
+			default:
+				return fail(node, "Unknown unary operator");
+		}
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitStep(const ASTNode &node, bool increment, bool prefix) {
+		std::optional<Place> place = emitPlace(*node.front());
+		if (!place)
+			return std::nullopt;
+
+		auto type = dyn_cast_if_present<IntType>(place->type);
+		if (!type)
+			return fail(node, "Only integers can be incremented or decremented");
+		if (type->getConst())
+			return fail(node, "Can't modify a const");
+
+		Operand old_value{read(*place), type};
+		Operand one{std::make_shared<LLVMIntValue>(1, type->getBitWidth()), type};
+		Operand new_value = increment? emitThreeReg<LLVMAdd>(old_value, one) : emitThreeReg<LLVMSub>(old_value, one);
+		write(*place, new_value.first);
+		return prefix? new_value : old_value;
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::emitConversion(const ASTNode &type_node, const ASTNode &subexpr) {
+		auto int_type = dyn_cast_if_present<IntType>(getType(type_node));
+		if (!int_type)
+			return fail(type_node, "Only conversions to integer types can be emitted");
+
+		std::optional<Operand> value = emitExpression(subexpr);
+		if (!value)
+			return std::nullopt;
+
+		if (!isa_and_present<IntType>(value->second))
+			return fail(subexpr, std::format("Can't convert {} to {}", value->second, int_type));
+
+		return convert(*value, int_type);
+	}
+
+	std::shared_ptr<Type> FunctionEmitter::getType(const ASTNode &type_node) const {
+		const auto *type = dyn_cast<TypeNode>(&type_node);
+		if (!type)
+			return nullptr;
+		return type->getType(scope->getProgram()->getGlobalNamespace());
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitNumber(const Number &node) {
+		std::optional<uint64_t> bits = node.getValue();
+		if (!bits)
+			return fail(node, std::format("Integer literal {} doesn't fit in 64 bits", node.token.value));
+		IntConstant value(*bits, node.getIntType(context));
+		return Operand{value.toLLVM(), value.getType()};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitString(const ASTNode &node) {
+		return Operand{globals.getString(unescape(node.token.value)), context.getPointer(context.getInt(8, false, true))};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitIdentifier(const Identifier &node) {
+		std::optional<Place> place = emitPlace(node);
+		if (!place)
+			return std::nullopt;
+		return Operand{read(*place), place->type};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitBinary(const Binary &node) {
+		const TokenType operation = node.token.type;
+		if (operation == TokenType::DoubleAmpersand || operation == TokenType::DoublePipe)
+			return emitShortCircuit(node);
+
+		std::optional<Operand> lhs = emitExpression(*node.at(0));
+		if (!lhs)
+			return std::nullopt;
+
+		std::optional<Operand> rhs = emitExpression(*node.at(1));
+		if (!rhs)
+			return std::nullopt;
+
+		return emitBinary(node, operation, std::move(*lhs), std::move(*rhs), *node.at(0), *node.at(1), node.getAnnotatedType());
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitUnaryPlus(const ASTNode &node) {
+		return emitUnary(node);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitUnaryMinus(const ASTNode &node) {
+		return emitUnary(node);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitLogicalNot(const ASTNode &node) {
+		return emitUnary(node);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitBitwiseNot(const ASTNode &node) {
+		return emitUnary(node);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitCast(const ASTNode &node) {
+		return emitConversion(*node.at(0), *node.at(1));
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitConstructorCall(const ASTNode &node) {
+		const ASTNode &args = *node.at(1);
+		if (args.size() != 1)
+			return fail(node, "Constructor calls take exactly one argument");
+		return emitConversion(*node.at(0), *args.front());
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitConditionalExpression(const ASTNode &node) {
+		std::optional<Operand> condition = emitExpression(*node.at(0));
+		if (!condition)
+			return std::nullopt;
+
+		std::optional<LLVMValuePtr> truth = emitTruth(*node.at(0), *condition);
+		if (!truth)
+			return std::nullopt;
+
+		auto then_block = addBlock("then");
+		auto else_block = addBlock("else");
+		auto end_block = addBlock("end");
+		branch(*truth, then_block, else_block);
+
+		moveTo(then_block);
+		std::optional<Operand> if_true = emitBlock(*node.at(1));
+		if (!if_true)
+			return std::nullopt;
+		std::shared_ptr<BasicBlock> then_end = current;
+
+		moveTo(else_block);
+		std::optional<Operand> if_false = emitBlock(*node.at(2));
+		if (!if_false)
+			return std::nullopt;
+		std::shared_ptr<BasicBlock> else_end = current;
+
+		if (then_end->isTerminated() || else_end->isTerminated())
+			return fail(node, "Both branches of a conditional expression have to produce a value");
+
+		// The branches are only closed once both are emitted, so that each can convert its value to the common type.
+		const std::shared_ptr<Type> &type = cast<Expression>(node).getAnnotatedType();
+		if (!type)
+			return fail(node, std::format("Can't emit a conditional expression of types {} and {} yet", if_true->second, if_false->second));
+
+		if (isa<VoidType>(type)) {
+			current = then_end;
+			branch(end_block);
+			current = else_end;
+			branch(end_block);
+			moveTo(end_block);
+			return Operand{nullptr, type};
+		}
+
+		current = then_end;
+		if (auto int_type = dyn_cast<IntType>(type))
+			if_true = convert(*if_true, int_type);
+		branch(end_block);
+
+		current = else_end;
+		if (auto int_type = dyn_cast<IntType>(type))
+			if_false = convert(*if_false, int_type);
+		branch(end_block);
+
+		moveTo(end_block);
+		LLVMValuePtr phi = temporary(type->toLLVM());
+		add<LLVMPhi>(std::vector<LLVMPhi::Incoming>{{if_true->first, then_end}, {if_false->first, else_end}}, phi);
+		return Operand{std::move(phi), type};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitAssign(const ASTNode &node) {
+		std::optional<Place> place = emitPlace(*node.at(0));
+		if (!place)
+			return std::nullopt;
+
+		if (place->type->getConst())
+			return fail(node, "Can't assign to a const");
+
+		std::optional<Operand> value = emitInitializer(*node.at(1), place->type);
+		if (!value)
+			return std::nullopt;
+
+		write(*place, value->first);
+		return value;
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitCompoundAssign(const ASTNode &node) {
+		const TokenType operation = getCompoundOperator(node.token.type);
+		if (operation == TokenType::Invalid)
+			return fail(node, std::format("Unknown compound assignment {}", node.token.value));
+
+		std::optional<Place> place = emitPlace(*node.at(0));
+		if (!place)
+			return std::nullopt;
+
+		auto type = dyn_cast_if_present<IntType>(place->type);
+		if (!type)
+			return fail(node, "Compound assignment is only supported for integers");
+		if (type->getConst())
+			return fail(node, "Can't assign to a const");
+
+		Operand lhs{read(*place), type};
+
+		std::optional<Operand> rhs = emitExpression(*node.at(1));
+		if (!rhs)
+			return std::nullopt;
+
+		auto rhs_type = dyn_cast_if_present<IntType>(rhs->second);
+		if (!rhs_type)
+			return fail(node, std::format("Can't emit operations on {} and {} yet", type, rhs->second));
+
+		std::shared_ptr<Type> operation_type = TypeChecker::getOperationType(*node.at(0), type, *node.at(1), rhs_type);
+		std::optional<Operand> value = emitBinary(node, operation, lhs, std::move(*rhs), *node.at(0), *node.at(1), operation_type);
+		if (!value)
+			return std::nullopt;
+
+		Operand converted = convert(*value, type);
+		write(*place, converted.first);
+		return converted;
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitPrefixIncrement(const ASTNode &node) {
+		return emitStep(node, true, true);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitPrefixDecrement(const ASTNode &node) {
+		return emitStep(node, false, true);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitPostfixIncrement(const ASTNode &node) {
+		return emitStep(node, true, false);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitPostfixDecrement(const ASTNode &node) {
+		return emitStep(node, false, false);
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitComma(const ASTNode &node) {
+		if (!emitExpression(*node.at(0)))
+			return std::nullopt;
+		return emitExpression(*node.at(1));
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitFunctionCall(const FunctionCall &node) {
+		const Identifier *callee_name = node.getCalleeName();
+		if (!callee_name)
+			return fail(node, "Only named functions can be called");
+
+		if (!node.getOverloads(*scope->getProgram()->getGlobalNamespace()))
+			return fail(node, std::format("Unknown function {}", callee_name->getIdentifier()));
+
+		OverloadSet::Resolution resolution = node.resolveCallee(*scope);
+		if (!resolution.function) {
+			if (resolution.isAmbiguous)
+				return fail(node, std::format("Call to {} is ambiguous", callee_name->getIdentifier()));
+			return fail(node, std::format("No overload of {} takes these arguments", callee_name->getIdentifier()));
+		}
+
+		FunctionPtr callee = std::move(resolution.function);
+
+		const auto &argument_types = callee->getArgumentTypes();
+		const ASTNode &args = *node.getArgs();
+		if (args.size() != argument_types.size())
+			return fail(node, std::format("{} takes {} arguments, not {}", callee->getName(), argument_types.size(), args.size()));
+
+		std::vector<LLVMValuePtr> arguments;
+		arguments.reserve(args.size());
+
+		for (size_t i = 0; i < args.size(); ++i) {
+			std::optional<Operand> argument = emitInitializer(*args.at(i), argument_types[i]);
+			if (!argument)
+				return std::nullopt;
+			arguments.push_back(std::move(argument->first));
+		}
+
+		globals.useFunction(*callee);
+
+		const auto &return_type = callee->getReturnType();
+		LLVMValuePtr result = isa<VoidType>(return_type)? nullptr : temporary(return_type->toLLVM());
+		add<LLVMCall>(return_type->toLLVM(), callee->getSymbolName(), std::move(arguments), result);
+
+		// A returned reference is read through, like a named one.
+		if (auto reference = dyn_cast<LReferenceType>(return_type))
+			return Operand{load(result, *reference->getSubtype()), reference->getSubtype()};
+
+		return Operand{std::move(result), return_type};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitDeref(const Dereference &node) {
+		std::optional<Place> place = emitPlace(node);
+		if (!place)
+			return std::nullopt;
+		return Operand{read(*place), place->type};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitGetAddress(const GetAddress &node) {
+		std::optional<Operand> address = emitAddress(*node.front());
+		if (!address)
+			return std::nullopt;
+		return Operand{address->first, context.getPointer(address->second)};
+	}
+
+	std::optional<FunctionEmitter::Operand> FunctionEmitter::visitNode(const ASTNode &node) {
+		return fail(node, std::format("Can't emit {} yet", getNodeTypeName(node.type)));
+	}
+}
@@ -0,0 +1,254 @@
+#include "mead/util/Casting.h"
+#include "mead/BasicBlock.h"
+#include "mead/DominatorTree.h"
+#include "mead/Function.h"
+#include "mead/GVN.h"
+#include "mead/LLVMInstruction.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mead {
+	namespace {
+		/** What an operand contributes to an expression's identity. Constants are keyed by their type and value and
+		 *  globals by their name, since the emitter creates a new object for each use of either. */
+		struct OperandKey {
+			const void *identity = nullptr;
+			uint64_t bits = 0;
+
+			bool operator==(const OperandKey &) const = default;
+
+			bool operator<(const OperandKey &other) const {
+				if (identity != other.identity)
+					return std::less<const void *>()(identity, other.identity);
+				return bits < other.bits;
+			}
+		};
+
+		struct Expression {
+			/** The instruction kind combined with its opcode, predicate or cast kind. */
+			uint32_t operation = 0;
+			const LLVMType *type = nullptr;
+			OperandKey operands[2];
+			/** The memory state a load reads, and zero for everything else. */
+			size_t generation = 0;
+
+			bool operator==(const Expression &) const = default;
+		};
+
+		struct ExpressionHash {
+			size_t operator()(const Expression &expression) const {
+				size_t out = expression.operation;
+				auto mix = [&](size_t value) { out ^= value + 0x9e3779b97f4a7c15 + (out << 6) + (out >> 2); };
+				mix(std::hash<const void *>()(expression.type));
+				for (const OperandKey &operand : expression.operands) {
+					mix(std::hash<const void *>()(operand.identity));
+					mix(std::hash<uint64_t>()(operand.bits));
+				}
+				mix(expression.generation);
+				return out;
+			}
+		};
+
+		uint32_t encode(InstructionKind kind, uint32_t detail = 0, uint32_t predicate = 0) {
+			return static_cast<uint32_t>(kind) << 16 | detail << 8 | predicate;
+		}
+
+		bool isCommutative(const LLVMThreeReg &instruction) {
+			switch (instruction.getOpcode()) {
+				case LLVMOpcode::Add:
+				case LLVMOpcode::Mul:
+				case LLVMOpcode::And:
+				case LLVMOpcode::Or:
+				case LLVMOpcode::Xor:
+					return true;
+				case LLVMOpcode::Icmp: {
+					const LLVMPredicate predicate = cast<LLVMIcmp>(&instruction)->getPredicate();
+					return predicate == LLVMPredicate::Eq || predicate == LLVMPredicate::Ne;
+				}
+				default:
+					return false;
+			}
+		}
+
+		class Numbering {
+			private:
+				UseLists &uses;
+				std::unordered_map<Expression, LLVMValuePtr, ExpressionHash> available;
+				/** What each insertion into the table replaced, so that leaving a block's subtree can undo it. */
+				std::vector<std::pair<Expression, LLVMValuePtr>> undoLog;
+				/** Gives every global name one address to stand for it. */
+				std::unordered_map<std::string, char> globalNames;
+				/** The identity of null pointers. */
+				const char nullIdentity = 0;
+				size_t nextGeneration = 1;
+				size_t remaining;
+				bool changed = false;
+
+				OperandKey getKey(const LLVMValuePtr &value) {
+					if (auto int_value = dyn_cast<LLVMIntValue>(value.get())) {
+						const int width = cast<LLVMIntType>(int_value->getType().get())->bitWidth;
+						const uint64_t mask = width >= 64? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+						return {int_value->getType().get(), int_value->getValue() & mask};
+					}
+
+					if (auto global = dyn_cast<LLVMGlobalValue>(value.get()))
+						return {&globalNames.try_emplace(global->getName()).first->first};
+
+					if (isa<LLVMNullValue>(value.get()))
+						return {&nullIdentity};
+
+					return {value.get()};
+				}
+
+				void insert(const Expression &expression, LLVMValuePtr value) {
+					LLVMValuePtr &entry = available[expression];
+					undoLog.emplace_back(expression, entry);
+					entry = std::move(value);
+				}
+
+				/** Replaces the instruction if the table has its expression, or records it otherwise. */
+				void number(LLVMInstruction &instruction, const Expression &expression) {
+					auto iter = available.find(expression);
+					if (iter == available.end()) {
+						insert(expression, instruction.getResult());
+						return;
+					}
+
+					uses.replaceAllUses(*instruction.getResult(), iter->second);
+					uses.forget(instruction);
+					instruction.getParent()->remove(instruction);
+					changed = true;
+				}
+
+				void visit(LLVMInstruction &instruction, size_t &generation) {
+					if (auto three_reg = dyn_cast<LLVMThreeReg>(&instruction)) {
+						uint32_t predicate = 0;
+						if (auto icmp = dyn_cast<LLVMIcmp>(three_reg))
+							predicate = static_cast<uint32_t>(icmp->getPredicate());
+
+						Expression expression{encode(InstructionKind::ThreeReg, static_cast<uint32_t>(three_reg->getOpcode()), predicate), three_reg->getResult()->getType().get(), {getKey(three_reg->getLeft()), getKey(three_reg->getRight())}};
+						if (isCommutative(*three_reg) && expression.operands[1] < expression.operands[0])
+							std::swap(expression.operands[0], expression.operands[1]);
+						number(instruction, expression);
+						return;
+					}
+
+					if (auto cast_instruction = dyn_cast<LLVMCast>(&instruction)) {
+						number(instruction, {encode(InstructionKind::Cast, static_cast<uint32_t>(cast_instruction->getCastKind())), cast_instruction->getResult()->getType().get(), {getKey(cast_instruction->getValue())}});
+						return;
+					}
+
+					if (auto load = dyn_cast<LLVMLoad>(&instruction)) {
+						number(instruction, {encode(InstructionKind::Load), load->getResult()->getType().get(), {getKey(load->getPointer())}, generation});
+						return;
+					}
+
+					if (auto store = dyn_cast<LLVMStore>(&instruction)) {
+						// Nothing says whether other addresses overlap this one, so everything loaded so far is stale.
+						generation = nextGeneration++;
+						insert({encode(InstructionKind::Load), store->getValue()->getType().get(), {getKey(store->getPointer())}, generation}, store->getValue());
+						return;
+					}
+
+					if (isa<LLVMCall>(&instruction))
+						generation = nextGeneration++;
+				}
+
+			public:
+				Numbering(UseLists &uses, size_t budget):
+					uses(uses), remaining(budget) {}
+
+				/** Returns whether anything was replaced. */
+				bool run(const DominatorTree &tree) {
+					struct Frame {
+						BasicBlock *block;
+						/** The undo log's size when the block was entered. */
+						size_t undoSize;
+						/** The memory state at the end of the block. */
+						size_t generation;
+						size_t nextChild = 0;
+					};
+
+					std::vector<Frame> stack;
+
+					// Returns false once the budget runs out.
+					auto enter = [&](BasicBlock &block, size_t generation) {
+						// With a single predecessor, which has to be the immediate dominator, nothing can happen to memory
+						// between the end of that block and the start of this one.
+						if (block.getPredecessors().size() != 1)
+							generation = nextGeneration++;
+
+						const size_t undo_size = undoLog.size();
+						auto &instructions = block.getInstructions();
+
+						for (auto iter = instructions.begin(); iter != instructions.end();) {
+							if (remaining == 0)
+								return false;
+							--remaining;
+
+							auto &instruction = *cast<LLVMInstruction>(iter.get());
+							++iter;
+							visit(instruction, generation);
+						}
+
+						stack.push_back({&block, undo_size, generation});
+						return true;
+					};
+
+					for (BasicBlock *root : tree.getRoots()) {
+						if (!enter(*root, 0))
+							return changed;
+
+						while (!stack.empty()) {
+							Frame &top = stack.back();
+							const auto &children = tree.getChildren(*top.block);
+
+							if (top.nextChild < children.size()) {
+								BasicBlock &child = *children[top.nextChild++];
+								if (!enter(child, top.generation))
+									return changed;
+								continue;
+							}
+
+							while (undoLog.size() > top.undoSize) {
+								auto &[expression, previous] = undoLog.back();
+								if (previous)
+									available[expression] = std::move(previous);
+								else
+									available.erase(expression);
+								undoLog.pop_back();
+							}
+
+							stack.pop_back();
+						}
+					}
+
+					return changed;
+				}
+		};
+	}
+
+	AnalysisSet GVN::run(Function &function, FunctionAnalyses &analyses) const {
+		if (function.getBlocks().empty())
+			return AnalysisSet::all();
+
+		// Only LLVM instructions are numbered.
+		for (const auto &block : function.getBlocks())
+			for (const Instruction &instruction : block->getInstructions())
+				if (!isa<LLVMInstruction>(&instruction))
+					return AnalysisSet::all();
+
+		Numbering numbering(analyses.getUses(), budget);
+		if (!numbering.run(analyses.getDominatorTree()))
+			return AnalysisSet::all();
+
+		// Instructions were only removed from within blocks.
+		return {Analysis::ControlFlow, Analysis::Uses};
+	}
+}
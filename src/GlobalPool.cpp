@@ -0,0 +1,84 @@
+#include "mead/GlobalPool.h"
+#include "mead/LLVMTypeContext.h"
+
+#include <cstdint>
+#include <format>
+
+namespace {
+	uint64_t fnv1a(std::string_view bytes) {
+		uint64_t hash = 0xcbf29ce484222325;
+		for (const char byte : bytes) {
+			hash ^= static_cast<uint8_t>(byte);
+			hash *= 0x100000001b3;
+		}
+		return hash;
+	}
+
+	/** Renders bytes in the form LLVM expects inside c"...". */
+	std::string escape(std::string_view bytes) {
+		std::string out;
+		out.reserve(bytes.size());
+		for (const char byte : bytes) {
+			const auto unsigned_byte = static_cast<uint8_t>(byte);
+			if (unsigned_byte < 0x20 || 0x7f <= unsigned_byte || byte == '"' || byte == '\\')
+				out += std::format("\\{:02X}", unsigned_byte);
+			else
+				out += byte;
+		}
+		return out;
+	}
+}
+
+namespace mead {
+	LLVMValuePtr GlobalPool::getString(std::string_view bytes) {
+		std::string name = std::format(".str.{:016x}", fnv1a(bytes));
+
+		{
+			std::lock_guard lock(mutex);
+			// On a hash collision the name gets a suffix, which is the one case where naming depends on which body asked
+			// first.
+			for (size_t suffix = 1;; ++suffix) {
+				auto [iter, inserted] = strings.try_emplace(name, bytes);
+				if (inserted || iter->second == bytes)
+					break;
+				name = std::format(".str.{:016x}.{}", fnv1a(bytes), suffix);
+			}
+		}
+
+		return std::make_shared<LLVMGlobalValue>(std::move(name), LLVMTypeContext::get().getPointer());
+	}
+
+	void GlobalPool::useFunction(const Function &function) {
+		std::lock_guard lock(mutex);
+		usedFunctions.insert(&function);
+	}
+
+	bool GlobalPool::isUsed(const Function &function) const {
+		std::lock_guard lock(mutex);
+		return usedFunctions.contains(&function);
+	}
+
+	void GlobalPool::setConstant(std::string name, LLVMValuePtr value) {
+		std::lock_guard lock(mutex);
+		constants.insert_or_assign(std::move(name), std::move(value));
+	}
+
+	LLVMValuePtr GlobalPool::getConstant(std::string_view name) const {
+		std::lock_guard lock(mutex);
+		auto iter = constants.find(std::string(name));
+		return iter == constants.end()? nullptr : iter->second;
+	}
+
+	std::map<std::string, LLVMValuePtr> GlobalPool::getConstants() const {
+		std::lock_guard lock(mutex);
+		return {constants.begin(), constants.end()};
+	}
+
+	std::string GlobalPool::stringsToLLVM() const {
+		std::lock_guard lock(mutex);
+		std::string out;
+		for (const auto &[name, bytes] : strings)
+			out += std::format("@{} = private unnamed_addr constant [{} x i8] c\"{}\\00\"\n", name, bytes.size() + 1, escape(bytes));
+		return out;
+	}
+}
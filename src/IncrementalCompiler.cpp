@@ -0,0 +1,591 @@
+#include "mead/node/Identifier.h"
+#include "mead/util/Casting.h"
+#include "mead/IncrementalCompiler.h"
+#include "mead/Lexer.h"
+#include "mead/Parser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+	void addTokens(mead::Fingerprint &fingerprint, std::span<const mead::Token> tokens, bool with_locations) {
+		fingerprint.add(tokens.size());
+		for (const mead::Token &token : tokens) {
+			fingerprint.add(token.type).add(token.value);
+			if (with_locations)
+				fingerprint.add(token.location.line).add(token.location.column);
+		}
+	}
+
+	void addDiagnostics(mead::Fingerprint &fingerprint, const std::vector<mead::Diagnostic> &diagnostics) {
+		fingerprint.add(diagnostics.size());
+		for (const mead::Diagnostic &diagnostic : diagnostics)
+			fingerprint.add(diagnostic.severity).add(diagnostic.location.line).add(diagnostic.location.column).add(diagnostic.message);
+	}
+
+	void addPiece(mead::Fingerprint &fingerprint, const mead::ModulePiece &piece) {
+		fingerprint.add(piece.sections.size());
+		for (const std::string &section : piece.sections)
+			fingerprint.add(section);
+		fingerprint.add(piece.strings).add(piece.constructor).add(piece.externalDeclarations.size());
+		for (const auto &[name, declaration] : piece.externalDeclarations)
+			fingerprint.add(name).add(declaration);
+		fingerprint.add(piece.constants.size());
+		for (const auto &[name, value] : piece.constants)
+			fingerprint.add(name).add(value->toString());
+		addDiagnostics(fingerprint, piece.diagnostics);
+	}
+
+	mead::Fingerprint::Value fingerprintTokens(const std::vector<mead::Token> &tokens) {
+		mead::Fingerprint fingerprint;
+		addTokens(fingerprint, tokens, true);
+		return fingerprint.get();
+	}
+
+	/** Turns a location relative to the start of an item, which is 1:1, into one in the file. Unknown locations stay
+	 *  unknown. */
+	mead::SourceLocation toAbsolute(mead::SourceLocation location, mead::SourceLocation start) {
+		if (location.line == 0)
+			return location;
+		if (location.line == 1)
+			return {start.line, location.column + start.column - 1};
+		return {location.line + start.line - 1, location.column};
+	}
+
+	/** Matches the characters the lexer allows in identifiers. */
+	bool isIdentifierCharacter(char ch) {
+		return !std::isspace(static_cast<unsigned char>(ch)) && std::string_view("!\"#%&'()*+,-./:;<=>?@[\\]^_`{|}~").find(ch) == std::string_view::npos;
+	}
+
+	std::string_view takeIdentifier(std::string_view text) {
+		size_t length = 0;
+		while (length < text.size() && isIdentifierCharacter(text[length]))
+			++length;
+		return text.substr(0, length);
+	}
+}
+
+namespace mead {
+	void IncrementalCompiler::setSource(const std::string &file, std::string text) {
+		const Fingerprint::Value fingerprint = Fingerprint().add(text).get();
+		engine.setInput(QueryKind::SourceText, file, std::move(text), fingerprint);
+	}
+
+	CompilerResult IncrementalCompiler::compile(const std::string &file) {
+		const ModuleResult &result = getModule(file);
+
+		DiagnosticEngine diagnostics;
+		for (const Diagnostic &diagnostic : result.diagnostics)
+			diagnostics.report(diagnostic);
+		diagnostics.print();
+
+		if (const size_t errors = diagnostics.getErrorCount())
+			return std::unexpected(CompilerError{std::format("{} error{}", errors, errors == 1? "" : "s"), nullptr});
+
+		return result.ir;
+	}
+
+	IncrementalCompiler::ParsedItem IncrementalCompiler::parse(const LexedItem &lexed) {
+		if (!lexed.isComplete) {
+			const SourceLocation location = lexed.tokens.empty()? SourceLocation{} : lexed.tokens.back().location;
+			return {nullptr, Diagnostic{Severity::Error, location, "Lexing failed after this token"}};
+		}
+
+		return parse(lexed.tokens);
+	}
+
+	IncrementalCompiler::ParsedItem IncrementalCompiler::parse(const std::vector<Token> &tokens) {
+		Parser parser;
+
+		if (std::optional<Token> failure = parser.parse(tokens))
+			return {nullptr, Diagnostic{Severity::Error, failure->location, "Parsing failed at this token"}};
+
+		const auto &nodes = parser.getNodes();
+		if (nodes.size() != 1)
+			return {nullptr, Diagnostic{Severity::Error, tokens.empty()? SourceLocation{} : tokens.front().location, "Expected a single declaration"}};
+
+		return {nodes.front(), std::nullopt};
+	}
+
+	std::string IncrementalCompiler::getItemQueryKey(const std::string &file, const std::string &item) {
+		return file + '\n' + item;
+	}
+
+	const IncrementalCompiler::ChunkList & IncrementalCompiler::getChunks(const std::string &file) {
+		return engine.get<ChunkList>(QueryKind::Chunks, file, [this, file] {
+			const std::string_view text = engine.getInput<std::string>(QueryKind::SourceText, file);
+			std::unordered_map<std::string, size_t> name_counts;
+			ChunkList chunks;
+			SourceLocation location{1, 1};
+			size_t i = 0;
+
+			auto advance = [&] {
+				if (text[i++] == '\n') {
+					++location.line;
+					location.column = 1;
+				} else {
+					++location.column;
+				}
+			};
+
+			// Literals can contain braces and semicolons.
+			auto skip_literal = [&](char quote) {
+				for (advance(); i < text.size() && text[i] != quote;) {
+					if (text[i] == '\\' && i + 1 < text.size())
+						advance();
+					advance();
+				}
+				if (i < text.size())
+					advance();
+			};
+
+			for (;;) {
+				// Stray semicolons between items are allowed.
+				while (i < text.size() && (std::isspace(static_cast<unsigned char>(text[i])) || text[i] == ';'))
+					advance();
+
+				if (i == text.size())
+					break;
+
+				const size_t begin = i;
+				const SourceLocation start = location;
+				const bool is_function = text.substr(i).starts_with("fn") && (text.size() == i + 2 || !isIdentifierCharacter(text[i + 2]));
+				size_t depth = 0;
+
+				// A function definition ends with its body. Anything else ends at a semicolon outside of braces.
+				while (i < text.size()) {
+					const char ch = text[i];
+
+					// Apostrophes after digits are digit separators.
+					if (ch == '"' || (ch == '\'' && (i == begin || !std::isalnum(static_cast<unsigned char>(text[i - 1]))))) {
+						skip_literal(ch);
+						continue;
+					}
+
+					advance();
+
+					if (ch == '{') {
+						++depth;
+					} else if (ch == '}' && depth != 0 && --depth == 0 && is_function) {
+						break;
+					} else if (ch == ';' && depth == 0) {
+						break;
+					}
+				}
+
+				const std::string_view item_text = text.substr(begin, i - begin);
+				Item item;
+
+				if (is_function) {
+					std::string_view rest = item_text.substr(2);
+					while (!rest.empty() && std::isspace(static_cast<unsigned char>(rest.front())))
+						rest.remove_prefix(1);
+					item.name = takeIdentifier(rest);
+					item.kind = item_text.ends_with('}')? ItemKind::FunctionDefinition : ItemKind::FunctionDeclaration;
+				} else {
+					item.name = takeIdentifier(item_text);
+					item.kind = ItemKind::Global;
+				}
+
+				const size_t count = name_counts[item.name]++;
+				item.key = count == 0? item.name : std::format("{}#{}", item.name, count);
+
+				ItemList &list = chunks.list;
+				list.byKey.emplace(item.key, list.items.size());
+				list.byName[item.name].push_back(list.items.size());
+				list.items.push_back(std::move(item));
+				chunks.texts.push_back({std::string(item_text), start});
+			}
+
+			return chunks;
+		}, [](const ChunkList &chunks) {
+			Fingerprint fingerprint;
+			fingerprint.add(chunks.texts.size());
+			for (size_t i = 0; i < chunks.texts.size(); ++i) {
+				const ItemText &text = chunks.texts[i];
+				fingerprint.add(chunks.list.items[i].kind).add(text.text).add(text.start.line).add(text.start.column);
+			}
+			return fingerprint.get();
+		});
+	}
+
+	const IncrementalCompiler::ItemList & IncrementalCompiler::getItems(const std::string &file) {
+		return engine.get<ItemList>(QueryKind::Items, file, [this, file] {
+			return getChunks(file).list;
+		}, [](const ItemList &list) {
+			Fingerprint fingerprint;
+			fingerprint.add(list.items.size());
+			for (const Item &item : list.items)
+				fingerprint.add(item.key).add(item.kind);
+			return fingerprint.get();
+		});
+	}
+
+	const std::string & IncrementalCompiler::getItemText(const std::string &file, const std::string &item) {
+		return engine.get<std::string>(QueryKind::ItemText, getItemQueryKey(file, item), [this, file, item] {
+			const ChunkList &chunks = getChunks(file);
+			return chunks.texts.at(chunks.list.byKey.at(item)).text;
+		}, [](const std::string &text) {
+			return Fingerprint().add(text).get();
+		});
+	}
+
+	const SourceLocation & IncrementalCompiler::getItemStart(const std::string &file, const std::string &item) {
+		return engine.get<SourceLocation>(QueryKind::ItemStart, getItemQueryKey(file, item), [this, file, item] {
+			const ChunkList &chunks = getChunks(file);
+			return chunks.texts.at(chunks.list.byKey.at(item)).start;
+		}, [](const SourceLocation &start) {
+			return Fingerprint().add(start.line).add(start.column).get();
+		});
+	}
+
+	const IncrementalCompiler::LexedItem & IncrementalCompiler::getItemTokens(const std::string &file, const std::string &item) {
+		return engine.get<LexedItem>(QueryKind::ItemTokens, getItemQueryKey(file, item), [this, file, item] {
+			Lexer lexer;
+			const bool is_complete = lexer.lex(getItemText(file, item));
+			return LexedItem{std::move(lexer.tokens), is_complete};
+		}, [](const LexedItem &lexed) {
+			return Fingerprint().add(fingerprintTokens(lexed.tokens)).add(lexed.isComplete).get();
+		});
+	}
+
+	const IncrementalCompiler::ParsedItem & IncrementalCompiler::getItemAST(const std::string &file, const std::string &item) {
+		return engine.get<ParsedItem>(QueryKind::ItemAST, getItemQueryKey(file, item), [this, file, item] {
+			const LexedItem &lexed = getItemTokens(file, item);
+			ParsedItem parsed = parse(lexed);
+			parsed.fingerprint = fingerprintTokens(lexed.tokens);
+			return parsed;
+		}, [](const ParsedItem &parsed) {
+			// The AST is determined by the tokens.
+			return parsed.fingerprint;
+		});
+	}
+
+	const std::vector<std::string> & IncrementalCompiler::getReferences(const std::string &file, const std::string &item) {
+		return engine.get<std::vector<std::string>>(QueryKind::References, getItemQueryKey(file, item), [this, file, item] {
+			std::set<std::string> names;
+
+			if (const ASTNodePtr &root = getItemAST(file, item).node) {
+				std::vector<const ASTNode *> stack{root.get()};
+				while (!stack.empty()) {
+					const ASTNode *node = stack.back();
+					stack.pop_back();
+
+					if (auto identifier = dyn_cast<Identifier>(node))
+						names.insert(identifier->getIdentifier());
+
+					for (const ASTNodePtr &child : *node)
+						stack.push_back(child.get());
+				}
+			}
+
+			return std::vector<std::string>(names.begin(), names.end());
+		}, [](const std::vector<std::string> &names) {
+			Fingerprint fingerprint;
+			fingerprint.add(names.size());
+			for (const std::string &name : names)
+				fingerprint.add(name);
+			return fingerprint.get();
+		});
+	}
+
+	const std::vector<Token> & IncrementalCompiler::getSignature(const std::string &file, const std::string &item) {
+		return engine.get<std::vector<Token>>(QueryKind::Signature, getItemQueryKey(file, item), [this, file, item] {
+			const std::vector<Token> &tokens = getItemTokens(file, item).tokens;
+			const bool is_function = !tokens.empty() && tokens.front().type == TokenType::Fn;
+			// A function's signature ends where its body starts and a global's ends where its initializer starts.
+			const TokenType end = is_function? TokenType::OpeningBrace : TokenType::Equals;
+
+			std::vector<Token> signature;
+			for (const Token &token : tokens) {
+				if (token.type == end || token.type == TokenType::Semicolon)
+					break;
+				signature.emplace_back(token.type, token.value, SourceLocation{});
+			}
+
+			signature.emplace_back(TokenType::Semicolon, ";", SourceLocation{});
+			return signature;
+		}, [](const std::vector<Token> &signature) {
+			Fingerprint fingerprint;
+			addTokens(fingerprint, signature, false);
+			return fingerprint.get();
+		});
+	}
+
+	const std::string & IncrementalCompiler::getMangledName(const std::string &file, const std::string &item) {
+		return engine.get<std::string>(QueryKind::MangledName, getItemQueryKey(file, item), [this, file, item] {
+			ParsedItem signature = parse(getSignature(file, item));
+			if (!signature.node || signature.node->type != NodeType::FunctionDeclaration)
+				return std::string{};
+			return Compiler(0).getMangledName(*signature.node).value_or(std::string{});
+		}, [](const std::string &name) {
+			return Fingerprint().add(name).get();
+		});
+	}
+
+	const std::map<std::string, Purity> & IncrementalCompiler::getPurities(const std::string &file) {
+		return engine.get<std::map<std::string, Purity>>(QueryKind::Purities, file, [this, file] {
+			// Inferring purity only reads the ASTs, so the shared ones will do.
+			std::vector<ASTNodePtr> nodes;
+			std::vector<std::string> keys;
+			for (const Item &item : getItems(file).items) {
+				if (item.kind == ItemKind::Global)
+					continue;
+				if (const ASTNodePtr &node = getItemAST(file, item.key).node) {
+					nodes.push_back(node);
+					keys.push_back(item.key);
+				}
+			}
+
+			Compiler compiler(0);
+			std::vector<Purity> purities = compiler.inferPurity(nodes);
+
+			std::map<std::string, Purity> out;
+			for (size_t i = 0; i < keys.size(); ++i)
+				out.emplace(keys[i], purities[i]);
+			return out;
+		}, [](const std::map<std::string, Purity> &purities) {
+			Fingerprint fingerprint;
+			fingerprint.add(purities.size());
+			for (const auto &[key, purity] : purities)
+				fingerprint.add(key).add(purity);
+			return fingerprint.get();
+		});
+	}
+
+	const Purity & IncrementalCompiler::getItemPurity(const std::string &file, const std::string &item) {
+		return engine.get<Purity>(QueryKind::ItemPurity, getItemQueryKey(file, item), [this, file, item] {
+			const std::map<std::string, Purity> &purities = getPurities(file);
+			auto iter = purities.find(item);
+			return iter == purities.end()? Purity::Impure : iter->second;
+		}, [](Purity purity) {
+			return Fingerprint().add(purity).get();
+		});
+	}
+
+	const LLVMValuePtr & IncrementalCompiler::getGlobalConstant(const std::string &file, const std::string &item) {
+		return engine.get<LLVMValuePtr>(QueryKind::GlobalConstant, getItemQueryKey(file, item), [this, file, item]() -> LLVMValuePtr {
+			const ItemList &list = getItems(file);
+			const std::map<std::string, LLVMValuePtr> &constants = getGlobals(file).piece.constants;
+			auto iter = constants.find(list.items[list.byKey.at(item)].name);
+			return iter == constants.end()? nullptr : iter->second;
+		}, [](const LLVMValuePtr &value) {
+			return Fingerprint().add(value? value->toString() : std::string{}).get();
+		});
+	}
+
+	const ModulePiece & IncrementalCompiler::getFunctionIR(const std::string &file, const std::string &item) {
+		return engine.get<ModulePiece>(QueryKind::FunctionIR, getItemQueryKey(file, item), [this, file, item] {
+			ParsedItem definition = parse(getItemTokens(file, item));
+			assert(definition.node);
+
+			// Only the signatures of what the body refers to matter, so changes to other items don't affect this one. The
+			// function's own overloads decide whether its symbol name is mangled, so they're included too.
+			const ItemList &list = getItems(file);
+			std::vector<std::string> names = getReferences(file, item);
+			const std::string &own_name = list.items[list.byKey.at(item)].name;
+			if (auto position = std::ranges::lower_bound(names, own_name); position == names.end() || *position != own_name)
+				names.insert(position, own_name);
+
+			std::vector<ASTNodePtr> declarations;
+			// Signatures stop before initializers, so the values of constant globals come from the globals instead.
+			std::map<std::string, LLVMValuePtr> constants;
+
+			for (const std::string &name : names) {
+				auto iter = list.byName.find(name);
+				if (iter == list.byName.end())
+					continue;
+
+				for (const size_t index : iter->second) {
+					const Item &other = list.items[index];
+					if (other.key == item)
+						continue;
+					if (ASTNodePtr declaration = parse(getSignature(file, other.key)).node)
+						declarations.push_back(std::move(declaration));
+					if (other.kind == ItemKind::Global)
+						if (const LLVMValuePtr &value = getGlobalConstant(file, other.key))
+							constants.emplace(other.name, value);
+				}
+			}
+
+			Compiler compiler(0);
+			return compiler.compileFunction(declarations, definition.node, getItemPurity(file, item), constants);
+		}, [](const ModulePiece &piece) {
+			Fingerprint fingerprint;
+			addPiece(fingerprint, piece);
+			return fingerprint.get();
+		});
+	}
+
+	const IncrementalCompiler::GlobalsPiece & IncrementalCompiler::getGlobals(const std::string &file) {
+		return engine.get<GlobalsPiece>(QueryKind::Globals, file, [this, file] {
+			const ItemList &list = getItems(file);
+
+			// Initializers can call functions at compile time, so the globals need every function they can reach.
+			std::vector<bool> included(list.items.size());
+			std::vector<size_t> worklist;
+
+			for (size_t i = 0; i < list.items.size(); ++i) {
+				if (list.items[i].kind == ItemKind::Global) {
+					included[i] = true;
+					worklist.push_back(i);
+				}
+			}
+
+			while (!worklist.empty()) {
+				const Item &current = list.items[worklist.back()];
+				worklist.pop_back();
+
+				for (const std::string &name : getReferences(file, current.key)) {
+					auto iter = list.byName.find(name);
+					if (iter == list.byName.end())
+						continue;
+
+					for (const size_t index : iter->second) {
+						if (!included[index]) {
+							included[index] = true;
+							worklist.push_back(index);
+						}
+					}
+				}
+			}
+
+			GlobalsPiece out;
+			std::vector<ASTNodePtr> nodes;
+
+			for (size_t i = 0; i < list.items.size(); ++i) {
+				if (!included[i])
+					continue;
+
+				// The globals are compiled together, so their diagnostics can't be moved afterwards like a function's.
+				const SourceLocation start = getItemStart(file, list.items[i].key);
+				std::vector<Token> tokens = getItemTokens(file, list.items[i].key).tokens;
+				for (Token &token : tokens)
+					token.location = toAbsolute(token.location, start);
+
+				if (ASTNodePtr node = parse(tokens).node) {
+					nodes.push_back(std::move(node));
+					out.keys.push_back(list.items[i].key);
+				}
+			}
+
+			Compiler compiler(0);
+			out.piece = compiler.compileGlobals(nodes);
+			return out;
+		}, [](const GlobalsPiece &globals) {
+			Fingerprint fingerprint;
+			addPiece(fingerprint, globals.piece);
+			for (const std::string &key : globals.keys)
+				fingerprint.add(key);
+			return fingerprint.get();
+		});
+	}
+
+	const IncrementalCompiler::ModuleResult & IncrementalCompiler::getModule(const std::string &file) {
+		return engine.get<ModuleResult>(QueryKind::Module, file, [this, file] {
+			ModuleResult out;
+			const ItemList &list = getItems(file);
+			const GlobalsPiece &globals = getGlobals(file);
+
+			std::unordered_map<std::string, size_t> global_sections;
+			for (size_t i = 0; i < globals.keys.size(); ++i)
+				global_sections.emplace(globals.keys[i], i);
+
+			std::vector<std::string> sections;
+			std::set<std::string> strings;
+			std::map<std::string, std::string> external_declarations;
+			// Functions are told apart by their mangled names, or by their names if their types are unknown, in which
+			// case their pieces report it.
+			std::unordered_set<std::string> signatures, defined_signatures;
+			std::unordered_map<std::string, size_t> overload_counts;
+
+			// A function's piece gets the start of its item, so that its diagnostics can be moved there.
+			auto merge = [&](const ModulePiece &piece, SourceLocation start) {
+				std::istringstream lines(piece.strings);
+				for (std::string line; std::getline(lines, line);)
+					strings.insert(std::move(line));
+				external_declarations.insert(piece.externalDeclarations.begin(), piece.externalDeclarations.end());
+				for (Diagnostic diagnostic : piece.diagnostics) {
+					diagnostic.location = toAbsolute(diagnostic.location, start);
+					out.diagnostics.push_back(std::move(diagnostic));
+				}
+			};
+
+			for (const Item &item : list.items) {
+				const ParsedItem &parsed = getItemAST(file, item.key);
+				const SourceLocation start = getItemStart(file, item.key);
+				if (!parsed.node) {
+					out.diagnostics.push_back(*parsed.failure);
+					out.diagnostics.back().location = toAbsolute(out.diagnostics.back().location, start);
+					continue;
+				}
+
+				// The globals are compiled together, so redefinitions of them are reported by the globals piece.
+				if (item.kind == ItemKind::Global) {
+					if (auto iter = global_sections.find(item.key); iter != global_sections.end())
+						sections.push_back(globals.piece.sections[iter->second]);
+					continue;
+				}
+
+				const std::string &mangled_name = getMangledName(file, item.key);
+				if (!signatures.insert(mangled_name.empty()? item.name : mangled_name).second) {
+					out.diagnostics.push_back({Severity::Error, toAbsolute(parsed.node->location(), start), std::format("Redefinition of function {}", item.name)});
+					continue;
+				}
+
+				if (!mangled_name.empty())
+					++overload_counts[item.name];
+
+				if (item.kind == ItemKind::FunctionDefinition) {
+					const ModulePiece &piece = getFunctionIR(file, item.key);
+					sections.push_back(piece.sections.front());
+					defined_signatures.insert(mangled_name.empty()? item.name : mangled_name);
+					merge(piece, start);
+				}
+			}
+
+			merge(globals.piece, {1, 1});
+
+			std::string ir;
+
+			for (const std::string &section : sections)
+				if (!section.empty())
+					ir += section + '\n';
+
+			for (const std::string &line : strings)
+				ir += line + '\n';
+
+			for (const Item &item : list.items) {
+				if (item.kind != ItemKind::FunctionDeclaration)
+					continue;
+
+				const std::string &mangled_name = getMangledName(file, item.key);
+				if (defined_signatures.contains(mangled_name.empty()? item.name : mangled_name))
+					continue;
+
+				// Pieces declare overloaded functions by their mangled names. Only the first declaration of a signature
+				// gets here, since the rest are redefinitions.
+				const std::string &symbol_name = overload_counts[item.name] > 1? mangled_name : item.name;
+				if (auto iter = external_declarations.find(symbol_name); iter != external_declarations.end()) {
+					ir += iter->second + '\n';
+					external_declarations.erase(iter);
+				}
+			}
+
+			if (!globals.piece.constructor.empty())
+				ir += globals.piece.constructor + '\n';
+
+			out.ir = std::move(ir);
+			return out;
+		}, [](const ModuleResult &result) {
+			Fingerprint fingerprint;
+			fingerprint.add(result.ir);
+			addDiagnostics(fingerprint, result.diagnostics);
+			return fingerprint.get();
+		});
+	}
+}
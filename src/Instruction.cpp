@@ -2,9 +2,6 @@
 #include "mead/Instruction.h"
 
 namespace mead {
-	Instruction::Instruction(std::weak_ptr<BasicBlock> block):
-		block(std::move(block)) {}
-
 	std::string Instruction::toString() const {
 		return '[' + DEMANGLE(*this) + ']';
 	}
@@ -0,0 +1,400 @@
+#include "mead/Function.h"
+#include "mead/Interpreter.h"
+#include "mead/Namespace.h"
+#include "mead/Program.h"
+#include "mead/Scope.h"
+#include "mead/Type.h"
+#include "mead/TypeContext.h"
+#include "mead/Variable.h"
+
+#include <cassert>
+
+namespace {
+	/** Literals are i64 const, which nothing narrower converts to or from. As with initializers, a literal operand takes
+	 *  the other operand's type if its value fits. */
+	void adaptLiterals(const mead::ASTNode &lhs_node, mead::IntConstant &lhs, const mead::ASTNode &rhs_node, mead::IntConstant &rhs) {
+		if (rhs_node.type == mead::NodeType::Number && rhs.fits(*lhs.getType()))
+			rhs = rhs.convert(lhs.getType());
+		else if (lhs_node.type == mead::NodeType::Number && lhs.fits(*rhs.getType()))
+			lhs = lhs.convert(rhs.getType());
+	}
+}
+
+namespace mead {
+	Interpreter::Interpreter(const Scope &scope, size_t step_budget):
+		scope(scope), context(scope.getProgram()->getTypeContext()), stepBudget(step_budget) {}
+
+	std::optional<IntConstant> Interpreter::evaluate(const ASTNode &node) {
+		assert(frames.empty());
+		steps = 0;
+		// The outermost frame holds locals declared in conditional expression blocks; it has nothing to return to.
+		frames.emplace_back();
+		std::optional<IntConstant> result = evaluateExpression(node);
+		frames.clear();
+		return result;
+	}
+
+	void Interpreter::setGlobalValue(const Variable &variable, IntConstant value) {
+		globals.insert_or_assign(&variable, std::move(value));
+	}
+
+	std::optional<IntConstant> Interpreter::evaluateExpression(const ASTNode &node) {
+		if (stepBudget < ++steps)
+			return std::nullopt;
+		return visit(node);
+	}
+
+	std::optional<IntConstant> Interpreter::evaluateBlock(const ASTNode &block) {
+		// A block's value is that of its last statement, which has to be an expression statement.
+		if (block.type != NodeType::Block || block.empty())
+			return std::nullopt;
+
+		const ASTNode &last = *block.back();
+		if (last.type != NodeType::ExpressionStatement || last.size() != 1)
+			return std::nullopt;
+
+		frames.back().blocks.emplace_back();
+
+		std::optional<IntConstant> result;
+
+		bool ok = true;
+		for (size_t i = 0; ok && i + 1 < block.size(); ++i)
+			ok = execute(*block.at(i)) == Flow::Normal;
+
+		if (ok)
+			result = evaluateExpression(*last.front());
+
+		frames.back().blocks.pop_back();
+		return result;
+	}
+
+	std::optional<IntConstant> Interpreter::evaluateConversion(const ASTNode &type_node, const ASTNode &subexpr) {
+		auto int_type = getIntType(type_node);
+		if (!int_type)
+			return std::nullopt;
+
+		std::optional<IntConstant> value = evaluateExpression(subexpr);
+		if (!value)
+			return std::nullopt;
+
+		return value->convert(std::move(int_type));
+	}
+
+	std::shared_ptr<IntType> Interpreter::getIntType(const ASTNode &type_node) const {
+		const auto *type = dyn_cast<TypeNode>(&type_node);
+		if (!type)
+			return nullptr;
+		return dyn_cast_if_present<IntType>(type->getType(scope.getProgram()->getGlobalNamespace()));
+	}
+
+	std::optional<IntConstant> Interpreter::call(const Function &function, std::vector<IntConstant> arguments) {
+		if (maxDepth < frames.size())
+			return std::nullopt;
+
+		const auto &definition = function.getDefinition();
+		if (!definition)
+			return std::nullopt;
+
+		auto return_type = dyn_cast_if_present<IntType>(function.getReturnType());
+		if (!return_type)
+			return std::nullopt;
+
+		const auto &argument_types = function.getArgumentTypes();
+		if (argument_types.size() != arguments.size())
+			return std::nullopt;
+
+		std::vector<uint64_t> key;
+		key.reserve(arguments.size());
+
+		for (size_t i = 0; i < arguments.size(); ++i) {
+			auto int_type = dyn_cast_if_present<IntType>(argument_types[i]);
+			if (!int_type)
+				return std::nullopt;
+			arguments[i] = arguments[i].convert(std::move(int_type));
+			key.push_back(arguments[i].getUnsigned());
+		}
+
+		auto memo_key = std::make_pair(&function, std::move(key));
+		if (auto iter = memo.find(memo_key); iter != memo.end())
+			return iter->second;
+
+		// Parameters follow the name and return type in the prototype.
+		const ASTNode &prototype = *definition->front();
+		auto &parameters = frames.emplace_back(Frame{return_type, std::nullopt, {}}).blocks.emplace_back();
+
+		for (size_t i = 0; i < arguments.size(); ++i) {
+			const auto *identifier = dyn_cast<Identifier>(prototype.at(i + 2)->front().get());
+			assert(identifier);
+			parameters[identifier->getIdentifier()] = Local{arguments[i].getType(), arguments[i]};
+		}
+
+		const Flow flow = execute(*definition->at(1));
+		std::optional<IntConstant> result = std::move(frames.back().returnValue);
+		frames.pop_back();
+
+		// Falling off the end of a function that returns a value has no value to fold.
+		if (flow != Flow::Return || !result)
+			return std::nullopt;
+
+		memo.emplace(std::move(memo_key), *result);
+		return result;
+	}
+
+	Interpreter::Flow Interpreter::execute(const ASTNode &statement) {
+		if (stepBudget < ++steps)
+			return Flow::Fail;
+
+		switch (statement.type) {
+			case NodeType::Block: {
+				frames.back().blocks.emplace_back();
+				Flow flow = Flow::Normal;
+				for (const ASTNodePtr &child : statement) {
+					flow = execute(*child);
+					if (flow != Flow::Normal)
+						break;
+				}
+				// Calls push frames, so a reference to this frame's blocks wouldn't survive the loop.
+				frames.back().blocks.pop_back();
+				return flow;
+			}
+
+			case NodeType::VariableDeclaration:
+				return declare(statement, nullptr);
+
+			case NodeType::VariableDefinition:
+				return declare(*statement.at(0), statement.at(1).get());
+
+			case NodeType::ExpressionStatement:
+				return evaluateExpression(*statement.front())? Flow::Normal : Flow::Fail;
+
+			case NodeType::ReturnStatement: {
+				if (!frames.back().returnType || statement.size() != 1)
+					return Flow::Fail;
+				std::optional<IntConstant> value = evaluateExpression(*statement.front());
+				if (!value)
+					return Flow::Fail;
+				frames.back().returnValue = value->convert(frames.back().returnType);
+				return Flow::Return;
+			}
+
+			case NodeType::IfStatement: {
+				std::optional<IntConstant> condition = evaluateExpression(*statement.at(0));
+				if (!condition)
+					return Flow::Fail;
+				if (condition->isTrue())
+					return execute(*statement.at(1));
+				if (statement.size() == 3)
+					return execute(*statement.at(2));
+				return Flow::Normal;
+			}
+
+			case NodeType::EmptyStatement:
+				return Flow::Normal;
+
+			default:
+				return Flow::Fail;
+		}
+	}
+
+	Interpreter::Flow Interpreter::declare(const ASTNode &declaration, const ASTNode *initializer) {
+		const auto *identifier = dyn_cast<Identifier>(declaration.at(0).get());
+		auto int_type = getIntType(*declaration.at(1));
+		if (!identifier || !int_type)
+			return Flow::Fail;
+
+		Local local{int_type, std::nullopt};
+
+		if (initializer) {
+			std::optional<IntConstant> value = evaluateExpression(*initializer);
+			if (!value)
+				return Flow::Fail;
+			local.value = value->convert(std::move(int_type));
+		}
+
+		frames.back().blocks.back().insert_or_assign(identifier->getIdentifier(), std::move(local));
+		return Flow::Normal;
+	}
+
+	Interpreter::Local * Interpreter::findLocal(const ASTNode &node) {
+		const auto *identifier = dyn_cast<Identifier>(&node);
+		if (!identifier)
+			return nullptr;
+
+		auto &blocks = frames.back().blocks;
+		for (auto iter = blocks.rbegin(); iter != blocks.rend(); ++iter)
+			if (auto found = iter->find(identifier->getIdentifier()); found != iter->end())
+				return &found->second;
+
+		return nullptr;
+	}
+
+	std::optional<IntConstant> Interpreter::assign(const ASTNode &target, const IntConstant &value) {
+		// Only locals can be written; anything else would be a side effect visible outside the evaluation.
+		Local *local = findLocal(target);
+		if (!local)
+			return std::nullopt;
+		return local->value = value.convert(local->type);
+	}
+
+	std::optional<IntConstant> Interpreter::step(const ASTNode &target, TokenType operation, bool prefix) {
+		Local *local = findLocal(target);
+		if (!local || !local->value)
+			return std::nullopt;
+
+		const IntConstant old_value = *local->value;
+		std::optional<IntConstant> new_value = IntConstant::applyBinary(operation, old_value, IntConstant(1, local->type));
+		if (!new_value)
+			return std::nullopt;
+
+		local->value = new_value->convert(local->type);
+		return prefix? local->value : old_value;
+	}
+
+	std::optional<IntConstant> Interpreter::visitNumber(const Number &node) {
+		std::optional<uint64_t> value = node.getValue();
+		if (!value)
+			return std::nullopt;
+		return IntConstant(*value, node.getIntType(context));
+	}
+
+	std::optional<IntConstant> Interpreter::visitIdentifier(const Identifier &node) {
+		if (const Local *local = findLocal(node))
+			return local->value;
+
+		// Outside the locals only constant globals with values known at compile time can be read.
+		if (VariablePtr variable = scope.getVariable(node.getIdentifier()))
+			if (auto iter = globals.find(variable.get()); iter != globals.end())
+				return iter->second;
+
+		return std::nullopt;
+	}
+
+	std::optional<IntConstant> Interpreter::visitBinary(const Binary &node) {
+		std::optional<IntConstant> lhs = evaluateExpression(*node.at(0));
+		if (!lhs)
+			return std::nullopt;
+
+		// The right side of a short-circuiting operator may have side effects on locals, so it mustn't always run.
+		const TokenType operation = node.token.type;
+		if ((operation == TokenType::DoubleAmpersand && !lhs->isTrue()) || (operation == TokenType::DoublePipe && lhs->isTrue()))
+			return IntConstant(lhs->isTrue(), lhs->getType());
+
+		std::optional<IntConstant> rhs = evaluateExpression(*node.at(1));
+		if (!rhs)
+			return std::nullopt;
+
+		adaptLiterals(*node.at(0), *lhs, *node.at(1), *rhs);
+		return IntConstant::applyBinary(operation, *lhs, *rhs);
+	}
+
+	std::optional<IntConstant> Interpreter::visitUnaryPlus(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> Interpreter::visitUnaryMinus(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> Interpreter::visitLogicalNot(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> Interpreter::visitBitwiseNot(const ASTNode &node) {
+		return visitUnary(node);
+	}
+
+	std::optional<IntConstant> Interpreter::visitUnary(const ASTNode &node) {
+		if (std::optional<IntConstant> value = evaluateExpression(*node.front()))
+			return IntConstant::applyUnary(node.type, *value);
+		return std::nullopt;
+	}
+
+	std::optional<IntConstant> Interpreter::visitCast(const ASTNode &node) {
+		return evaluateConversion(*node.at(0), *node.at(1));
+	}
+
+	std::optional<IntConstant> Interpreter::visitConstructorCall(const ASTNode &node) {
+		const ASTNode &args = *node.at(1);
+		if (args.size() != 1)
+			return std::nullopt;
+		return evaluateConversion(*node.at(0), *args.front());
+	}
+
+	std::optional<IntConstant> Interpreter::visitConditionalExpression(const ASTNode &node) {
+		std::optional<IntConstant> condition = evaluateExpression(*node.at(0));
+		if (!condition)
+			return std::nullopt;
+		return evaluateBlock(*node.at(condition->isTrue()? 1 : 2));
+	}
+
+	std::optional<IntConstant> Interpreter::visitAssign(const ASTNode &node) {
+		std::optional<IntConstant> value = evaluateExpression(*node.at(1));
+		if (!value)
+			return std::nullopt;
+		return assign(*node.at(0), *value);
+	}
+
+	std::optional<IntConstant> Interpreter::visitCompoundAssign(const ASTNode &node) {
+		const TokenType operation = getCompoundOperator(node.token.type);
+		if (operation == TokenType::Invalid)
+			return std::nullopt;
+
+		std::optional<IntConstant> lhs = evaluateExpression(*node.at(0));
+		if (!lhs)
+			return std::nullopt;
+
+		std::optional<IntConstant> rhs = evaluateExpression(*node.at(1));
+		if (!rhs)
+			return std::nullopt;
+
+		adaptLiterals(*node.at(0), *lhs, *node.at(1), *rhs);
+		std::optional<IntConstant> value = IntConstant::applyBinary(operation, *lhs, *rhs);
+		if (!value)
+			return std::nullopt;
+
+		return assign(*node.at(0), *value);
+	}
+
+	std::optional<IntConstant> Interpreter::visitPrefixIncrement(const ASTNode &node) {
+		return step(*node.front(), TokenType::Plus, true);
+	}
+
+	std::optional<IntConstant> Interpreter::visitPrefixDecrement(const ASTNode &node) {
+		return step(*node.front(), TokenType::Minus, true);
+	}
+
+	std::optional<IntConstant> Interpreter::visitPostfixIncrement(const ASTNode &node) {
+		return step(*node.front(), TokenType::Plus, false);
+	}
+
+	std::optional<IntConstant> Interpreter::visitPostfixDecrement(const ASTNode &node) {
+		return step(*node.front(), TokenType::Minus, false);
+	}
+
+	std::optional<IntConstant> Interpreter::visitComma(const ASTNode &node) {
+		if (!evaluateExpression(*node.at(0)))
+			return std::nullopt;
+		return evaluateExpression(*node.at(1));
+	}
+
+	std::optional<IntConstant> Interpreter::visitFunctionCall(const FunctionCall &node) {
+		FunctionPtr function = node.resolveCallee(scope).function;
+		if (!function)
+			return std::nullopt;
+
+		std::vector<IntConstant> arguments;
+
+		for (const ASTNodePtr &argument : *node.getArgs()) {
+			std::optional<IntConstant> value = evaluateExpression(*argument);
+			if (!value)
+				return std::nullopt;
+			arguments.push_back(std::move(*value));
+		}
+
+		return call(*function, std::move(arguments));
+	}
+
+	std::optional<IntConstant> Interpreter::visitNode(const ASTNode &) {
+		return std::nullopt;
+	}
+}
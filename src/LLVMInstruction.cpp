@@ -1,11 +1,59 @@
+#include "mead/BasicBlock.h"
 #include "mead/LLVMInstruction.h"
+#include "mead/LLVMTypeContext.h"
+#include "mead/Util.h"
+
+#include <cassert>
+#include <format>
+
+namespace {
+	std::string getLabel(const std::weak_ptr<mead::BasicBlock> &weak_block) {
+		auto block = weak_block.lock();
+		assert(block);
+		return '%' + block->getLabel();
+	}
+}
 
 namespace mead {
-	LLVMRet::LLVMRet(std::weak_ptr<BasicBlock> block, LLVMValuePtr value):
-		LLVMInstruction(std::move(block)), value(std::move(value)) {}
+	LLVMRet::LLVMRet(LLVMValuePtr value):
+		LLVMInstruction(InstructionKind::Ret), value(std::move(value)) {}
+
+	std::vector<LLVMValuePtr *> LLVMRet::getOperands() {
+		if (!value)
+			return {};
+		return {&value};
+	}
+
+	std::string LLVMRet::toString() const {
+		if (!value)
+			return "ret void";
+		return std::format("ret {}", value);
+	}
 
-	LLVMThreeReg::LLVMThreeReg(std::weak_ptr<BasicBlock> block, LLVMValuePtr left, LLVMValuePtr right, LLVMValuePtr result):
-		LLVMInstruction(std::move(block)), left(std::move(left)), right(std::move(right)), result(std::move(result)) {}
+	LLVMBr::LLVMBr(std::weak_ptr<BasicBlock> destination):
+		LLVMInstruction(InstructionKind::Br), destination(std::move(destination)) {}
+
+	std::string LLVMBr::toString() const {
+		return std::format("br label {}", getLabel(destination));
+	}
+
+	LLVMCondBr::LLVMCondBr(LLVMValuePtr condition, std::weak_ptr<BasicBlock> if_true, std::weak_ptr<BasicBlock> if_false):
+		LLVMInstruction(InstructionKind::CondBr), condition(std::move(condition)), ifTrue(std::move(if_true)), ifFalse(std::move(if_false)) {}
+
+	std::vector<LLVMValuePtr *> LLVMCondBr::getOperands() {
+		return {&condition};
+	}
+
+	std::string LLVMCondBr::toString() const {
+		return std::format("br {}, label {}, label {}", condition, getLabel(ifTrue), getLabel(ifFalse));
+	}
+
+	LLVMThreeReg::LLVMThreeReg(LLVMValuePtr left, LLVMValuePtr right, LLVMValuePtr result):
+		LLVMInstruction(InstructionKind::ThreeReg), left(std::move(left)), right(std::move(right)), result(std::move(result)) {}
+
+	std::vector<LLVMValuePtr *> LLVMThreeReg::getOperands() {
+		return {&left, &right};
+	}
 
 	void LLVMThreeReg::assertValid() const {
 		assert(left);
@@ -16,10 +64,122 @@ namespace mead {
 		assert(left_type);
 		assert(right_type);
 		assert(*left_type == *right_type);
+		assert(*left_type == *result->getType());
 	}
 
 	std::string LLVMThreeReg::toString() const {
 		assertValid();
 		return std::format("{} = {} {} {}, {}", result->toString(), getKeyword(), left->getType(), left->toString(), right->toString());
 	}
+
+	LLVMIcmp::LLVMIcmp(LLVMPredicate predicate, LLVMValuePtr left, LLVMValuePtr right, LLVMValuePtr result):
+		LLVMThreeReg(std::move(left), std::move(right), std::move(result)), predicate(predicate) {}
+
+	std::string LLVMIcmp::getKeyword() const {
+		switch (predicate) {
+			case LLVMPredicate::Eq:  return "icmp eq";
+			case LLVMPredicate::Ne:  return "icmp ne";
+			case LLVMPredicate::Slt: return "icmp slt";
+			case LLVMPredicate::Sle: return "icmp sle";
+			case LLVMPredicate::Sgt: return "icmp sgt";
+			case LLVMPredicate::Sge: return "icmp sge";
+			case LLVMPredicate::Ult: return "icmp ult";
+			case LLVMPredicate::Ule: return "icmp ule";
+			case LLVMPredicate::Ugt: return "icmp ugt";
+			case LLVMPredicate::Uge: return "icmp uge";
+		}
+
+		assert(!"Invalid predicate");
+		return "icmp";
+	}
+
+	void LLVMIcmp::assertValid() const {
+		assert(left);
+		assert(right);
+		assert(result);
+		assert(*left->getType() == *right->getType());
+		assert(result->getType() == LLVMTypeContext::get().getInt(1));
+	}
+
+	LLVMCast::LLVMCast(LLVMCastKind cast_kind, LLVMValuePtr value, LLVMValuePtr result):
+		LLVMInstruction(InstructionKind::Cast), castKind(cast_kind), value(std::move(value)), result(std::move(result)) {}
+
+	std::vector<LLVMValuePtr *> LLVMCast::getOperands() {
+		return {&value};
+	}
+
+	std::string LLVMCast::toString() const {
+		const char *keyword = castKind == LLVMCastKind::Trunc? "trunc" : castKind == LLVMCastKind::ZExt? "zext" : "sext";
+		return std::format("{} = {} {} to {}", result->toString(), keyword, value, result->getType());
+	}
+
+	LLVMAlloca::LLVMAlloca(LLVMTypePtr allocated_type, LLVMValuePtr result):
+		LLVMInstruction(InstructionKind::Alloca), allocatedType(std::move(allocated_type)), result(std::move(result)) {}
+
+	std::string LLVMAlloca::toString() const {
+		return std::format("{} = alloca {}", result->toString(), allocatedType);
+	}
+
+	LLVMLoad::LLVMLoad(LLVMValuePtr pointer, LLVMValuePtr result):
+		LLVMInstruction(InstructionKind::Load), pointer(std::move(pointer)), result(std::move(result)) {}
+
+	std::vector<LLVMValuePtr *> LLVMLoad::getOperands() {
+		return {&pointer};
+	}
+
+	std::string LLVMLoad::toString() const {
+		return std::format("{} = load {}, {}", result->toString(), result->getType(), pointer);
+	}
+
+	LLVMStore::LLVMStore(LLVMValuePtr value, LLVMValuePtr pointer):
+		LLVMInstruction(InstructionKind::Store), value(std::move(value)), pointer(std::move(pointer)) {}
+
+	std::vector<LLVMValuePtr *> LLVMStore::getOperands() {
+		return {&value, &pointer};
+	}
+
+	std::string LLVMStore::toString() const {
+		return std::format("store {}, {}", value, pointer);
+	}
+
+	LLVMPhi::LLVMPhi(std::vector<Incoming> incoming, LLVMValuePtr result):
+		LLVMInstruction(InstructionKind::Phi), incoming(std::move(incoming)), result(std::move(result)) {}
+
+	std::vector<LLVMValuePtr *> LLVMPhi::getOperands() {
+		std::vector<LLVMValuePtr *> out;
+		out.reserve(incoming.size());
+		for (auto &[value, predecessor] : incoming)
+			out.push_back(&value);
+		return out;
+	}
+
+	void LLVMPhi::removeIncoming(const BasicBlock &predecessor) {
+		std::erase_if(incoming, [&](const Incoming &pair) { return pair.second.lock().get() == &predecessor; });
+	}
+
+	std::string LLVMPhi::toString() const {
+		assert(!incoming.empty());
+		std::vector<std::string> pairs;
+		pairs.reserve(incoming.size());
+		for (const auto &[value, predecessor] : incoming)
+			pairs.push_back(std::format("[ {}, {} ]", value->toString(), getLabel(predecessor)));
+		return std::format("{} = phi {} {}", result->toString(), result->getType(), join(pairs));
+	}
+
+	LLVMCall::LLVMCall(LLVMTypePtr return_type, std::string callee, std::vector<LLVMValuePtr> arguments, LLVMValuePtr result):
+		LLVMInstruction(InstructionKind::Call), returnType(std::move(return_type)), callee(std::move(callee)), arguments(std::move(arguments)), result(std::move(result)) {}
+
+	std::vector<LLVMValuePtr *> LLVMCall::getOperands() {
+		std::vector<LLVMValuePtr *> out;
+		out.reserve(arguments.size());
+		for (LLVMValuePtr &argument : arguments)
+			out.push_back(&argument);
+		return out;
+	}
+
+	std::string LLVMCall::toString() const {
+		if (!result)
+			return std::format("call {} @{}({})", returnType, callee, join(arguments));
+		return std::format("{} = call {} @{}({})", result->toString(), returnType, callee, join(arguments));
+	}
 }
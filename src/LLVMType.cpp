@@ -9,104 +9,42 @@ namespace mead {
 	}
 
 	LLVMIntType::LLVMIntType(int bit_width):
-		bitWidth(bit_width) {}
-
-	bool LLVMIntType::operator==(const LLVMType &other) const {
-		if (this == &other)
-			return true;
-
-		if (auto *cast = dynamic_cast<const LLVMIntType *>(&other))
-			return cast->bitWidth == bitWidth;
-
-		return false;
-	}
+		LLVMType(LLVMTypeKind::Int), bitWidth(bit_width) {}
 
 	std::format_context::iterator LLVMIntType::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "i{}", bitWidth);
 	}
 
 	LLVMArrayType::LLVMArrayType(int count, LLVMTypePtr subtype):
-		count(count), subtype(std::move(subtype)) {}
-
-	bool LLVMArrayType::operator==(const LLVMType &other) const {
-		if (this == &other)
-			return true;
-
-		if (auto *cast = dynamic_cast<const LLVMArrayType *>(&other))
-			return cast->count == count && *cast->subtype == *subtype;
-
-		return false;
-	}
+		LLVMType(LLVMTypeKind::Array), count(count), subtype(std::move(subtype)) {}
 
 	std::format_context::iterator LLVMArrayType::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "[{} x {}]", count, subtype);
 	}
 
-	LLVMStructType::LLVMStructType(std::vector<LLVMTypeWeakPtr> subtypes):
-		subtypes(std::move(subtypes)) {}
-
-	bool LLVMStructType::operator==(const LLVMType &other) const {
-		if (this == &other)
-			return true;
-
-		if (auto *cast = dynamic_cast<const LLVMStructType *>(&other)) {
-			if (cast->subtypes.size() != subtypes.size())
-				return false;
-
-			for (size_t i = 0; i < subtypes.size(); ++i) {
-				auto subtype = subtypes[i].lock();
-				auto other_subtype = cast->subtypes[i].lock();
-				assert(subtype);
-				assert(other_subtype);
-				if (*subtype != *other_subtype)
-					return false;
-			}
-
-			return true;
-		}
-
-		return false;
-	}
+	LLVMStructType::LLVMStructType(std::vector<LLVMTypePtr> subtypes):
+		LLVMType(LLVMTypeKind::Struct), subtypes(std::move(subtypes)) {}
 
 	std::format_context::iterator LLVMStructType::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "{{{}}}", join(subtypes));
 	}
 
-	LLVMPointerType::LLVMPointerType(LLVMTypePtr subtype):
-		subtype(std::move(subtype)) {}
-
-	bool LLVMPointerType::operator==(const LLVMType &other) const {
-		if (this == &other)
-			return true;
-
-		if (auto *cast = dynamic_cast<const LLVMPointerType *>(&other)) {
-			if (cast->subtype && subtype)
-				return *cast->subtype == *subtype;
-			return !cast->subtype == !subtype;
-		}
-
-		return false;
-	}
+	LLVMPointerType::LLVMPointerType():
+		LLVMType(LLVMTypeKind::Pointer) {}
 
 	std::format_context::iterator LLVMPointerType::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "ptr");
 	}
 
-	LLVMVoidType::LLVMVoidType() = default;
-
-	bool LLVMVoidType::operator==(const LLVMType &other) const {
-		return this == &other || dynamic_cast<const LLVMVoidType *>(&other);
-	}
+	LLVMVoidType::LLVMVoidType():
+		LLVMType(LLVMTypeKind::Void) {}
 
 	std::format_context::iterator LLVMVoidType::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "void");
 	}
 
-	LLVMPoisonType::LLVMPoisonType() = default;
-
-	bool LLVMPoisonType::operator==(const LLVMType &other) const {
-		return this == &other || dynamic_cast<const LLVMPoisonType *>(&other);
-	}
+	LLVMPoisonType::LLVMPoisonType():
+		LLVMType(LLVMTypeKind::Poison) {}
 
 	std::format_context::iterator LLVMPoisonType::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "poison");
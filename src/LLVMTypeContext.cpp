@@ -0,0 +1,53 @@
+#include "mead/LLVMTypeContext.h"
+
+#include <cassert>
+
+namespace mead {
+	LLVMTypeContext::LLVMTypeContext():
+	pointerType(new LLVMPointerType), voidType(new LLVMVoidType), poisonType(new LLVMPoisonType) {
+		for (int bit_width = 1; bit_width <= maxTableWidth; ++bit_width)
+			intTypes[bit_width].reset(new LLVMIntType(bit_width));
+	}
+
+	LLVMTypeContext & LLVMTypeContext::get() {
+		static LLVMTypeContext context;
+		return context;
+	}
+
+	std::shared_ptr<LLVMIntType> LLVMTypeContext::getInt(int bit_width) {
+		assert(0 < bit_width);
+
+		if (bit_width <= maxTableWidth)
+			return intTypes[bit_width];
+
+		std::lock_guard lock(mutex);
+		auto &slot = wideIntTypes[bit_width];
+		if (!slot)
+			slot.reset(new LLVMIntType(bit_width));
+		return slot;
+	}
+
+	std::shared_ptr<LLVMArrayType> LLVMTypeContext::getArray(int count, const LLVMTypePtr &subtype) {
+		assert(subtype);
+		std::lock_guard lock(mutex);
+		auto &slot = arrayTypes[{count, subtype.get()}];
+		if (!slot)
+			slot.reset(new LLVMArrayType(count, subtype));
+		return slot;
+	}
+
+	std::shared_ptr<LLVMStructType> LLVMTypeContext::getStruct(const std::vector<LLVMTypePtr> &subtypes) {
+		std::vector<const LLVMType *> key;
+		key.reserve(subtypes.size());
+		for (const LLVMTypePtr &subtype : subtypes) {
+			assert(subtype);
+			key.push_back(subtype.get());
+		}
+
+		std::lock_guard lock(mutex);
+		auto &slot = structTypes[std::move(key)];
+		if (!slot)
+			slot.reset(new LLVMStructType(subtypes));
+		return slot;
+	}
+}
@@ -1,3 +1,5 @@
+#include "mead/util/Casting.h"
+#include "mead/LLVMTypeContext.h"
 #include "mead/LLVMValue.h"
 #include "mead/Util.h"
 
@@ -12,13 +14,29 @@ namespace mead {
 		return type;
 	}
 
+	LLVMIntValue::LLVMIntValue(uint64_t value, int bit_width):
+		LLVMValue(LLVMValueKind::Int),
+		value(value),
+		type(LLVMTypeContext::get().getInt(bit_width)) {}
+
+	std::string LLVMIntValue::toString() const {
+		const int bit_width = type->bitWidth;
+
+		if (bit_width == 1)
+			return (value & 1)? "true" : "false";
+
+		// LLVM reads integer constants as signed, so sign-extend from the type's width.
+		const int shift = 64 - bit_width;
+		return std::to_string(static_cast<int64_t>(value << shift) >> shift);
+	}
+
 	std::format_context::iterator LLVMIntValue::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "{} {}", static_cast<LLVMType &>(*type), value);
+		return std::format_to(ctx.out(), "{} {}", static_cast<LLVMType &>(*type), toString());
 	}
 
 	LLVMArrayValue::LLVMArrayValue(std::vector<LLVMValuePtr> values, LLVMTypePtr type):
-	values(std::move(values)), type(std::move(type)) {
-		auto *array_type = dynamic_cast<const LLVMArrayType *>(this->type.get());
+	LLVMValue(LLVMValueKind::Array), values(std::move(values)), type(std::move(type)) {
+		auto *array_type = dyn_cast<LLVMArrayType>(this->type.get());
 		if (!array_type)
 			throw std::invalid_argument("LLVMArrayValue type isn't an LLVMArrayType");
 
@@ -32,46 +50,92 @@ namespace mead {
 		return type;
 	}
 
+	std::string LLVMArrayValue::toString() const {
+		return std::format("[{}]", join(values));
+	}
+
 	std::format_context::iterator LLVMArrayValue::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "{} [{}]", type, join(values));
+		return std::format_to(ctx.out(), "{} {}", type, toString());
 	}
 
 	LLVMStructValue::LLVMStructValue(std::vector<LLVMValuePtr> values, LLVMTypePtr type):
-		values(std::move(values)), type(std::move(type)) {}
+		LLVMValue(LLVMValueKind::Struct), values(std::move(values)), type(std::move(type)) {}
 
 	LLVMStructValue::LLVMStructValue(std::vector<LLVMValuePtr> values):
-	values(std::move(values)) {
-		std::vector<LLVMTypeWeakPtr> subtypes;
+	LLVMValue(LLVMValueKind::Struct), values(std::move(values)) {
+		std::vector<LLVMTypePtr> subtypes;
 		subtypes.reserve(this->values.size());
 		for (const LLVMValuePtr &value : this->values)
 			subtypes.push_back(value->getType());
-		type = std::make_shared<LLVMStructType>(std::move(subtypes));
+		type = LLVMTypeContext::get().getStruct(subtypes);
 	}
 
 	LLVMTypePtr LLVMStructValue::getType() const {
 		return type;
 	}
 
+	std::string LLVMStructValue::toString() const {
+		return std::format("{{{}}}", join(values));
+	}
+
 	std::format_context::iterator LLVMStructValue::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "{} {{{}}}", type, join(values));
+		return std::format_to(ctx.out(), "{} {}", type, toString());
 	}
 
 	LLVMGlobalValue::LLVMGlobalValue(std::string name, LLVMTypePtr type):
-		name(std::move(name)), type(std::move(type)) {}
+		LLVMValue(LLVMValueKind::Global), name(std::move(name)), type(std::move(type)) {}
 
 	LLVMTypePtr LLVMGlobalValue::getType() const {
 		return type;
 	}
 
+	std::string LLVMGlobalValue::toString() const {
+		return '@' + name;
+	}
+
 	std::format_context::iterator LLVMGlobalValue::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "{} @{}", type, name);
 	}
 
 	LLVMTypePtr LLVMNullValue::getType() const {
-		return std::make_shared<LLVMPointerType>(nullptr);
+		return LLVMTypeContext::get().getPointer();
+	}
+
+	std::string LLVMNullValue::toString() const {
+		return "null";
 	}
 
 	std::format_context::iterator LLVMNullValue::formatTo(std::format_context &ctx) const {
 		return std::format_to(ctx.out(), "ptr null");
 	}
+
+	LLVMUndefValue::LLVMUndefValue(LLVMTypePtr type):
+		LLVMValue(LLVMValueKind::Undef), type(std::move(type)) {}
+
+	LLVMTypePtr LLVMUndefValue::getType() const {
+		return type;
+	}
+
+	std::string LLVMUndefValue::toString() const {
+		return "undef";
+	}
+
+	std::format_context::iterator LLVMUndefValue::formatTo(std::format_context &ctx) const {
+		return std::format_to(ctx.out(), "{} undef", type);
+	}
+
+	LLVMLocalValue::LLVMLocalValue(std::string name, LLVMTypePtr type):
+		LLVMValue(LLVMValueKind::Local), name(std::move(name)), type(std::move(type)) {}
+
+	LLVMTypePtr LLVMLocalValue::getType() const {
+		return type;
+	}
+
+	std::string LLVMLocalValue::toString() const {
+		return '%' + name;
+	}
+
+	std::format_context::iterator LLVMLocalValue::formatTo(std::format_context &ctx) const {
+		return std::format_to(ctx.out(), "{} %{}", type, name);
+	}
 }
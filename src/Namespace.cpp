@@ -1,16 +1,19 @@
 #include "mead/Function.h"
 #include "mead/Logging.h"
 #include "mead/Namespace.h"
+#include "mead/OverloadSet.h"
 #include "mead/Type.h"
 
 namespace mead {
 	Namespace::Namespace(std::string name, std::weak_ptr<Namespace> parent):
-		Symbol(name), weakParent(std::move(parent)), name(std::move(name)) {}
-
-	std::string Namespace::getFullName() const {
-		if (auto parent = weakParent.lock())
-			return parent->getFullName() + "::" + name;
-		return name;
+	Symbol(name), weakParent(std::move(parent)), name(std::move(name)) {
+		if (auto locked = weakParent.lock()) {
+			fullName = locked->fullName + "::" + this->name;
+			generation = locked->generation;
+		} else {
+			fullName = this->name;
+			generation = std::make_shared<uint64_t>(0);
+		}
 	}
 
 	std::shared_ptr<Namespace> Namespace::getNamespace(const std::string &name, bool create) {
@@ -23,23 +26,30 @@ namespace mead {
 		if (create) {
 			auto new_namespace = std::make_shared<Namespace>(name, weak_from_this());
 			namespaces.emplace(name, new_namespace);
+			invalidateCaches();
 			return new_namespace;
 		}
 
 		return nullptr;
 	}
 
-	std::shared_ptr<Type> Namespace::getType(const std::string &name) const {
-		if (auto iter = types.find(name); iter != types.end())
-			return iter->second;
-		if (auto parent = weakParent.lock())
-			return parent->getType(name);
-		return nullptr;
+	std::shared_ptr<Type> Namespace::getType(const NamespacedName &name) const {
+		return resolve(name, typeCache, &Namespace::types);
+	}
+
+	std::shared_ptr<Function> Namespace::getFunction(const NamespacedName &name) const {
+		std::shared_ptr<const OverloadSet> overloads = getOverloads(name);
+		return overloads? overloads->getOnly() : nullptr;
+	}
+
+	std::shared_ptr<const OverloadSet> Namespace::getOverloads(const NamespacedName &name) const {
+		return resolve(name, functionCache, &Namespace::functions);
 	}
 
 	bool Namespace::insertType(const std::string &name, const std::shared_ptr<Type> &type) {
 		if (types.emplace(name, type).second) {
 			allSymbols[name] = type;
+			invalidateCaches();
 			return true;
 		}
 
@@ -47,11 +57,64 @@ namespace mead {
 	}
 
 	bool Namespace::insertFunction(const std::string &name, const std::shared_ptr<Function> &function) {
-		if (functions.emplace(name, function).second) {
+		std::shared_ptr<OverloadSet> &overloads = functions[name];
+
+		// Lookups resolve names to whole sets, so only a new set can change what they find.
+		if (!overloads) {
+			overloads = std::make_shared<OverloadSet>();
 			allSymbols[name] = function;
-			return true;
+			invalidateCaches();
 		}
 
-		return false;
+		return overloads->insert(function);
+	}
+
+	void Namespace::invalidateCaches() {
+		// Lookups from any namespace in the tree may have cached a miss for the new symbol, so they all go stale.
+		++*generation;
+	}
+
+	const Namespace * Namespace::descend(const NamespacedName &name) const {
+		const Namespace *ns = this;
+
+		for (const std::string &component : name.namespaces) {
+			auto iter = ns->namespaces.find(component);
+			if (iter == ns->namespaces.end())
+				return nullptr;
+			ns = iter->second.get();
+		}
+
+		return ns;
+	}
+
+	template <typename T>
+	std::shared_ptr<T> Namespace::resolve(const NamespacedName &name, ResolutionCache<T> &cache, SymbolMap<T> Namespace::*member) const {
+		std::lock_guard lock(cacheMutex);
+
+		if (cacheGeneration != *generation) {
+			typeCache.clear();
+			functionCache.clear();
+			cacheGeneration = *generation;
+		}
+
+		std::string qualified;
+		const std::string &key = name.namespaces.empty()? name.name : (qualified = std::string(name));
+
+		if (auto iter = cache.find(key); iter != cache.end())
+			return iter->second;
+
+		std::shared_ptr<T> found;
+		std::shared_ptr<const Namespace> parent;
+
+		for (const Namespace *ns = this; ns && !found; ns = (parent = ns->weakParent.lock()).get()) {
+			if (const Namespace *target = ns->descend(name)) {
+				const SymbolMap<T> &symbols = target->*member;
+				if (auto iter = symbols.find(name.name); iter != symbols.end())
+					found = iter->second;
+			}
+		}
+
+		cache.emplace(key, found);
+		return found;
 	}
 }
@@ -0,0 +1,149 @@
+#include "mead/util/Casting.h"
+#include "mead/Function.h"
+#include "mead/OverloadSet.h"
+#include "mead/Type.h"
+
+#include <bit>
+
+namespace mead {
+	const Type * OverloadSet::getKeyType(const Type *type) {
+		if (!type || isa<InvalidType>(type))
+			return nullptr;
+
+		if (auto reference = dyn_cast<LReferenceType>(type))
+			type = reference->getSubtype().get();
+
+		return &type->getNonConstVariant();
+	}
+
+	uint64_t OverloadSet::hashKey(std::span<const Type * const> key) {
+		uint64_t hash = 0xcbf29ce484222325 ^ key.size();
+
+		for (const Type *type : key) {
+			hash ^= reinterpret_cast<uintptr_t>(type);
+			hash *= 0x100000001b3;
+			hash ^= hash >> 32;
+		}
+
+		return hash;
+	}
+
+	std::optional<unsigned> OverloadSet::getCost(const Type *argument, const Type &parameter) {
+		constexpr unsigned conversion_cost = 4;
+
+		if (!argument)
+			return conversion_cost;
+
+		if (argument == &parameter)
+			return 0;
+
+		if (auto argument_int = dyn_cast<IntType>(argument)) {
+			auto parameter_int = dyn_cast<IntType>(&parameter);
+			if (!parameter_int)
+				return std::nullopt;
+			// Widening without a change of sign keeps every value, and the narrowest such parameter is the closest.
+			const int from = argument_int->getBitWidth(), to = parameter_int->getBitWidth();
+			if (argument_int->getSigned() == parameter_int->getSigned() && from <= to)
+				return std::countr_zero(static_cast<unsigned>(to / from));
+			return conversion_cost;
+		}
+
+		if (argument->isConvertibleTo(parameter))
+			return conversion_cost;
+		return std::nullopt;
+	}
+
+	bool OverloadSet::insert(std::shared_ptr<Function> function) {
+		Key key;
+		for (const auto &argument_type : function->getArgumentTypes())
+			key.push_back(getKeyType(argument_type.get()));
+
+		const uint64_t hash = hashKey(key);
+		auto [first, last] = exactMatches.equal_range(hash);
+		for (auto iter = first; iter != last; ++iter)
+			if (keys[iter->second] == key)
+				return false;
+
+		exactMatches.emplace(hash, functions.size());
+		functions.push_back(std::move(function));
+		keys.push_back(std::move(key));
+
+		std::lock_guard lock(memoMutex);
+		memo.clear();
+		return true;
+	}
+
+	OverloadSet::Resolution OverloadSet::resolve(std::span<const std::shared_ptr<Type>> argument_types) const {
+		if (functions.size() == 1)
+			return {functions.front()};
+
+		Key key;
+		key.reserve(argument_types.size());
+		for (const auto &argument_type : argument_types)
+			key.push_back(getKeyType(argument_type.get()));
+
+		auto [first, last] = exactMatches.equal_range(hashKey(key));
+		for (auto iter = first; iter != last; ++iter)
+			if (keys[iter->second] == key)
+				return {functions[iter->second]};
+
+		{
+			std::lock_guard lock(memoMutex);
+			if (auto iter = memo.find(key); iter != memo.end())
+				return iter->second;
+		}
+
+		Resolution resolution = rank(key);
+		std::lock_guard lock(memoMutex);
+		memo.emplace(std::move(key), resolution);
+		return resolution;
+	}
+
+	OverloadSet::Resolution OverloadSet::rank(const Key &key) const {
+		struct Viable {
+			size_t index;
+			std::vector<unsigned> costs;
+		};
+
+		std::vector<Viable> viable;
+
+		for (size_t i = 0; i < functions.size(); ++i) {
+			if (keys[i].size() != key.size())
+				continue;
+
+			Viable candidate{i, {}};
+			for (size_t j = 0; j < key.size() && candidate.costs.size() == j; ++j)
+				if (std::optional<unsigned> cost = getCost(key[j], *keys[i][j]))
+					candidate.costs.push_back(*cost);
+
+			if (candidate.costs.size() == key.size())
+				viable.push_back(std::move(candidate));
+		}
+
+		if (viable.empty())
+			return {};
+
+		auto is_at_least_as_good = [](const Viable &lhs, const Viable &rhs) {
+			for (size_t i = 0; i < lhs.costs.size(); ++i)
+				if (rhs.costs[i] < lhs.costs[i])
+					return false;
+			return true;
+		};
+
+		// Whichever candidate survives the pairwise comparisons is the only one that can beat all the others.
+		const Viable *best = &viable.front();
+		for (const Viable &candidate : viable)
+			if (!is_at_least_as_good(*best, candidate) && is_at_least_as_good(candidate, *best))
+				best = &candidate;
+
+		for (const Viable &candidate : viable)
+			if (&candidate != best && (!is_at_least_as_good(*best, candidate) || is_at_least_as_good(candidate, *best)))
+				return {nullptr, true};
+
+		return {functions[best->index]};
+	}
+
+	std::shared_ptr<Function> OverloadSet::getOnly() const {
+		return functions.size() == 1? functions.front() : nullptr;
+	}
+}
@@ -195,23 +195,13 @@ namespace mead {
 			return log.fail("No prototype", tokens, prototype);
 		}
 
-		ParseResult block = takeBlock(tokens);
+		ParseResult block = lazyBodies? skipBlock(tokens) : takeBlock(tokens);
 
 		if (!block) {
 			return log.fail("No block", tokens, block);
 		}
 
-		// Implicit return
-		if (ASTNodePtr block_node = *block; !block_node->empty()) {
-			ASTNodePtr back = block_node->back();
-			if (back->type == NodeType::ExpressionStatement) {
-				assert(back->size() == 1);
-				ASTNodePtr wrapped = std::make_shared<Return>(Token{TokenType::Return, "return", {}});
-				back->front()->reparent(wrapped);
-				wrapped->reparent(block_node);
-				back->removeSelf();
-			}
-		}
+		addImplicitReturn(*block);
 
 		ASTNodePtr node = ASTNode::make(NodeType::FunctionDefinition, (*prototype)->token);
 		(*prototype)->reparent(node);
@@ -221,6 +211,47 @@ namespace mead {
 		return log.success(node);
 	}
 
+	void Parser::addImplicitReturn(const ASTNodePtr &block) {
+		if (block->empty()) {
+			return;
+		}
+
+		ASTNodePtr back = block->back();
+		if (back->type == NodeType::ExpressionStatement) {
+			assert(back->size() == 1);
+			ASTNodePtr wrapped = std::make_shared<Return>(Token{TokenType::Return, "return", {}});
+			back->front()->reparent(wrapped);
+			wrapped->reparent(block);
+			back->removeSelf();
+		}
+	}
+
+	std::optional<Token> Parser::loadBody(ASTNode &definition) {
+		assert(definition.type == NodeType::FunctionDefinition);
+		const ASTNodePtr &placeholder = definition.at(1);
+
+		auto iter = skippedBodies.find(placeholder.get());
+		if (iter == skippedBodies.end()) {
+			return std::nullopt;
+		}
+
+		std::span<const Token> tokens = iter->second;
+		skippedBodies.erase(iter);
+
+		ParseResult block = takeBlock(tokens);
+		if (!block) {
+			return block.error().second;
+		}
+
+		// Other nodes may already refer to the placeholder, so the parsed statements move into it.
+		while (!(*block)->empty()) {
+			(*block)->front()->reparent(placeholder);
+		}
+
+		addImplicitReturn(placeholder);
+		return std::nullopt;
+	}
+
 	ParseResult Parser::takeIdentifier(std::span<const Token> &tokens) {
 		auto log = logger("takeIdentifier");
 
@@ -342,6 +373,32 @@ namespace mead {
 		return log.success(node);
 	}
 
+	ParseResult Parser::skipBlock(std::span<const Token> &tokens) {
+		auto log = logger("skipBlock");
+		const std::span<const Token> start = tokens;
+
+		if (!take(tokens, TokenType::OpeningBrace)) {
+			return log.fail("No '{'", tokens);
+		}
+
+		for (size_t depth = 1; depth != 0; tokens = tokens.subspan(1)) {
+			if (tokens.empty()) {
+				tokens = start;
+				return log.fail("No matching '}'", start);
+			}
+
+			if (tokens.front().type == TokenType::OpeningBrace) {
+				++depth;
+			} else if (tokens.front().type == TokenType::ClosingBrace) {
+				--depth;
+			}
+		}
+
+		ASTNodePtr node = std::make_shared<Block>(start.front());
+		skippedBodies.emplace(node.get(), start.first(start.size() - tokens.size()));
+		return log.success(node);
+	}
+
 	ParseResult Parser::takeStatement(std::span<const Token> &tokens) {
 		auto log = logger("takeStatement");
 
@@ -420,7 +477,7 @@ namespace mead {
 			}
 
 			name.emplace(std::move(namespaces), pieces.back()->token.value);
-			node = std::make_shared<TypeNode>(saver->at((pieces.size() - 1) * 2));
+			node = std::make_shared<TypeNode>(saver->at((pieces.size() - 1) * 2), *name);
 
 			if (pieces.size() == 1) {
 				if (!typeDB.contains(name.value())) {
@@ -429,35 +486,41 @@ namespace mead {
 			}
 		}
 
-		std::vector<bool> pointer_consts;
-		bool is_const = false;
-		bool is_reference = false;
+		// The base type isn't resolved until the type is used, so only the qualifiers are filled in here.
+		QualifiedType qualified;
 		bool ref_found = false;
 
 		if (include_qualifiers) {
 			for (;;) {
 				if (const Token *token = take(tokens, TokenType::Const)) {
 					node->add(NodeType::Const, *token);
+					qualified = qualified.withConst(true);
 					if (const Token *star = take(tokens, TokenType::Star)) {
+						if (qualified.pointerLevel() == QualifiedType::maxPointerLevel) {
+							return log.fail("Too many levels of pointers", tokens);
+						}
+
 						node->add(NodeType::Pointer, *star);
-						pointer_consts.push_back(true);
+						qualified = qualified.pointerTo();
 					} else if (const Token *ampersand = take(tokens, TokenType::Ampersand)) {
 						node->add(NodeType::LReference, *ampersand);
-						is_const = true;
-						is_reference = true;
+						qualified = qualified.referenceTo();
 						ref_found = true;
 					}
 				} else if (const Token *star = take(tokens, TokenType::Star)) {
+					if (qualified.pointerLevel() == QualifiedType::maxPointerLevel) {
+						return log.fail("Too many levels of pointers", tokens);
+					}
+
 					node->add(NodeType::Pointer, *star);
-					pointer_consts.push_back(false);
+					qualified = qualified.pointerTo();
 				} else if (const Token *ampersand = take(tokens, TokenType::Ampersand)) {
 					if (ref_found) {
 						return log.fail("Ref already found", tokens);
 					}
 
 					node->add(NodeType::LReference, *ampersand);
-					is_const = false;
-					is_reference = true;
+					qualified = qualified.referenceTo();
 					ref_found = true;
 				} else {
 					break;
@@ -466,15 +529,7 @@ namespace mead {
 		}
 
 		if (type_out) {
-			if (!name) {
-				name.emplace(std::vector<std::string>{}, node->token.value);
-			}
-
-			// TypePtr type = Type::make(std::move(name.value()));
-			// typeDB.insert(type);
-			// *type_out = QualifiedType(std::move(pointer_consts), is_const, is_reference, std::move(type));
-
-			*type_out = QualifiedType(std::move(pointer_consts), is_const, is_reference, nullptr);
+			*type_out = qualified;
 		}
 
 		for (const ASTNodePtr &piece : pieces) {
@@ -0,0 +1,199 @@
+#include "mead/util/ThreadPool.h"
+#include "mead/BasicBlock.h"
+#include "mead/DominatorTree.h"
+#include "mead/Function.h"
+#include "mead/PassManager.h"
+
+#include <cassert>
+#include <format>
+#include <future>
+#include <print>
+
+namespace {
+	struct Size {
+		size_t instructions = 0;
+		size_t blocks = 0;
+	};
+
+	Size measure(const mead::Function &function) {
+		Size out;
+		for (const auto &block : function.getBlocks()) {
+			++out.blocks;
+			for ([[maybe_unused]] const mead::Instruction &instruction : block->getInstructions())
+				++out.instructions;
+		}
+		return out;
+	}
+
+	Size measure(std::span<const mead::FunctionPtr> functions) {
+		Size out;
+		for (const mead::FunctionPtr &function : functions) {
+			const Size size = measure(*function);
+			out.instructions += size.instructions;
+			out.blocks += size.blocks;
+		}
+		return out;
+	}
+
+	void record(mead::PassManager::PassStatistics &statistics, std::chrono::nanoseconds time, Size before, Size after) {
+		++statistics.runs;
+		statistics.time += time;
+		statistics.instructionsBefore += before.instructions;
+		statistics.instructionsAfter  += after.instructions;
+		statistics.blocksBefore += before.blocks;
+		statistics.blocksAfter  += after.blocks;
+	}
+}
+
+namespace mead {
+	const std::vector<BasicBlock *> & FunctionAnalyses::getReversePostOrder() {
+		return function.getReversePostOrder();
+	}
+
+	const DominatorTree & FunctionAnalyses::getDominatorTree() {
+		return function.getDominatorTree();
+	}
+
+	const DominatorTree & FunctionAnalyses::getPostDominatorTree() {
+		return function.getPostDominatorTree();
+	}
+
+	UseLists & FunctionAnalyses::getUses() {
+		if (!uses)
+			uses = std::make_unique<UseLists>(function);
+		return *uses;
+	}
+
+	void FunctionAnalyses::invalidate(AnalysisSet preserved) {
+		// The function keeps the control flow analyses itself, so that code outside a pipeline can use them too.
+		if (!preserved.contains(Analysis::ControlFlow))
+			function.invalidateControlFlow();
+		if (!preserved.contains(Analysis::Uses))
+			uses.reset();
+	}
+
+	FunctionAnalyses & ModuleAnalyses::get(Function &function) {
+		std::unique_ptr<FunctionAnalyses> &analyses = functions[&function];
+		if (!analyses)
+			analyses = std::make_unique<FunctionAnalyses>(function);
+		return *analyses;
+	}
+
+	void ModuleAnalyses::invalidate(AnalysisSet preserved) {
+		for (auto &[function, analyses] : functions)
+			analyses->invalidate(preserved);
+	}
+
+	void PassManager::add(std::unique_ptr<FunctionPass> pass) {
+		assert(pass);
+		statistics.push_back({.name = std::string(pass->getName())});
+		pipeline.push_back({.functionPass = std::move(pass)});
+	}
+
+	void PassManager::add(std::unique_ptr<ModulePass> pass) {
+		assert(pass);
+		statistics.push_back({.name = std::string(pass->getName())});
+		pipeline.push_back({.modulePass = std::move(pass)});
+	}
+
+	void PassManager::run(std::span<const FunctionPtr> functions, ThreadPool &pool) {
+		if (pipeline.empty() || functions.empty())
+			return;
+
+		ModuleAnalyses analyses;
+
+		for (size_t i = 0; i < pipeline.size();) {
+			if (ModulePass *pass = pipeline[i].modulePass.get()) {
+				const Size before = measure(functions);
+				const auto start = std::chrono::steady_clock::now();
+				const AnalysisSet preserved = pass->run(functions, analyses);
+				const auto time = std::chrono::steady_clock::now() - start;
+
+				analyses.invalidate(preserved);
+				record(statistics[i], time, before, measure(functions));
+				++i;
+				continue;
+			}
+
+			size_t last = i + 1;
+			while (last < pipeline.size() && pipeline[last].functionPass)
+				++last;
+
+			runStage(i, last, functions, analyses, pool);
+			i = last;
+		}
+	}
+
+	void PassManager::runStage(size_t first, size_t last, std::span<const FunctionPtr> functions, ModuleAnalyses &analyses, ThreadPool &pool) {
+		// Each task measures its own function, and the measurements are added up afterwards so the tasks share nothing.
+		using Measurements = std::vector<PassStatistics>;
+		std::vector<std::future<Measurements>> tasks;
+		tasks.reserve(functions.size());
+
+		for (const FunctionPtr &function : functions) {
+			// Looked up here because the lookup can insert.
+			FunctionAnalyses &function_analyses = analyses.get(*function);
+
+			tasks.push_back(pool.submit([this, first, last, &function = *function, &function_analyses] {
+				Measurements out(last - first);
+				Size before = measure(function);
+
+				for (size_t i = first; i < last; ++i) {
+					const auto start = std::chrono::steady_clock::now();
+					const AnalysisSet preserved = pipeline[i].functionPass->run(function, function_analyses);
+					const auto time = std::chrono::steady_clock::now() - start;
+
+					function_analyses.invalidate(preserved);
+
+					const Size after = measure(function);
+					record(out[i - first], time, before, after);
+					before = after;
+				}
+
+				return out;
+			}));
+		}
+
+		// Every task has to finish before an exception from one of them can leave this function.
+		for (const std::future<Measurements> &task : tasks)
+			task.wait();
+
+		for (std::future<Measurements> &task : tasks) {
+			Measurements measurements = task.get();
+			for (size_t i = first; i < last; ++i) {
+				const PassStatistics &measured = measurements[i - first];
+				PassStatistics &total = statistics[i];
+				total.runs += measured.runs;
+				total.time += measured.time;
+				total.instructionsBefore += measured.instructionsBefore;
+				total.instructionsAfter  += measured.instructionsAfter;
+				total.blocksBefore += measured.blocksBefore;
+				total.blocksAfter  += measured.blocksAfter;
+			}
+		}
+	}
+
+	void PassManager::resetStatistics() {
+		for (PassStatistics &pass : statistics)
+			pass = {.name = std::move(pass.name)};
+	}
+
+	void PassManager::printReport(std::ostream &stream) const {
+		auto delta = [](size_t before, size_t after) {
+			const auto difference = static_cast<long long>(after) - static_cast<long long>(before);
+			return std::format("{} -> {} ({:+})", before, after, difference);
+		};
+
+		std::println(stream, "{:<24} {:>8} {:>12}  {:<32} {}", "Pass", "Runs", "Time (ms)", "Instructions", "Blocks");
+		std::chrono::nanoseconds total{0};
+
+		for (const PassStatistics &pass : statistics) {
+			const double milliseconds = std::chrono::duration<double, std::milli>(pass.time).count();
+			std::println(stream, "{:<24} {:>8} {:>12.3f}  {:<32} {}", pass.name, pass.runs, milliseconds,
+				delta(pass.instructionsBefore, pass.instructionsAfter), delta(pass.blocksBefore, pass.blocksAfter));
+			total += pass.time;
+		}
+
+		std::println(stream, "{:<24} {:>8} {:>12.3f}", "Total", "", std::chrono::duration<double, std::milli>(total).count());
+	}
+}
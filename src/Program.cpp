@@ -1,23 +1,32 @@
+#include "mead/Diagnostics.h"
 #include "mead/Namespace.h"
 #include "mead/Program.h"
 #include "mead/Scope.h"
+#include "mead/SymbolTable.h"
 #include "mead/Type.h"
+#include "mead/TypeContext.h"
 
 namespace mead {
 	Program::Program():
-		globalNamespace(std::make_shared<Namespace>("")) {}
+		globalNamespace(std::make_shared<Namespace>("")),
+		symbolTable(std::make_shared<SymbolTable>()),
+		typeContext(std::make_shared<TypeContext>()),
+		diagnostics(std::make_shared<DiagnosticEngine>()) {}
 
 	void Program::init() {
-		globalScope = std::make_shared<Scope>(weak_from_this());
+		globalScope = std::make_shared<Scope>(weak_from_this(), symbolTable);
 		Namespace &global = *globalNamespace;
 
 		for (bool is_signed : {true, false}) {
 			for (int bit_width : {8, 16, 32, 64}) {
 				std::string name = std::format("{}{}", is_signed? 'i' : 'u', bit_width);
-				bool inserted = global.insertType(name, std::make_shared<IntType>(bit_width, is_signed));
+				bool inserted = global.insertType(name, typeContext->getInt(bit_width, is_signed));
 				assert(inserted);
 			}
 		}
+
+		bool inserted = global.insertType("void", typeContext->getVoid());
+		assert(inserted);
 	}
 
 	std::shared_ptr<Namespace> Program::getGlobalNamespace() const {
@@ -27,4 +36,12 @@ namespace mead {
 	std::shared_ptr<Scope> Program::getGlobalScope() const {
 		return globalScope;
 	}
+
+	TypeContext & Program::getTypeContext() const {
+		return *typeContext;
+	}
+
+	DiagnosticEngine & Program::getDiagnostics() const {
+		return *diagnostics;
+	}
 }
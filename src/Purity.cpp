@@ -0,0 +1,226 @@
+#include "mead/node/FunctionCall.h"
+#include "mead/node/Identifier.h"
+#include "mead/util/Casting.h"
+#include "mead/ASTNode.h"
+#include "mead/CallGraph.h"
+#include "mead/Function.h"
+#include "mead/Namespace.h"
+#include "mead/OverloadSet.h"
+#include "mead/Program.h"
+#include "mead/Purity.h"
+#include "mead/Scope.h"
+#include "mead/Type.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace mead {
+	namespace {
+		struct Local {
+			std::string name;
+			/** Reading or writing through a reference touches memory the function doesn't own. */
+			bool isReference = false;
+		};
+
+		bool isReferenceType(const ASTNode &type_node) {
+			return std::ranges::any_of(type_node, [](const ASTNodePtr &child) { return child->type == NodeType::LReference; });
+		}
+
+		/** Works out the purity of a function's body, treating calls to functions in the same component as pure. */
+		class PurityWalker {
+			private:
+				const CallGraph &graph;
+				const CallGraph::Component &component;
+				const Namespace &ns;
+				std::vector<Local> locals;
+				Purity purity = Purity::Pure;
+
+				const Local * findLocal(const std::string &name) const {
+					for (auto iter = locals.rbegin(); iter != locals.rend(); ++iter)
+						if (iter->name == name)
+							return &*iter;
+					return nullptr;
+				}
+
+				void join(Purity other) {
+					purity = std::max(purity, other);
+				}
+
+				/** Whether assigning to the node only changes a local of the function's own. */
+				bool isOwnLocal(const ASTNode &target) const {
+					auto identifier = dyn_cast<Identifier>(&target);
+					if (!identifier)
+						return false;
+					const Local *local = findLocal(identifier->getIdentifier());
+					return local && !local->isReference;
+				}
+
+				/** The call could be to any of the overloads, since they aren't resolved yet. */
+				Purity getCalleePurity(const FunctionCall &call) const {
+					std::shared_ptr<const OverloadSet> overloads = call.getOverloads(ns);
+					if (!overloads)
+						return Purity::Impure;
+
+					Purity out = Purity::Pure;
+
+					for (const FunctionPtr &callee : overloads->getFunctions()) {
+						// A returned reference is read through.
+						if (isa<LReferenceType>(callee->getReturnType()))
+							out = std::max(out, Purity::ReadOnly);
+
+						const CallGraph::Node *node = graph.find(*callee);
+						if (!node || node->component != component.index)
+							out = std::max(out, callee->getPurity());
+					}
+
+					return out;
+				}
+
+			public:
+				PurityWalker(const CallGraph &graph, const CallGraph::Component &component, const Namespace &ns):
+					graph(graph), component(component), ns(ns) {}
+
+				Purity walk(const Function &function) {
+					const ASTNode &definition = *function.getDefinition();
+					const ASTNode &prototype = *definition.front();
+					const auto &argument_types = function.getArgumentTypes();
+
+					locals.clear();
+					purity = Purity::Pure;
+
+					for (size_t i = 2; i < prototype.size(); ++i) {
+						auto identifier = cast<Identifier>(prototype.at(i)->at(0).get());
+						locals.push_back({identifier->getIdentifier(), isa<LReferenceType>(argument_types.at(i - 2))});
+					}
+
+					enum class Action {Visit, Declare, PopScope};
+
+					struct Step {
+						Action action;
+						const ASTNode *node;
+						/** For PopScope, how many locals there were when the scope started. */
+						size_t localCount = 0;
+					};
+
+					std::vector<Step> stack{{Action::Visit, definition.at(1).get()}};
+
+					while (!stack.empty() && purity != Purity::Impure) {
+						const Step step = stack.back();
+						stack.pop_back();
+
+						if (step.action == Action::PopScope) {
+							locals.resize(step.localCount);
+							continue;
+						}
+
+						const ASTNode &node = *step.node;
+
+						if (step.action == Action::Declare) {
+							auto identifier = cast<Identifier>(node.at(0).get());
+							locals.push_back({identifier->getIdentifier(), isReferenceType(*node.at(1))});
+							continue;
+						}
+
+						auto push = [&](const ASTNode &child) {
+							stack.push_back({Action::Visit, &child});
+						};
+
+						switch (node.type) {
+							case NodeType::Type:
+								continue;
+
+							case NodeType::Block:
+								stack.push_back({Action::PopScope, &node, locals.size()});
+								for (auto iter = node.children.rbegin(); iter != node.children.rend(); ++iter)
+									push(**iter);
+								continue;
+
+							case NodeType::VariableDeclaration:
+								stack.push_back({Action::Declare, &node});
+								continue;
+
+							case NodeType::VariableDefinition:
+								// The name isn't in scope in its own initializer.
+								stack.push_back({Action::Declare, node.at(0).get()});
+								push(*node.at(1));
+								continue;
+
+							case NodeType::Identifier: {
+								const Local *local = findLocal(cast<Identifier>(&node)->getIdentifier());
+								if (!local || local->isReference)
+									join(Purity::ReadOnly);
+								continue;
+							}
+
+							case NodeType::Assign:
+							case NodeType::CompoundAssign:
+								if (!isOwnLocal(*node.at(0))) {
+									join(Purity::Impure);
+									continue;
+								}
+								push(*node.at(1));
+								continue;
+
+							case NodeType::PrefixIncrement:
+							case NodeType::PrefixDecrement:
+							case NodeType::PostfixIncrement:
+							case NodeType::PostfixDecrement:
+								if (!isOwnLocal(*node.front()))
+									join(Purity::Impure);
+								continue;
+
+							case NodeType::GetAddress:
+								// Taking a variable's address doesn't read it.
+								if (!isa<Identifier>(node.front().get()))
+									push(*node.front());
+								continue;
+
+							case NodeType::Deref:
+							case NodeType::Subscript:
+							case NodeType::AccessMember:
+								join(Purity::ReadOnly);
+								break;
+
+							case NodeType::SingleNew:
+							case NodeType::ArrayNew:
+							case NodeType::Delete:
+								join(Purity::Impure);
+								continue;
+
+							case NodeType::FunctionCall: {
+								auto call = cast<FunctionCall>(&node);
+								join(getCalleePurity(*call));
+								push(*call->getArgs());
+								continue;
+							}
+
+							default:
+								break;
+						}
+
+						for (auto iter = node.children.rbegin(); iter != node.children.rend(); ++iter)
+							push(**iter);
+					}
+
+					return purity;
+				}
+		};
+	}
+
+	void inferPurity(const CallGraph &graph, ThreadPool &pool) {
+		graph.forEachBottomUp(pool, [&](const CallGraph::Component &component) {
+			const auto &nodes = graph.getNodes();
+			const Namespace &ns = *nodes[component.members.front()].function->getScope()->getProgram()->getGlobalNamespace();
+			PurityWalker walker(graph, component, ns);
+			Purity purity = Purity::Pure;
+
+			// A component's functions can all reach each other, so each can do whatever any of them does.
+			for (const size_t member : component.members)
+				purity = std::max(purity, walker.walk(*nodes[member].function));
+
+			for (const size_t member : component.members)
+				nodes[member].function->setPurity(purity);
+		});
+	}
+}
@@ -1,12 +1,106 @@
+#include "mead/util/Casting.h"
 #include "mead/QualifiedType.h"
+#include "mead/TypeContext.h"
+
+#include <cassert>
 
 namespace mead {
 	QualifiedType::QualifiedType() = default;
 
-	QualifiedType::QualifiedType(std::vector<bool> pointer_consts, bool is_const, bool is_reference, TypePtr type):
-		pointerConsts(std::move(pointer_consts)), isConst(is_const), isReference(is_reference), type(std::move(type)) {}
+	QualifiedType::QualifiedType(TypePtr base, uint64_t const_mask, uint8_t pointer_levels, bool is_reference, bool is_reference_const):
+		base(std::move(base)), constMask(const_mask), pointerLevels(pointer_levels), isReference(is_reference), isReferenceConst(is_reference_const) {}
+
+	QualifiedType::QualifiedType(const TypePtr &type) {
+		if (!type)
+			return;
+
+		assert(type->isInterned());
+		const Type *level = type.get();
+
+		if (const auto *reference = dyn_cast<LReferenceType>(level)) {
+			isReference = true;
+			isReferenceConst = reference->getConst();
+			level = reference->getSubtype().get();
+		}
+
+		// Walk inwards, collecting the outermost pointer's constness first, then shift the bits into place once the
+		// depth is known.
+		uint64_t reversed = 0;
+		while (const auto *pointer = dyn_cast<PointerType>(level)) {
+			assert(pointerLevels < maxPointerLevel);
+			reversed |= uint64_t(pointer->getConst()) << pointerLevels++;
+			level = pointer->getSubtype().get();
+		}
+
+		for (size_t i = 0; i < pointerLevels; ++i)
+			constMask |= ((reversed >> i) & 1) << (pointerLevels - i);
+
+		constMask |= uint64_t(level->getConst());
+		// The interned non-const variant is already known, so the base can be found without asking the context.
+		base = std::const_pointer_cast<Type>(level->nonConstVariant->shared_from_this());
+	}
+
+	bool QualifiedType::getConst() const {
+		return isReference? isReferenceConst : isConstAt(pointerLevels);
+	}
+
+	QualifiedType QualifiedType::withConst(bool is_const) const {
+		if (isReference)
+			return {base, constMask, pointerLevels, true, is_const};
+
+		const uint64_t bit = uint64_t(1) << pointerLevels;
+		return {base, is_const? constMask | bit : constMask & ~bit, pointerLevels, false, false};
+	}
+
+	QualifiedType QualifiedType::pointerTo(bool is_const) const {
+		assert(pointerLevels < maxPointerLevel);
+		const uint8_t levels = pointerLevels + 1;
+		return {base, constMask | (uint64_t(is_const) << levels), levels, false, false};
+	}
+
+	QualifiedType QualifiedType::referenceTo(bool is_const) const {
+		return {base, constMask, pointerLevels, true, is_const};
+	}
+
+	QualifiedType QualifiedType::withoutReference() const {
+		return {base, constMask, pointerLevels, false, false};
+	}
+
+	std::optional<QualifiedType> QualifiedType::dereference() const {
+		if (isReference || pointerLevels == 0)
+			return std::nullopt;
+
+		const uint8_t levels = pointerLevels - 1;
+		return QualifiedType(base, constMask & ~(uint64_t(1) << pointerLevels), levels, true, false);
+	}
+
+	bool QualifiedType::isExactlyEquivalent(const QualifiedType &other, bool ignore_const) const {
+		if (base != other.base || pointerLevels != other.pointerLevels || isReference != other.isReference)
+			return false;
+
+		if (!ignore_const)
+			return *this == other;
+
+		if (isReference)
+			return constMask == other.constMask;
+
+		const uint64_t outer = uint64_t(1) << pointerLevels;
+		return (constMask & ~outer) == (other.constMask & ~outer);
+	}
+
+	TypePtr QualifiedType::getType() const {
+		if (!base)
+			return nullptr;
+
+		TypeContext &context = base->getContext();
+		TypePtr type = isConstAt(0)? base->withConst(true) : base;
+
+		for (size_t level = 1; level <= pointerLevels; ++level)
+			type = context.getPointer(type, isConstAt(level));
+
+		if (isReference)
+			type = context.getLReference(type, isReferenceConst);
 
-	size_t QualifiedType::pointerLevel() const {
-		return pointerConsts.size();
+		return type;
 	}
 }
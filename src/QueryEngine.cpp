@@ -0,0 +1,117 @@
+#include "mead/QueryEngine.h"
+
+namespace mead {
+	std::string_view getQueryKindName(QueryKind kind) {
+		switch (kind) {
+			case QueryKind::SourceText: return "SourceText";
+			case QueryKind::Chunks:     return "Chunks";
+			case QueryKind::Items:      return "Items";
+			case QueryKind::ItemText:   return "ItemText";
+			case QueryKind::ItemStart:  return "ItemStart";
+			case QueryKind::ItemTokens: return "ItemTokens";
+			case QueryKind::ItemAST:    return "ItemAST";
+			case QueryKind::References: return "References";
+			case QueryKind::Signature:  return "Signature";
+			case QueryKind::MangledName: return "MangledName";
+			case QueryKind::Purities:   return "Purities";
+			case QueryKind::ItemPurity: return "ItemPurity";
+			case QueryKind::GlobalConstant: return "GlobalConstant";
+			case QueryKind::FunctionIR: return "FunctionIR";
+			case QueryKind::Globals:    return "Globals";
+			case QueryKind::Module:     return "Module";
+			default: return "?";
+		}
+	}
+
+	QueryEngine::Record * QueryEngine::findRecord(QueryKind kind, const std::string &key) {
+		auto iter = records.find(std::make_pair(kind, key));
+		return iter == records.end()? nullptr : iter->second.get();
+	}
+
+	QueryEngine::Record & QueryEngine::addRecord(QueryKind kind, const std::string &key, std::function<Computed()> compute) {
+		auto record = std::make_unique<Record>();
+		record->kind = kind;
+		record->compute = std::move(compute);
+		return *records.emplace(std::make_pair(kind, key), std::move(record)).first->second;
+	}
+
+	void QueryEngine::read(Record &record) {
+		refresh(record);
+		if (!frames.empty())
+			frames.back().push_back(&record);
+	}
+
+	void QueryEngine::refresh(Record &record) {
+		QueryStats &kind_stats = stats[static_cast<size_t>(record.kind)];
+
+		if (record.isInput || record.verifiedAt == revision) {
+			++kind_stats.hits;
+			return;
+		}
+
+		if (!record.result.value) {
+			++kind_stats.misses;
+			execute(record);
+			record.changedAt = revision;
+			return;
+		}
+
+		bool is_stale = false;
+
+		for (Record *dependency : record.dependencies) {
+			refresh(*dependency);
+			if (record.verifiedAt < dependency->changedAt) {
+				is_stale = true;
+				break;
+			}
+		}
+
+		if (!is_stale) {
+			++kind_stats.validations;
+			record.verifiedAt = revision;
+			return;
+		}
+
+		++kind_stats.recomputations;
+		const Fingerprint::Value old_fingerprint = record.result.fingerprint;
+		execute(record);
+
+		if (record.result.fingerprint == old_fingerprint)
+			++kind_stats.cutoffs;
+		else
+			record.changedAt = revision;
+	}
+
+	void QueryEngine::execute(Record &record) {
+		assert(!record.isActive && "Query cycle");
+		record.isActive = true;
+		frames.emplace_back();
+
+		record.result = record.compute();
+
+		record.dependencies = std::move(frames.back());
+		frames.pop_back();
+		record.isActive = false;
+		record.verifiedAt = revision;
+	}
+
+	void QueryEngine::resetStats() {
+		stats = {};
+	}
+
+	std::string QueryEngine::statsToString() const {
+		std::string out;
+
+		for (size_t i = 0; i < queryKindCount; ++i) {
+			const QueryStats &kind_stats = stats[i];
+			if (kind_stats.hits + kind_stats.validations + kind_stats.misses + kind_stats.recomputations == 0)
+				continue;
+
+			out += std::format("{}: {} hits, {} validations, {} misses, {} recomputations ({} cut off)\n",
+				getQueryKindName(static_cast<QueryKind>(i)), kind_stats.hits, kind_stats.validations, kind_stats.misses,
+				kind_stats.recomputations, kind_stats.cutoffs);
+		}
+
+		return out;
+	}
+}
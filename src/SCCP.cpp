@@ -0,0 +1,486 @@
+#include "mead/util/Casting.h"
+#include "mead/BasicBlock.h"
+#include "mead/Function.h"
+#include "mead/GlobalPool.h"
+#include "mead/LLVMInstruction.h"
+#include "mead/SCCP.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace mead {
+	namespace {
+		/** What's known about a value: nothing yet, that it's always one constant, or that it can vary. A value only
+		 *  ever moves down that list. */
+		struct LatticeValue {
+			enum class State {Unknown, Constant, Overdefined};
+
+			State state = State::Unknown;
+			/** Truncated to the value's width. */
+			uint64_t value = 0;
+
+			static LatticeValue overdefined() { return {State::Overdefined}; }
+			static LatticeValue constant(uint64_t value) { return {State::Constant, value}; }
+
+			bool operator==(const LatticeValue &) const = default;
+
+			/** Combines what two ways of reaching a value say about it. */
+			LatticeValue meet(const LatticeValue &other) const {
+				if (state == State::Unknown)
+					return other;
+				if (other.state == State::Unknown || *this == other)
+					return *this;
+				return overdefined();
+			}
+		};
+
+		/** Returns zero for values that aren't integers, and for integers too wide to evaluate. */
+		int getWidth(const LLVMValue &value) {
+			auto type = dyn_cast<LLVMIntType>(value.getType().get());
+			return type && type->bitWidth <= 64? type->bitWidth : 0;
+		}
+
+		uint64_t getMask(int width) {
+			return width == 64? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+		}
+
+		int64_t toSigned(uint64_t value, int width) {
+			const uint64_t sign = uint64_t{1} << (width - 1);
+			return static_cast<int64_t>(((value & getMask(width)) ^ sign) - sign);
+		}
+
+		bool compare(LLVMPredicate predicate, uint64_t lhs, uint64_t rhs, int width) {
+			const int64_t signed_lhs = toSigned(lhs, width);
+			const int64_t signed_rhs = toSigned(rhs, width);
+
+			switch (predicate) {
+				case LLVMPredicate::Eq:  return lhs == rhs;
+				case LLVMPredicate::Ne:  return lhs != rhs;
+				case LLVMPredicate::Slt: return signed_lhs <  signed_rhs;
+				case LLVMPredicate::Sle: return signed_lhs <= signed_rhs;
+				case LLVMPredicate::Sgt: return signed_lhs >  signed_rhs;
+				case LLVMPredicate::Sge: return signed_lhs >= signed_rhs;
+				case LLVMPredicate::Ult: return lhs <  rhs;
+				case LLVMPredicate::Ule: return lhs <= rhs;
+				case LLVMPredicate::Ugt: return lhs >  rhs;
+				case LLVMPredicate::Uge: return lhs >= rhs;
+			}
+
+			assert(!"Invalid predicate");
+			return false;
+		}
+
+		/** Returns nothing if LLVM doesn't define the result. */
+		std::optional<uint64_t> evaluate(const LLVMThreeReg &instruction, uint64_t lhs, uint64_t rhs, int width) {
+			const uint64_t mask = getMask(width);
+			const uint64_t sign = uint64_t{1} << (width - 1);
+			const int64_t signed_lhs = toSigned(lhs, width);
+			const int64_t signed_rhs = toSigned(rhs, width);
+
+			switch (instruction.getOpcode()) {
+				case LLVMOpcode::Add: return (lhs + rhs) & mask;
+				case LLVMOpcode::Sub: return (lhs - rhs) & mask;
+				case LLVMOpcode::Mul: return (lhs * rhs) & mask;
+				case LLVMOpcode::And: return lhs & rhs;
+				case LLVMOpcode::Or:  return lhs | rhs;
+				case LLVMOpcode::Xor: return lhs ^ rhs;
+
+				case LLVMOpcode::UDiv:
+				case LLVMOpcode::URem:
+					if (rhs == 0)
+						return std::nullopt;
+					return instruction.getOpcode() == LLVMOpcode::UDiv? lhs / rhs : lhs % rhs;
+
+				case LLVMOpcode::SDiv:
+				case LLVMOpcode::SRem:
+					if (rhs == 0 || (lhs == sign && signed_rhs == -1))
+						return std::nullopt;
+					return static_cast<uint64_t>(instruction.getOpcode() == LLVMOpcode::SDiv? signed_lhs / signed_rhs : signed_lhs % signed_rhs) & mask;
+
+				case LLVMOpcode::Shl:
+				case LLVMOpcode::LShr:
+				case LLVMOpcode::AShr:
+					// Shifting by the width or more gives poison.
+					if (rhs >= static_cast<uint64_t>(width))
+						return std::nullopt;
+					if (instruction.getOpcode() == LLVMOpcode::Shl)
+						return (lhs << rhs) & mask;
+					if (instruction.getOpcode() == LLVMOpcode::LShr)
+						return lhs >> rhs;
+					return static_cast<uint64_t>(signed_lhs >> rhs) & mask;
+
+				case LLVMOpcode::Icmp:
+					return compare(cast<LLVMIcmp>(&instruction)->getPredicate(), lhs, rhs, width);
+			}
+
+			assert(!"Invalid opcode");
+			return std::nullopt;
+		}
+
+		/** Finds what can run and what every value in it is. */
+		class Solver {
+			private:
+				const UseLists &uses;
+				const GlobalPool *globals;
+				std::unordered_map<const LLVMValue *, LatticeValue> values;
+				/** By block id. */
+				std::vector<bool> executable;
+				/** The blocks with an edge that can be taken to each block, by block id. */
+				std::vector<std::vector<const BasicBlock *>> executablePredecessors;
+				std::vector<std::pair<BasicBlock *, BasicBlock *>> edgeWorklist;
+				std::vector<LLVMInstruction *> instructionWorklist;
+
+				void markEdge(BasicBlock &from, const std::weak_ptr<BasicBlock> &weak_to) {
+					BasicBlock *to = weak_to.lock().get();
+					assert(to);
+					edgeWorklist.emplace_back(&from, to);
+				}
+
+				void set(const LLVMValuePtr &result, LatticeValue value) {
+					LatticeValue &old = values[result.get()];
+					if (old == value)
+						return;
+					assert(old.state < value.state || old.state == LatticeValue::State::Unknown);
+					old = value;
+					for (const UseLists::Use &use : uses.getUses(*result))
+						instructionWorklist.push_back(use.user);
+				}
+
+				void visitEdge(BasicBlock &from, BasicBlock &to) {
+					auto &predecessors = executablePredecessors[to.getId()];
+					if (std::ranges::find(predecessors, &from) != predecessors.end())
+						return;
+					predecessors.push_back(&from);
+
+					if (!executable[to.getId()]) {
+						executable[to.getId()] = true;
+						for (Instruction &instruction : to.getInstructions())
+							visit(*cast<LLVMInstruction>(&instruction));
+						return;
+					}
+
+					// Only the phis can change because of the new edge. They come first.
+					for (Instruction &instruction : to.getInstructions()) {
+						auto phi = dyn_cast<LLVMPhi>(&instruction);
+						if (!phi)
+							break;
+						visit(*phi);
+					}
+				}
+
+				void visit(LLVMInstruction &instruction) {
+					BasicBlock &block = *instruction.getParent();
+					if (!executable[block.getId()])
+						return;
+
+					if (auto phi = dyn_cast<LLVMPhi>(&instruction)) {
+						const auto &predecessors = executablePredecessors[block.getId()];
+						LatticeValue value;
+						for (const auto &[incoming, weak_predecessor] : phi->getIncoming())
+							if (std::ranges::find(predecessors, weak_predecessor.lock().get()) != predecessors.end())
+								value = value.meet(get(incoming));
+						set(phi->getResult(), value);
+						return;
+					}
+
+					if (auto three_reg = dyn_cast<LLVMThreeReg>(&instruction)) {
+						const int width = getWidth(*three_reg->getLeft());
+						const LatticeValue lhs = get(three_reg->getLeft());
+						const LatticeValue rhs = get(three_reg->getRight());
+
+						if (width == 0 || lhs.state == LatticeValue::State::Overdefined || rhs.state == LatticeValue::State::Overdefined) {
+							set(three_reg->getResult(), LatticeValue::overdefined());
+						} else if (lhs.state == LatticeValue::State::Constant && rhs.state == LatticeValue::State::Constant) {
+							std::optional<uint64_t> result = evaluate(*three_reg, lhs.value, rhs.value, width);
+							set(three_reg->getResult(), result? LatticeValue::constant(*result) : LatticeValue::overdefined());
+						}
+						return;
+					}
+
+					if (auto cast_instruction = dyn_cast<LLVMCast>(&instruction)) {
+						const int from_width = getWidth(*cast_instruction->getValue());
+						const int to_width = getWidth(*cast_instruction->getResult());
+						const LatticeValue operand = get(cast_instruction->getValue());
+
+						if (from_width == 0 || to_width == 0 || operand.state == LatticeValue::State::Overdefined) {
+							set(cast_instruction->getResult(), LatticeValue::overdefined());
+						} else if (operand.state == LatticeValue::State::Constant) {
+							uint64_t result = operand.value;
+							if (cast_instruction->getCastKind() == LLVMCastKind::SExt)
+								result = static_cast<uint64_t>(toSigned(result, from_width));
+							set(cast_instruction->getResult(), LatticeValue::constant(result & getMask(to_width)));
+						}
+						return;
+					}
+
+					if (auto branch = dyn_cast<LLVMBr>(&instruction)) {
+						markEdge(block, branch->getDestination());
+						return;
+					}
+
+					if (auto branch = dyn_cast<LLVMCondBr>(&instruction)) {
+						const LatticeValue condition = get(branch->getCondition());
+						if (condition.state == LatticeValue::State::Constant) {
+							markEdge(block, condition.value? branch->getIfTrue() : branch->getIfFalse());
+						} else if (condition.state == LatticeValue::State::Overdefined) {
+							markEdge(block, branch->getIfTrue());
+							markEdge(block, branch->getIfFalse());
+						}
+						return;
+					}
+
+					if (auto load = dyn_cast<LLVMLoad>(&instruction); load && globals) {
+						if (auto global = dyn_cast<LLVMGlobalValue>(load->getPointer().get())) {
+							LLVMValuePtr constant = globals->getConstant(global->getName());
+							if (constant && constant->getType() == load->getResult()->getType()) {
+								set(load->getResult(), get(constant));
+								return;
+							}
+						}
+					}
+
+					// Anything else that defines a value, like a call or another load, isn't evaluated.
+					if (LLVMValuePtr result = instruction.getResult())
+						set(result, LatticeValue::overdefined());
+				}
+
+			public:
+				Solver(const Function &function, const UseLists &uses, const GlobalPool *globals):
+					uses(uses), globals(globals), executable(function.getBlockIdCount()), executablePredecessors(function.getBlockIdCount()) {}
+
+				LatticeValue get(const LLVMValuePtr &value) const {
+					if (auto int_value = dyn_cast<LLVMIntValue>(value.get()))
+						if (const int width = getWidth(*int_value))
+							return LatticeValue::constant(int_value->getValue() & getMask(width));
+
+					if (auto iter = values.find(value.get()); iter != values.end())
+						return iter->second;
+
+					// Parameters, globals and undef can be anything. Results of instructions just haven't been reached.
+					return uses.getDefinition(*value)? LatticeValue{} : LatticeValue::overdefined();
+				}
+
+				inline bool isExecutable(const BasicBlock &block) const { return executable[block.getId()]; }
+
+				inline bool isExecutable(const BasicBlock &from, const BasicBlock &to) const {
+					const auto &predecessors = executablePredecessors[to.getId()];
+					return std::ranges::find(predecessors, &from) != predecessors.end();
+				}
+
+				void solve(const Function &function) {
+					BasicBlock &entry = *function.getBlocks().front();
+					executable[entry.getId()] = true;
+					for (Instruction &instruction : entry.getInstructions())
+						visit(*cast<LLVMInstruction>(&instruction));
+
+					for (;;) {
+						while (!edgeWorklist.empty() || !instructionWorklist.empty()) {
+							while (!edgeWorklist.empty()) {
+								auto [from, to] = edgeWorklist.back();
+								edgeWorklist.pop_back();
+								visitEdge(*from, *to);
+							}
+
+							while (!instructionWorklist.empty()) {
+								LLVMInstruction *instruction = instructionWorklist.back();
+								instructionWorklist.pop_back();
+								visit(*instruction);
+							}
+						}
+
+						// A condition can stay unknown if it only depends on values that never get one, like a phi
+						// that only merges itself. Either way could be taken then, so both edges are. The condition
+						// keeps its value, since values only move down the lattice and it could still become constant.
+						bool resolved = false;
+						auto take = [&](BasicBlock &from, const std::weak_ptr<BasicBlock> &to) {
+							if (!isExecutable(from, *to.lock())) {
+								markEdge(from, to);
+								resolved = true;
+							}
+						};
+
+						for (const auto &block : function.getBlocks()) {
+							if (!executable[block->getId()] || !block->isTerminated())
+								continue;
+							auto branch = dyn_cast<LLVMCondBr>(&block->getInstructions().back());
+							if (branch && get(branch->getCondition()).state == LatticeValue::State::Unknown) {
+								take(*block, branch->getIfTrue());
+								take(*block, branch->getIfFalse());
+							}
+						}
+
+						if (!resolved)
+							return;
+					}
+				}
+		};
+	}
+
+	AnalysisSet SCCP::run(Function &function, FunctionAnalyses &analyses) const {
+		const auto &blocks = function.getBlocks();
+		if (blocks.empty())
+			return AnalysisSet::all();
+
+		// The solver only knows LLVM instructions.
+		for (const auto &block : blocks)
+			for (const Instruction &instruction : block->getInstructions())
+				if (!isa<LLVMInstruction>(&instruction))
+					return AnalysisSet::all();
+
+		UseLists &uses = analyses.getUses();
+		Solver solver(function, uses, globals);
+		solver.solve(function);
+
+		bool values_changed = false;
+		bool control_flow_changed = false;
+		// Instructions whose results may have lost their last use.
+		std::vector<LLVMInstruction *> orphans;
+
+		// Called before an instruction stops using its operands.
+		auto release = [&](LLVMInstruction &instruction) {
+			for (LLVMValuePtr *operand : instruction.getOperands())
+				if (LLVMInstruction *definition = *operand? uses.getDefinition(**operand) : nullptr)
+					if (solver.isExecutable(*definition->getParent()))
+						orphans.push_back(definition);
+		};
+
+		auto erase = [&](LLVMInstruction &instruction) {
+			release(instruction);
+			uses.forget(instruction);
+			instruction.getParent()->remove(instruction);
+		};
+
+		auto remove_incoming = [&](BasicBlock &block, const BasicBlock &predecessor) {
+			for (Instruction &instruction : block.getInstructions()) {
+				auto phi = dyn_cast<LLVMPhi>(&instruction);
+				if (!phi)
+					break;
+				release(*phi);
+				uses.forget(*phi);
+				phi->removeIncoming(predecessor);
+				uses.add(*phi);
+			}
+		};
+
+		// Instructions with constant results compute nothing else, so they can go once their uses are replaced.
+		for (const auto &block : blocks) {
+			if (!solver.isExecutable(*block))
+				continue;
+
+			auto &instructions = block->getInstructions();
+			for (auto iter = instructions.begin(); iter != instructions.end();) {
+				auto &instruction = *cast<LLVMInstruction>(iter.get());
+				++iter;
+
+				const LLVMValuePtr result = instruction.getResult();
+				if (!result || solver.get(result).state != LatticeValue::State::Constant)
+					continue;
+
+				assert(isa<LLVMThreeReg>(&instruction) || isa<LLVMCast>(&instruction) || isa<LLVMPhi>(&instruction) || isa<LLVMLoad>(&instruction));
+				uses.replaceAllUses(*result, std::make_shared<LLVMIntValue>(solver.get(result).value, getWidth(*result)));
+				erase(instruction);
+				values_changed = true;
+			}
+		}
+
+		// A conditional branch that can only go one way becomes an unconditional one.
+		for (const auto &block : blocks) {
+			if (!solver.isExecutable(*block) || !block->isTerminated())
+				continue;
+
+			auto branch = dyn_cast<LLVMCondBr>(&block->getInstructions().back());
+			if (!branch)
+				continue;
+
+			const std::shared_ptr<BasicBlock> if_true = branch->getIfTrue().lock();
+			const std::shared_ptr<BasicBlock> if_false = branch->getIfFalse().lock();
+			const bool true_taken = solver.isExecutable(*block, *if_true);
+			const bool false_taken = solver.isExecutable(*block, *if_false);
+
+			if (!true_taken && !false_taken)
+				continue;
+			if (if_true != if_false && true_taken && false_taken)
+				continue;
+
+			const std::shared_ptr<BasicBlock> &taken = true_taken? if_true : if_false;
+			const std::shared_ptr<BasicBlock> &not_taken = true_taken? if_false : if_true;
+
+			erase(*branch);
+			uses.add(*block->add<LLVMBr>(taken));
+
+			if (not_taken != taken) {
+				remove_incoming(*not_taken, *block);
+				block->disconnect(*not_taken);
+			}
+
+			control_flow_changed = true;
+		}
+
+		// Blocks that can't run are removed along with everything they send to phis.
+		std::vector<std::shared_ptr<BasicBlock>> dead_blocks;
+		for (const auto &block : blocks)
+			if (!solver.isExecutable(*block))
+				dead_blocks.push_back(block);
+
+		for (const std::shared_ptr<BasicBlock> &block : dead_blocks) {
+			for (BasicBlock *successor : block->getSuccessors())
+				if (solver.isExecutable(*successor))
+					remove_incoming(*successor, *block);
+
+			for (Instruction &instruction : block->getInstructions()) {
+				release(*cast<LLVMInstruction>(&instruction));
+				uses.forget(*cast<LLVMInstruction>(&instruction));
+			}
+
+			function.removeBlock(*block);
+			control_flow_changed = true;
+		}
+
+		// Phis left with a single incoming value don't merge anything anymore.
+		if (control_flow_changed) {
+			for (const auto &block : blocks) {
+				auto &instructions = block->getInstructions();
+				for (auto iter = instructions.begin(); iter != instructions.end();) {
+					auto phi = dyn_cast<LLVMPhi>(iter.get());
+					if (!phi)
+						break;
+					++iter;
+
+					if (phi->getIncoming().size() == 1) {
+						uses.replaceAllUses(*phi->getResult(), phi->getIncoming().front().first);
+						erase(*phi);
+					}
+				}
+			}
+		}
+
+		// What only fed the folded code is dead now, unless it has an effect of its own.
+		while (!orphans.empty()) {
+			LLVMInstruction &instruction = *orphans.back();
+			orphans.pop_back();
+
+			// Already erased.
+			if (!instruction.getParent())
+				continue;
+
+			const LLVMValuePtr result = instruction.getResult();
+			if (!result || uses.hasUses(*result))
+				continue;
+
+			if (isa<LLVMThreeReg>(&instruction) || isa<LLVMCast>(&instruction) || isa<LLVMPhi>(&instruction) || isa<LLVMLoad>(&instruction)) {
+				erase(instruction);
+				values_changed = true;
+			}
+		}
+
+		if (control_flow_changed)
+			return {Analysis::Uses};
+		if (values_changed)
+			return {Analysis::ControlFlow, Analysis::Uses};
+		return AnalysisSet::all();
+	}
+}
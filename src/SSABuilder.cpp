@@ -0,0 +1,177 @@
+#include "mead/util/Casting.h"
+#include "mead/BasicBlock.h"
+#include "mead/Function.h"
+#include "mead/LLVMInstruction.h"
+#include "mead/SSABuilder.h"
+#include "mead/Type.h"
+#include "mead/Variable.h"
+
+#include <cassert>
+#include <format>
+
+namespace mead {
+	namespace {
+		/** Whether two values are certainly the same, which for constants doesn't need them to be the same object. */
+		bool isSameValue(const LLVMValuePtr &lhs, const LLVMValuePtr &rhs) {
+			if (lhs == rhs)
+				return true;
+			auto lhs_int = dyn_cast<LLVMIntValue>(lhs.get());
+			auto rhs_int = dyn_cast<LLVMIntValue>(rhs.get());
+			return lhs_int && rhs_int && lhs_int->getType() == rhs_int->getType() && lhs_int->getValue() == rhs_int->getValue();
+		}
+	}
+
+	void SSABuilder::reserve(const BasicBlock &block) {
+		if (block.getId() < definitions.size())
+			return;
+		const size_t size = block.getId() + 1;
+		definitions.resize(size);
+		sealed.resize(size);
+		incompletePhis.resize(size);
+	}
+
+	LLVMValuePtr SSABuilder::resolve(LLVMValuePtr value) const {
+		for (auto iter = replacements.find(value.get()); iter != replacements.end(); iter = replacements.find(value.get()))
+			value = iter->second;
+		return value;
+	}
+
+	void SSABuilder::write(const Variable &variable, BasicBlock &block, LLVMValuePtr value) {
+		reserve(block);
+		definitions[block.getId()][&variable] = std::move(value);
+	}
+
+	LLVMValuePtr SSABuilder::read(const Variable &variable, BasicBlock &block) {
+		reserve(block);
+		auto &block_definitions = definitions[block.getId()];
+		if (auto iter = block_definitions.find(&variable); iter != block_definitions.end())
+			return iter->second = resolve(iter->second);
+		return readRecursive(variable, block);
+	}
+
+	LLVMPhi & SSABuilder::addPhi(const Variable &variable, BasicBlock &block) {
+		auto result = std::make_shared<LLVMLocalValue>(std::format("{}.phi.{}", variable.getName(), nextPhi++), variable.getType()->toLLVM());
+		const auto &instructions = block.getInstructions();
+		LLVMPhi *phi = instructions.empty()? block.add<LLVMPhi>(std::vector<LLVMPhi::Incoming>{}, result) : block.insertBefore<LLVMPhi>(instructions.front(), std::vector<LLVMPhi::Incoming>{}, result);
+		phis.emplace(result.get(), phi);
+		return *phi;
+	}
+
+	LLVMValuePtr SSABuilder::readRecursive(const Variable &variable, BasicBlock &block) {
+		// Chains of blocks with one predecessor are followed without recursing, since they can be long.
+		std::vector<BasicBlock *> chain{&block};
+		LLVMValuePtr value;
+
+		for (;;) {
+			BasicBlock &current = *chain.back();
+			reserve(current);
+			const auto &predecessors = current.getPredecessors();
+
+			if (auto iter = definitions[current.getId()].find(&variable); chain.size() > 1 && iter != definitions[current.getId()].end()) {
+				value = resolve(iter->second);
+				chain.pop_back();
+				break;
+			}
+
+			if (!sealed[current.getId()]) {
+				LLVMPhi &phi = addPhi(variable, current);
+				incompletePhis[current.getId()].emplace_back(&variable, &phi);
+				value = phi.getResult();
+				break;
+			}
+
+			if (predecessors.size() == 1) {
+				chain.push_back(predecessors.front());
+				continue;
+			}
+
+			if (predecessors.empty()) {
+				value = std::make_shared<LLVMUndefValue>(variable.getType()->toLLVM());
+				break;
+			}
+
+			// Defining the phi first ends cycles through the block's predecessors.
+			LLVMPhi &phi = addPhi(variable, current);
+			write(variable, current, phi.getResult());
+			value = addPhiOperands(variable, phi);
+			break;
+		}
+
+		for (BasicBlock *current : chain)
+			write(variable, *current, value);
+
+		return value;
+	}
+
+	LLVMValuePtr SSABuilder::addPhiOperands(const Variable &variable, LLVMPhi &phi) {
+		BasicBlock &block = *phi.getParent();
+
+		for (BasicBlock *predecessor : block.getPredecessors()) {
+			LLVMValuePtr value = read(variable, *predecessor);
+			if (phis.contains(value.get()))
+				phiUsers[value.get()].push_back(&phi);
+			phi.addIncoming(std::move(value), predecessor->weak_from_this());
+		}
+
+		return tryRemoveTrivialPhi(phi);
+	}
+
+	LLVMValuePtr SSABuilder::tryRemoveTrivialPhi(LLVMPhi &phi) {
+		const LLVMValuePtr result = phi.getResult();
+		LLVMValuePtr same;
+
+		for (const auto &[incoming, predecessor] : phi.getIncoming()) {
+			LLVMValuePtr value = resolve(incoming);
+			if (value == result || (same && isSameValue(value, same)))
+				continue;
+			// It merges at least two values, so it stays.
+			if (same)
+				return result;
+			same = std::move(value);
+		}
+
+		// Only reachable from the entry through itself, or not at all.
+		if (!same)
+			same = std::make_shared<LLVMUndefValue>(result->getType());
+
+		replacements.emplace(result.get(), same);
+		phis.erase(result.get());
+		phi.getParent()->remove(phi);
+
+		// Phis that used this one may have just become trivial too.
+		if (auto iter = phiUsers.find(result.get()); iter != phiUsers.end()) {
+			std::vector<LLVMPhi *> users = std::move(iter->second);
+			phiUsers.erase(iter);
+			for (LLVMPhi *user : users)
+				if (user != &phi && phis.contains(user->getResult().get()))
+					tryRemoveTrivialPhi(*user);
+		}
+
+		return resolve(same);
+	}
+
+	void SSABuilder::seal(BasicBlock &block) {
+		reserve(block);
+		assert(!sealed[block.getId()]);
+
+		std::vector<std::pair<const Variable *, LLVMPhi *>> incomplete = std::move(incompletePhis[block.getId()]);
+		incompletePhis[block.getId()].clear();
+		for (auto &[variable, phi] : incomplete)
+			addPhiOperands(*variable, *phi);
+
+		sealed[block.getId()] = true;
+	}
+
+	void SSABuilder::finish(Function &function) {
+		if (replacements.empty())
+			return;
+
+		for (const auto &block : function.getBlocks()) {
+			assert(block->getId() >= sealed.size() || sealed[block->getId()]);
+			for (Instruction &instruction : block->getInstructions())
+				if (auto llvm_instruction = dyn_cast<LLVMInstruction>(&instruction))
+					for (LLVMValuePtr *operand : llvm_instruction->getOperands())
+						*operand = resolve(*operand);
+		}
+	}
+}
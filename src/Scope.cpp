@@ -1,14 +1,17 @@
-#include "mead/Logging.h"
 #include "mead/Scope.h"
+#include "mead/SymbolTable.h"
 
 #include <cassert>
 
 namespace mead {
-	Scope::Scope(std::weak_ptr<Program> program):
-		weakProgram(std::move(program)), depth(-1) {}
+	Scope::Scope(std::weak_ptr<Program> program, std::shared_ptr<SymbolTable> symbols):
+		symbols(std::move(symbols)), weakProgram(std::move(program)), depth(-1), isOpen(true) {}
 
 	Scope::Scope(const std::shared_ptr<Scope> &parent):
-		weakProgram(parent->weakProgram), weakParent(parent), depth(parent->depth + 1) {}
+		symbols(parent->symbols), outer(parent->outer), weakProgram(parent->weakProgram), weakParent(parent), depth(parent->depth + 1) {}
+
+	Scope::Scope(const std::shared_ptr<Scope> &parent, std::shared_ptr<SymbolTable> symbols):
+		symbols(std::move(symbols)), outer(parent.get()), weakProgram(parent->weakProgram), weakParent(parent), depth(parent->depth + 1) {}
 
 	std::shared_ptr<Program> Scope::getProgram() const {
 		auto program = weakProgram.lock();
@@ -17,14 +20,18 @@ namespace mead {
 	}
 
 	std::shared_ptr<Variable> Scope::getVariable(const std::string &name) const {
-		if (auto iter = variables.find(name); iter != variables.end())
-			return iter->second;
-		return {};
+		assert(isOpen);
+		if (VariablePtr variable = symbols->lookup(name, depth))
+			return variable;
+		return outer? outer->getVariable(name) : nullptr;
 	}
 
 	bool Scope::insertVariable(const std::string &name, std::shared_ptr<Variable> variable) {
-		INFO("Inserting variable {} with name {} into scope of depth {}", variable, name, depth);
-		return variables.emplace(name, std::move(variable)).second;
+		assert(isOpen);
+		if (!symbols->push(name, *this, variable))
+			return false;
+		variables.emplace_back(name, std::move(variable));
+		return true;
 	}
 
 	std::shared_ptr<Scope> Scope::addScope() {
@@ -32,4 +39,20 @@ namespace mead {
 		subscopes.emplace_back(out);
 		return out;
 	}
+
+	void Scope::open() {
+		assert(!isOpen);
+		isOpen = true;
+		for (const auto &[name, variable] : variables) {
+			const bool pushed = symbols->push(name, *this, variable);
+			assert(pushed);
+		}
+	}
+
+	void Scope::close() {
+		assert(isOpen);
+		isOpen = false;
+		for (auto iter = variables.rbegin(); iter != variables.rend(); ++iter)
+			symbols->pop(iter->first, *this);
+	}
 }
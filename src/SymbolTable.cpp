@@ -0,0 +1,50 @@
+#include "mead/Scope.h"
+#include "mead/SymbolTable.h"
+
+#include <cassert>
+
+namespace mead {
+	bool SymbolTable::push(const std::string &name, const Scope &scope, std::shared_ptr<Variable> variable) {
+		std::vector<Binding> &stack = bindings[name];
+
+		// Usually the scope is the innermost one and this stays at the end.
+		auto position = stack.end();
+		while (position != stack.begin() && scope.getDepth() < std::prev(position)->depth)
+			--position;
+
+		if (position != stack.begin() && std::prev(position)->scope == &scope)
+			return false;
+
+		stack.insert(position, {&scope, scope.getDepth(), std::move(variable)});
+		return true;
+	}
+
+	void SymbolTable::pop(const std::string &name, const Scope &scope) {
+		auto iter = bindings.find(name);
+		assert(iter != bindings.end());
+		std::vector<Binding> &stack = iter->second;
+
+		for (auto binding = stack.rbegin(); binding != stack.rend(); ++binding) {
+			if (binding->scope == &scope) {
+				// Empty stacks are kept: the same names tend to be declared again by the next scope.
+				stack.erase(std::next(binding).base());
+				return;
+			}
+		}
+
+		assert(!"Binding not found");
+	}
+
+	std::shared_ptr<Variable> SymbolTable::lookup(const std::string &name, ssize_t depth) const {
+		auto iter = bindings.find(name);
+		if (iter == bindings.end())
+			return nullptr;
+
+		const std::vector<Binding> &stack = iter->second;
+		for (auto binding = stack.rbegin(); binding != stack.rend(); ++binding)
+			if (binding->depth <= depth)
+				return binding->variable;
+
+		return nullptr;
+	}
+}
@@ -10,4 +10,23 @@ namespace mead {
 
 	Token::Token(TokenType type, std::string value, SourceLocation location):
 		type(type), value(std::move(value)), location(location) {}
+
+	TokenType getCompoundOperator(TokenType type) {
+		switch (type) {
+			using enum TokenType;
+			case PlusAssign:            return Plus;
+			case MinusAssign:           return Minus;
+			case StarAssign:            return Star;
+			case SlashAssign:           return Slash;
+			case PercentAssign:         return Percent;
+			case LeftShiftAssign:       return LeftShift;
+			case RightShiftAssign:      return RightShift;
+			case AmpersandAssign:       return Ampersand;
+			case XorAssign:             return Xor;
+			case PipeAssign:            return Pipe;
+			case DoubleAmpersandAssign: return DoubleAmpersand;
+			case DoublePipeAssign:      return DoublePipe;
+			default:                    return Invalid;
+		}
+	}
 }
@@ -1,17 +1,32 @@
+#include "mead/util/Casting.h"
+#include "mead/LLVMTypeContext.h"
 #include "mead/Logging.h"
 #include "mead/Namespace.h"
 #include "mead/Type.h"
+#include "mead/TypeContext.h"
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 namespace mead {
-	Type::Type(std::string name, bool is_const):
-		Symbol(std::move(name)), isConst(is_const) {}
+	Type::Type(TypeKind kind, std::string name, bool is_const):
+		Symbol(std::move(name)), kind(kind), isConst(is_const) {}
 
 	const char * Type::getConstSuffix() const {
 		return isConst? " const" : "";
 	}
 
+	const std::string & Type::getName() const {
+		std::call_once(nameFlag, [this] { cachedName = getNameImpl(); });
+		return cachedName;
+	}
+
+	const std::string & Type::getMangledName() const {
+		std::call_once(mangledNameFlag, [this] { cachedMangledName = (isConst? "K" : "") + getMangledNameImpl(); });
+		return cachedMangledName;
+	}
+
 	Type::operator std::string() const {
 		return std::format("{}", *this);
 	}
@@ -20,14 +35,38 @@ namespace mead {
 		return isConst;
 	}
 
-	void Type::setConst(bool value) {
-		isConst = value;
+	TypePtr Type::withConst(bool value) const {
+		return getContext().withConst(*this, value);
+	}
+
+	TypeContext & Type::getContext() const {
+		assert(context);
+		return *context;
+	}
+
+	bool Type::isExactlyEquivalent(const Type &other, bool ignore_const) const {
+		// Interned types are equivalent exactly when they're the same object.
+		if (context && context == other.context)
+			return ignore_const? nonConstVariant == other.nonConstVariant : this == &other;
+
+		return isExactlyEquivalentImpl(other, ignore_const);
 	}
 
 	bool Type::isConvertibleTo(const Type &other) const {
 		if (this == &other)
 			return true;
 
+		// Integer conversions are a table lookup, which is cheaper than the context's memo.
+		if (kind == TypeKind::Int && other.kind == TypeKind::Int)
+			return intConversions[cast<IntType>(*this).getId()][cast<IntType>(other).getId()];
+
+		if (context && context == other.context)
+			return context->isConvertible(*this, other);
+
+		return isConvertibleToImpl(other);
+	}
+
+	bool Type::isConvertibleToImpl(const Type &other) const {
 		return isExactlyEquivalent(other, true);
 	}
 
@@ -39,139 +78,132 @@ namespace mead {
 		return nullptr;
 	}
 
+	std::format_context::iterator Type::formatTo(std::format_context &ctx) const {
+		const std::string &name = getName();
+		return std::copy(name.begin(), name.end(), ctx.out());
+	}
+
 	char IntType::getPrefix() const {
 		return isSigned? 'i' : 'u';
 	}
 
 	IntType::IntType(int bit_width, bool is_signed, bool is_const):
-		Type(getPrefix() + std::to_string(bit_width), is_const), bitWidth(bit_width), isSigned(is_signed) {}
+		Type(TypeKind::Int, {}, is_const), bitWidth(bit_width), isSigned(is_signed), id(getIntTypeId(bit_width, is_signed)) {}
 
 	std::string IntType::getNameImpl() const {
-		return std::format("{}{}{}", getPrefix(), bitWidth, getConstSuffix());
-	}
-
-	std::string IntType::getName() const {
-		return getNameImpl();
+		return getPrefix() + std::to_string(bitWidth) + getConstSuffix();
 	}
 
-	TypePtr IntType::copy() const {
-		return std::make_shared<IntType>(*this);
+	std::string IntType::getMangledNameImpl() const {
+		// The Itanium encodings of what <cstdint>'s fixed-width types are on LP64: signed char, unsigned char, short,
+		// unsigned short, int, unsigned int, long and unsigned long, so that C++ can link against mead functions.
+		switch (bitWidth) {
+			case 8:  return isSigned? "a" : "h";
+			case 16: return isSigned? "s" : "t";
+			case 32: return isSigned? "i" : "j";
+			case 64: return isSigned? "l" : "m";
+			default: return std::format("{}{}_", isSigned? "DB" : "DU", bitWidth);
+		}
 	}
 
-	bool IntType::isExactlyEquivalent(const Type &other, bool ignore_const) const {
+	bool IntType::isExactlyEquivalentImpl(const Type &other, bool ignore_const) const {
 		if (this == &other)
 			return true;
 
 		if (!ignore_const && getConst() != other.getConst())
 			return false;
 
-		if (const auto *cast = dynamic_cast<const IntType *>(&other))
+		if (const auto *cast = dyn_cast<IntType>(&other))
 			return cast->bitWidth == bitWidth && cast->isSigned == isSigned;
 
 		return false;
 	}
 
-	LLVMTypePtr IntType::toLLVM() const {
-		return std::make_shared<LLVMIntType>(bitWidth);
+	bool IntType::isConvertibleToImpl(const Type &other) const {
+		if (const auto *cast = dyn_cast<IntType>(&other))
+			return intConversions[id][cast->id];
+		return false;
 	}
 
-	std::format_context::iterator IntType::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "{}{}{}", getPrefix(), bitWidth, getConstSuffix());
+	LLVMTypePtr IntType::toLLVM() const {
+		return LLVMTypeContext::get().getInt(bitWidth);
 	}
 
 	VoidType::VoidType(bool is_const):
-		Type("void", is_const) {}
+		Type(TypeKind::Void, {}, is_const) {}
 
-	std::string VoidType::getName() const {
+	std::string VoidType::getNameImpl() const {
 		return "void";
 	}
 
-	TypePtr VoidType::copy() const {
-		return std::make_shared<VoidType>();
+	std::string VoidType::getMangledNameImpl() const {
+		return "v";
 	}
 
-	bool VoidType::isExactlyEquivalent(const Type &other, bool ignore_const) const {
-		return this == &other || ((ignore_const || getConst() == other.getConst()) && dynamic_cast<const VoidType *>(&other));
+	bool VoidType::isExactlyEquivalentImpl(const Type &other, bool ignore_const) const {
+		return this == &other || ((ignore_const || getConst() == other.getConst()) && dyn_cast<VoidType>(&other));
 	}
 
 	LLVMTypePtr VoidType::toLLVM() const {
-		return std::make_shared<LLVMVoidType>();
-	}
-
-	std::format_context::iterator VoidType::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "void");
+		return LLVMTypeContext::get().getVoid();
 	}
 
 	PointerType::PointerType(const TypePtr &subtype, bool is_const):
-		Type(getNameImpl(), is_const), subtype(subtype->unwrapLReference()) {}
+		Type(TypeKind::Pointer, {}, is_const), subtype(subtype->unwrapLReference()) {}
 
 	std::string PointerType::getNameImpl() const {
-		return std::format("{}*{}", subtype, getConstSuffix());
+		return std::format("{}*{}", *subtype, getConstSuffix());
 	}
 
-	std::string PointerType::getName() const {
-		return getNameImpl();
+	std::string PointerType::getMangledNameImpl() const {
+		return "P" + subtype->getMangledName();
 	}
 
-	TypePtr PointerType::copy() const {
-		assert(subtype);
-		return std::make_shared<PointerType>(subtype);
-	}
-
-	bool PointerType::isExactlyEquivalent(const Type &other, bool ignore_const) const {
+	bool PointerType::isExactlyEquivalentImpl(const Type &other, bool ignore_const) const {
 		if (this == &other)
 			return true;
 
 		if (!ignore_const && getConst() != other.getConst())
 			return false;
 
-		if (const auto *cast = dynamic_cast<const PointerType *>(&other))
+		if (const auto *cast = dyn_cast<PointerType>(&other))
 			return subtype->isExactlyEquivalent(*cast->subtype, false);
 
 		return false;
 	}
 
-	bool PointerType::isConvertibleTo(const Type &other) const {
+	bool PointerType::isConvertibleToImpl(const Type &other) const {
 		// TODO: class shenanigans
 
 		if (this == &other)
 			return true;
 
-		if (const auto *cast = dynamic_cast<const PointerType *>(&other))
+		if (const auto *cast = dyn_cast<PointerType>(&other))
 			return (!subtype->getConst() || cast->subtype->getConst()) && subtype->isExactlyEquivalent(*cast->subtype, true);
 
 		return false;
 	}
 
 	LLVMTypePtr PointerType::toLLVM() const {
-		return std::make_shared<LLVMPointerType>(subtype->toLLVM());
+		return LLVMTypeContext::get().getPointer();
 	}
 
 	TypePtr PointerType::dereference() const {
 		return LReferenceType::wrap(subtype);
 	}
 
-	std::format_context::iterator PointerType::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "{}*{}", subtype, getConstSuffix());
-	}
-
 	LReferenceType::LReferenceType(const TypePtr &subtype, bool is_const):
-		Type(getNameImpl(), is_const), subtype(subtype->unwrapLReference()) {}
+		Type(TypeKind::LReference, {}, is_const), subtype(subtype->unwrapLReference()) {}
 
 	std::string LReferenceType::getNameImpl() const {
-		return std::format("{}&{}", subtype, getConstSuffix());
+		return std::format("{}&{}", *subtype, getConstSuffix());
 	}
 
-	std::string LReferenceType::getName() const {
-		return getNameImpl();
+	std::string LReferenceType::getMangledNameImpl() const {
+		return "R" + subtype->getMangledName();
 	}
 
-	TypePtr LReferenceType::copy() const {
-		assert(subtype);
-		return std::make_shared<LReferenceType>(subtype);
-	}
-
-	bool LReferenceType::isExactlyEquivalent(const Type &other, bool ignore_const) const {
+	bool LReferenceType::isExactlyEquivalentImpl(const Type &other, bool ignore_const) const {
 		if (this == &other)
 			return true;
 
@@ -179,19 +211,19 @@ namespace mead {
 		if (!ignore_const && getConst() != other.getConst())
 			return false;
 
-		if (const auto *cast = dynamic_cast<const LReferenceType *>(&other))
+		if (const auto *cast = dyn_cast<LReferenceType>(&other))
 			return subtype->isExactlyEquivalent(*cast->subtype, false);
 
 		return false;
 	}
 
-	bool LReferenceType::isConvertibleTo(const Type &other) const {
+	bool LReferenceType::isConvertibleToImpl(const Type &other) const {
 		// TODO: class shenanigans...?
 
 		if (this == &other)
 			return true;
 
-		if (const auto *cast = dynamic_cast<const LReferenceType *>(&other))
+		if (const auto *cast = dyn_cast<LReferenceType>(&other))
 			return (!subtype->getConst() || cast->subtype->getConst()) && subtype->isExactlyEquivalent(*cast->subtype, true);
 
 		return false;
@@ -199,25 +231,23 @@ namespace mead {
 
 	LLVMTypePtr LReferenceType::toLLVM() const {
 		assert(subtype);
-		return std::make_shared<LLVMPointerType>(subtype->toLLVM());
+		return LLVMTypeContext::get().getPointer();
 	}
 
 	TypePtr LReferenceType::unwrapLReference() {
 		return subtype;
 	}
 
-	std::format_context::iterator LReferenceType::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "{}&{}", subtype, getConstSuffix());
-	}
-
 	std::shared_ptr<LReferenceType> LReferenceType::wrap(const TypePtr &type) {
-		if (auto cast = std::dynamic_pointer_cast<LReferenceType>(type))
-			return cast;
+		if (isa<LReferenceType>(type))
+			return cast<LReferenceType>(type);
+		if (type->isInterned())
+			return type->getContext().getLReference(type);
 		return std::make_shared<LReferenceType>(type);
 	}
 
 	ClassType::ClassType(std::string name, std::weak_ptr<Namespace> owner, bool is_const):
-		Type(std::move(name), is_const), owner(std::move(owner)) {}
+		Type(TypeKind::Class, std::move(name), is_const), owner(std::move(owner)) {}
 
 	Namespace & ClassType::getNamespace() const {
 		auto locked = owner.lock();
@@ -229,22 +259,31 @@ namespace mead {
 		return std::format("{}::{}{}", getNamespace().getFullName(), name, getConstSuffix());
 	}
 
-	std::string ClassType::getName() const {
-		return getNameImpl();
-	}
+	std::string ClassType::getMangledNameImpl() const {
+		// Nested names are N <components> E, where each component is its length followed by its text. The global
+		// namespace has no name and isn't a component.
+		std::vector<const std::string *> components{&name};
+		NamespacePtr parent;
+		for (const Namespace *ns = &getNamespace(); (parent = ns->getParent()); ns = parent.get())
+			components.push_back(&ns->getName());
+
+		if (components.size() == 1)
+			return std::to_string(name.size()) + name;
 
-	TypePtr ClassType::copy() const {
-		return std::make_shared<ClassType>(*this);
+		std::string out = "N";
+		for (auto iter = components.rbegin(); iter != components.rend(); ++iter)
+			out += std::to_string((*iter)->size()) + **iter;
+		return out + "E";
 	}
 
-	bool ClassType::isExactlyEquivalent(const Type &other, bool ignore_const) const {
+	bool ClassType::isExactlyEquivalentImpl(const Type &other, bool ignore_const) const {
 		if (this == &other)
 			return true;
 
 		if (!ignore_const && getConst() != other.getConst())
 			return false;
 
-		if (const auto *cast = dynamic_cast<const ClassType *>(&other))
+		if (const auto *cast = dyn_cast<ClassType>(&other))
 			return cast->name == name && cast->owner.lock() == owner.lock();
 
 		return false;
@@ -256,29 +295,26 @@ namespace mead {
 	}
 
 	std::format_context::iterator ClassType::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "class {}", getNameImpl());
+		return std::format_to(ctx.out(), "class {}", getName());
 	}
 
 	InvalidType::InvalidType(bool is_const):
-		Type("<error>", is_const) {}
+		Type(TypeKind::Invalid, {}, is_const) {}
 
-	std::string InvalidType::getName() const {
+	std::string InvalidType::getNameImpl() const {
 		return "<error>";
 	}
 
-	TypePtr InvalidType::copy() const {
-		return std::make_shared<InvalidType>();
+	std::string InvalidType::getMangledNameImpl() const {
+		// A vendor extended type, which can't collide with the encoding of any real type.
+		return "u5error";
 	}
 
-	bool InvalidType::isExactlyEquivalent(const Type &other, bool ignore_const) const {
-		return this == &other || ((ignore_const || getConst() == other.getConst()) && dynamic_cast<const InvalidType *>(&other));
+	bool InvalidType::isExactlyEquivalentImpl(const Type &other, bool ignore_const) const {
+		return this == &other || ((ignore_const || getConst() == other.getConst()) && dyn_cast<InvalidType>(&other));
 	}
 
 	LLVMTypePtr InvalidType::toLLVM() const {
-		return std::make_shared<LLVMPoisonType>();
-	}
-
-	std::format_context::iterator InvalidType::formatTo(std::format_context &ctx) const {
-		return std::format_to(ctx.out(), "<error>");
+		return LLVMTypeContext::get().getPoison();
 	}
 }
@@ -0,0 +1,666 @@
+#include "mead/ConstantFolder.h"
+#include "mead/Diagnostics.h"
+#include "mead/Function.h"
+#include "mead/Namespace.h"
+#include "mead/OverloadSet.h"
+#include "mead/Program.h"
+#include "mead/Scope.h"
+#include "mead/Type.h"
+#include "mead/TypeChecker.h"
+#include "mead/TypeContext.h"
+#include "mead/Variable.h"
+
+#include <cassert>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+	/** Returns the node as an expression if it has a type. Nodes the checker doesn't handle (new-expressions, member
+	 *  accesses and so on) have none, and neither does anything built on them. */
+	const mead::Expression * getTyped(const mead::ASTNode &node) {
+		const auto *expression = mead::dyn_cast<mead::Expression>(&node);
+		return expression && expression->getAnnotatedType()? expression : nullptr;
+	}
+
+	/** Returns whether the node is a source literal whose value the given type can represent. Folded numbers keep the
+	 *  type of what they were folded from. */
+	bool literalFits(const mead::ASTNode &node, const mead::IntType &literal_type, const mead::IntType &target) {
+		const auto *number = mead::dyn_cast<mead::Number>(&node);
+		if (!number || number->isFolded())
+			return false;
+		const std::optional<uint64_t> bits = number->getValue();
+		if (!bits)
+			return false;
+		const uint64_t value = *bits;
+		const bool is_negative = literal_type.getSigned() && static_cast<int64_t>(value) < 0;
+		return mead::intFits(value, is_negative, target.getId());
+	}
+
+	/** Whether the type is the invalid type, or a reference to it, which marks an expression that already had an error. */
+	bool isPoisoned(const mead::TypePtr &type) {
+		return type && mead::isa<mead::InvalidType>(type->unwrapLReference());
+	}
+
+	/** Returns the node whose value a block has, which is the block itself if it doesn't end in an expression. */
+	const mead::ASTNode & getValueNode(const mead::ASTNode &block) {
+		if (block.empty() || block.back()->type != mead::NodeType::ExpressionStatement)
+			return block;
+		return *block.back()->front();
+	}
+}
+
+namespace mead {
+	TypeChecker::TypeChecker(const Scope &scope):
+		scope(scope), diagnostics(scope.getProgram()->getDiagnostics()), context(scope.getProgram()->getTypeContext()) {}
+
+	std::shared_ptr<Type> TypeChecker::check(const ASTNode &root) {
+		// Explicit stack instead of recursion: generated expressions can be thousands of levels deep.
+		std::vector<std::pair<const ASTNode *, bool>> stack{{&root, false}};
+
+		while (!stack.empty()) {
+			auto [node, children_done] = stack.back();
+
+			if (children_done) {
+				stack.pop_back();
+				visit(*node);
+				continue;
+			}
+
+			const auto *expression = dyn_cast<Expression>(node);
+
+			if ((expression && expression->isAnnotated()) || (node != &root && isa<Statement>(node))) {
+				stack.pop_back();
+				continue;
+			}
+
+			// Declarations and types name things rather than use them, so there's nothing to annotate in them.
+			if (node->type == NodeType::VariableDeclaration || node->type == NodeType::Type) {
+				stack.pop_back();
+				continue;
+			}
+
+			stack.back().second = true;
+
+			// A call's callee names a function rather than a variable, so only its arguments are typed here.
+			const auto end = node->type == NodeType::FunctionCall? std::prev(node->children.rend()) : node->children.rend();
+			for (auto iter = node->children.rbegin(); iter != end; ++iter)
+				stack.emplace_back(iter->get(), false);
+		}
+
+		if (const auto *expression = dyn_cast<Expression>(&root))
+			return expression->getAnnotatedType();
+
+		return nullptr;
+	}
+
+	bool TypeChecker::checkFunction(const Function &checked) {
+		const auto &definition = checked.getDefinition();
+		assert(definition);
+		assert(scope.getOpen());
+
+		function = &checked;
+		const size_t previous_errors = errorCount;
+
+		// Parameters follow the name and return type in the prototype, in a block of their own around the body's.
+		const ASTNode &prototype = *definition->front();
+		const auto &argument_types = checked.getArgumentTypes();
+		locals.emplace_back();
+
+		for (size_t i = 0; i < argument_types.size(); ++i) {
+			const ASTNode &parameter = *prototype.at(i + 2);
+			const auto *identifier = dyn_cast<Identifier>(parameter.front().get());
+			assert(identifier);
+			declareLocal(parameter, identifier->getIdentifier(), argument_types[i]);
+		}
+
+		checkStatement(*definition->at(1));
+		locals.pop_back();
+		function = nullptr;
+		return errorCount == previous_errors;
+	}
+
+	void TypeChecker::error(const ASTNode &node, std::string message) {
+		diagnostics.error(node, std::move(message));
+		++errorCount;
+	}
+
+	void TypeChecker::annotateInvalid(const Expression &node) {
+		node.annotate(context.getInvalid(), false);
+	}
+
+	std::shared_ptr<Type> TypeChecker::getStatedType(const ASTNode &type_node) const {
+		const auto *type = dyn_cast<TypeNode>(&type_node);
+		if (!type)
+			return nullptr;
+		return type->getType(scope.getProgram()->getGlobalNamespace());
+	}
+
+	void TypeChecker::checkStatement(const ASTNode &statement) {
+		switch (statement.type) {
+			case NodeType::Block:
+				checkBlock(statement);
+				return;
+
+			case NodeType::VariableDeclaration:
+				checkDeclaration(statement, nullptr);
+				return;
+
+			case NodeType::VariableDefinition:
+				checkDeclaration(*statement.at(0), statement.at(1).get());
+				return;
+
+			case NodeType::ExpressionStatement:
+				check(*statement.front());
+				return;
+
+			case NodeType::ReturnStatement: {
+				const ASTNode &value = *statement.front();
+				check(value);
+				if (function && !isa<VoidType>(function->getReturnType()))
+					checkConversion(value, function->getReturnType());
+				return;
+			}
+
+			case NodeType::IfStatement:
+				check(*statement.at(0));
+				checkTruth(*statement.at(0));
+				for (size_t i = 1; i < statement.size(); ++i)
+					checkStatement(*statement.at(i));
+				return;
+
+			default:
+				// Anything else is either empty or can't be emitted yet, which the emitter reports.
+				return;
+		}
+	}
+
+	void TypeChecker::checkBlock(const ASTNode &block) {
+		locals.emplace_back();
+		for (const ASTNodePtr &statement : block)
+			checkStatement(*statement);
+		locals.pop_back();
+	}
+
+	void TypeChecker::checkDeclaration(const ASTNode &declaration, const ASTNode *initializer) {
+		const auto *identifier = dyn_cast<Identifier>(declaration.at(0).get());
+		assert(identifier);
+
+		// The initializer is checked before the local is declared, so a name in it that the local shadows refers to the
+		// outer variable.
+		if (initializer)
+			check(*initializer);
+
+		std::shared_ptr<Type> type = getStatedType(*declaration.at(1));
+		if (!type) {
+			error(declaration, std::format("Unknown type {}", std::string(cast<TypeNode>(declaration.at(1).get())->getName())));
+			type = context.getInvalid();
+		} else if (isa<LReferenceType>(type) && !initializer) {
+			error(declaration, std::format("Reference {} has no initializer", identifier->getIdentifier()));
+		} else if (initializer) {
+			checkConversion(*initializer, type);
+		}
+
+		declareLocal(declaration, identifier->getIdentifier(), std::move(type));
+	}
+
+	bool TypeChecker::declareLocal(const ASTNode &node, const std::string &name, std::shared_ptr<Type> type) {
+		assert(!locals.empty());
+		if (!locals.back().try_emplace(name, std::make_shared<Variable>(name, std::move(type))).second) {
+			error(node, std::format("Redefinition of {}", name));
+			return false;
+		}
+		return true;
+	}
+
+	void TypeChecker::checkConversion(const ASTNode &expression, const std::shared_ptr<Type> &target) {
+		const Expression *typed = getTyped(expression);
+		if (!typed || isPoisoned(typed->getAnnotatedType()) || isa<InvalidType>(target))
+			return;
+
+		if (auto reference = dyn_cast<LReferenceType>(target)) {
+			const Expression *place = getPlace(expression, "bind a reference to");
+			if (!place)
+				return;
+			const TypePtr type = place->getAnnotatedType()->unwrapLReference();
+			const auto &subtype = reference->getSubtype();
+			if (!type->isExactlyEquivalent(*subtype, true) || (type->getConst() && !subtype->getConst()))
+				error(expression, std::format("Can't bind {} to {}", type, target));
+			return;
+		}
+
+		const TypePtr type = typed->getAnnotatedType()->unwrapLReference();
+
+		// Integers convert to each other the way IntConstant::convert does. Anything else that can't be emitted yet is
+		// the emitter's to report.
+		if (isa<IntType>(target) && !isa<IntType>(type))
+			error(expression, std::move(TypeError(type, target).message));
+		else if (isa<PointerType>(target) && !type->isConvertibleTo(*target))
+			error(expression, std::move(TypeError(type, target).message));
+	}
+
+	void TypeChecker::checkTruth(const ASTNode &expression) {
+		const Expression *typed = getTyped(expression);
+		if (!typed || isPoisoned(typed->getAnnotatedType()))
+			return;
+		const TypePtr type = typed->getAnnotatedType()->unwrapLReference();
+		if (!isa<IntType>(type) && !isa<PointerType>(type))
+			error(expression, "Condition isn't an integer or a pointer");
+	}
+
+	const Expression * TypeChecker::getPlace(const ASTNode &node, std::string_view use) {
+		const Expression *typed = getTyped(node);
+		if (!typed || isPoisoned(typed->getAnnotatedType()))
+			return nullptr;
+		if (node.type != NodeType::Identifier && node.type != NodeType::Deref) {
+			error(node, std::format("Can't {} {}", use, getNodeTypeName(node.type)));
+			return nullptr;
+		}
+		return typed;
+	}
+
+	std::shared_ptr<IntType> TypeChecker::getOperationType(const ASTNode &lhs, const std::shared_ptr<IntType> &lhs_type, const ASTNode &rhs, const std::shared_ptr<IntType> &rhs_type) {
+		if (literalFits(rhs, *rhs_type, *lhs_type))
+			return lhs_type;
+		if (literalFits(lhs, *lhs_type, *rhs_type))
+			return rhs_type;
+		const IntTypeId common = intCommonTypes[lhs_type->getId()][rhs_type->getId()];
+		if (common == noIntType)
+			return nullptr;
+		return common == lhs_type->getId()? lhs_type : rhs_type;
+	}
+
+	void TypeChecker::visitAssign(const Expression &node) {
+		const Expression *place = getPlace(*node.at(0), "assign to");
+		if (!place) {
+			annotateInvalid(node);
+			return;
+		}
+
+		TypePtr type = place->getAnnotatedType()->unwrapLReference();
+		if (type->getConst())
+			error(node, "Can't assign to a const");
+		else
+			checkConversion(*node.at(1), type);
+
+		node.annotate(std::move(type), false);
+	}
+
+	void TypeChecker::visitBinary(const Binary &node) {
+		const Expression *lhs = getTyped(*node.at(0));
+		const Expression *rhs = getTyped(*node.at(1));
+
+		if (!lhs || !rhs) {
+			node.annotate(nullptr, false);
+			return;
+		}
+
+		const TypePtr &lhs_type = lhs->getAnnotatedType();
+		const TypePtr &rhs_type = rhs->getAnnotatedType();
+		TypePtr type;
+
+		if (isPoisoned(lhs_type) || isPoisoned(rhs_type)) {
+			annotateInvalid(node);
+			return;
+		}
+
+		// The result is a value, not a reference to either operand.
+		auto lhs_int = dyn_cast<IntType>(lhs_type->unwrapLReference());
+		auto rhs_int = dyn_cast<IntType>(rhs_type->unwrapLReference());
+
+		if (lhs_int && rhs_int)
+			type = getOperationType(*lhs, lhs_int, *rhs, rhs_int);
+		else if (rhs_type->isConvertibleTo(*lhs_type))
+			type = lhs_type;
+		else if (lhs_type->isConvertibleTo(*rhs_type))
+			type = rhs_type;
+
+		if (!type) {
+			error(node, std::format("Operands of types {} and {} have no common type", lhs_type->unwrapLReference(), rhs_type->unwrapLReference()));
+			type = context.getInvalid(true);
+		}
+
+		const bool is_constant = lhs->isConstant(scope) && rhs->isConstant(scope) && !isa<InvalidType>(type);
+		node.annotate(std::move(type), is_constant);
+	}
+
+	void TypeChecker::visitBitwiseNot(const Expression &node) {
+		checkUnary(node);
+	}
+
+	void TypeChecker::visitCast(const Expression &node) {
+		checkCast(node, *node.at(0), *node.at(1));
+	}
+
+	void TypeChecker::visitComma(const Expression &node) {
+		const Expression *rhs = getTyped(*node.at(1));
+		node.annotate(rhs? rhs->getAnnotatedType() : nullptr, false);
+	}
+
+	void TypeChecker::visitCompoundAssign(const Expression &node) {
+		const TokenType operation = getCompoundOperator(node.token.type);
+		if (operation == TokenType::Invalid) {
+			error(node, std::format("Unknown compound assignment {}", node.token.value));
+			annotateInvalid(node);
+			return;
+		}
+
+		const Expression *place = getPlace(*node.at(0), "assign to");
+		const Expression *rhs = getTyped(*node.at(1));
+		if (!place || !rhs || isPoisoned(rhs->getAnnotatedType())) {
+			annotateInvalid(node);
+			return;
+		}
+
+		auto type = dyn_cast<IntType>(place->getAnnotatedType()->unwrapLReference());
+		if (!type) {
+			error(node, "Compound assignment is only supported for integers");
+		} else if (type->getConst()) {
+			error(node, "Can't assign to a const");
+		} else if (auto rhs_type = dyn_cast<IntType>(rhs->getAnnotatedType()->unwrapLReference()); !rhs_type || !getOperationType(*place, type, *rhs, rhs_type)) {
+			error(node, std::format("Operands of types {} and {} have no common type", type, rhs->getAnnotatedType()->unwrapLReference()));
+		} else {
+			node.annotate(std::move(type), false);
+			return;
+		}
+
+		annotateInvalid(node);
+	}
+
+	void TypeChecker::visitConditionalExpression(const Expression &node) {
+		checkTruth(*node.at(0));
+		checkBlock(*node.at(1));
+		checkBlock(*node.at(2));
+
+		// A block that doesn't end in an expression has no value.
+		auto getBlockType = [&](const ASTNode &block) -> TypePtr {
+			const ASTNode &value = getValueNode(block);
+			if (&value == &block)
+				return context.getVoid();
+			const Expression *typed = getTyped(value);
+			return typed? typed->getAnnotatedType()->unwrapLReference() : nullptr;
+		};
+
+		const ASTNode &true_node = getValueNode(*node.at(1));
+		const ASTNode &false_node = getValueNode(*node.at(2));
+		TypePtr if_true = getBlockType(*node.at(1));
+		TypePtr if_false = getBlockType(*node.at(2));
+
+		if (!if_true || !if_false) {
+			node.annotate(nullptr, false);
+			return;
+		}
+
+		if (isPoisoned(if_true) || isPoisoned(if_false)) {
+			annotateInvalid(node);
+			return;
+		}
+
+		TypePtr type;
+		auto true_int = dyn_cast<IntType>(if_true);
+		auto false_int = dyn_cast<IntType>(if_false);
+
+		if (true_int && false_int)
+			type = getOperationType(true_node, true_int, false_node, false_int);
+		else if (if_true->isExactlyEquivalent(*if_false, true))
+			type = if_true;
+
+		if (!type) {
+			error(node, std::format("Branches of types {} and {} have no common type", if_true, if_false));
+			type = context.getInvalid(true);
+		}
+
+		node.annotate(std::move(type), false);
+	}
+
+	void TypeChecker::visitConstructorCall(const Expression &node) {
+		const ASTNode &args = *node.at(1);
+		if (args.size() != 1) {
+			error(node, "Constructor calls take exactly one argument");
+			annotateInvalid(node);
+			return;
+		}
+		checkCast(node, *node.at(0), *args.front());
+	}
+
+	void TypeChecker::visitDeref(const Dereference &node) {
+		const Expression *subexpr = getTyped(*node.front());
+		if (!subexpr) {
+			node.annotate(nullptr, false);
+			return;
+		}
+
+		const TypePtr &subtype = subexpr->getAnnotatedType();
+		if (isPoisoned(subtype)) {
+			annotateInvalid(node);
+			return;
+		}
+
+		// Maybe it could be constant for string literals...?
+		if (TypePtr type = subtype->unwrapLReference()->dereference()) {
+			node.annotate(std::move(type), false);
+			return;
+		}
+
+		error(node, "Dereferenced expression isn't a pointer");
+		annotateInvalid(node);
+	}
+
+	void TypeChecker::visitFunctionCall(const FunctionCall &node) {
+		const ASTNode &args = *node.getArgs();
+		for (const ASTNodePtr &argument : args) {
+			if (const Expression *typed = getTyped(*argument); typed && isPoisoned(typed->getAnnotatedType())) {
+				annotateInvalid(node);
+				return;
+			}
+		}
+
+		// Global initializers are checked before later functions are declared, so an unresolved callee is only an error
+		// in a function body. Compiling a global's call reports it if it's still unknown then.
+		OverloadSet::Resolution resolution = node.resolveCallee(scope);
+		if (!function) {
+			node.annotate(resolution.function? resolution.function->getReturnType() : nullptr, false);
+			return;
+		}
+
+		const Identifier *callee_name = node.getCalleeName();
+		if (!callee_name)
+			error(node, "Only named functions can be called");
+		else if (!node.getOverloads(*scope.getProgram()->getGlobalNamespace()))
+			error(*callee_name, std::format("Unknown function {}", callee_name->getIdentifier()));
+		else if (resolution.isAmbiguous)
+			error(*callee_name, std::format("Call to {} is ambiguous", callee_name->getIdentifier()));
+		else if (!resolution.function)
+			error(*callee_name, std::format("No overload of {} takes these arguments", callee_name->getIdentifier()));
+
+		if (!resolution.function) {
+			annotateInvalid(node);
+			return;
+		}
+
+		const FunctionPtr &callee = resolution.function;
+		const auto &argument_types = callee->getArgumentTypes();
+		if (args.size() != argument_types.size())
+			error(node, std::format("{} takes {} arguments, not {}", callee->getName(), argument_types.size(), args.size()));
+		else
+			for (size_t i = 0; i < args.size(); ++i)
+				checkConversion(*args.at(i), argument_types[i]);
+
+		node.annotate(callee->getReturnType(), false);
+	}
+
+	void TypeChecker::visitGetAddress(const GetAddress &node) {
+		if (!getTyped(*node.front())) {
+			node.annotate(nullptr, false);
+			return;
+		}
+
+		const Expression *place = getPlace(*node.front(), "take the address of");
+		if (!place) {
+			annotateInvalid(node);
+			return;
+		}
+
+		node.annotate(context.getPointer(place->getAnnotatedType()->unwrapLReference()), false);
+	}
+
+	std::expected<VariablePtr, ResolutionError> TypeChecker::resolve(const Identifier &node) const {
+		const std::string &name = node.getIdentifier();
+		for (auto iter = locals.rbegin(); iter != locals.rend(); ++iter)
+			if (auto found = iter->find(name); found != iter->end())
+				return found->second;
+		if (VariablePtr variable = scope.getVariable(name))
+			return variable;
+		return std::unexpected(ResolutionError(name));
+	}
+
+	void TypeChecker::visitIdentifier(const Identifier &node) {
+		std::expected<VariablePtr, ResolutionError> variable = resolve(node);
+		if (!variable) {
+			error(node, std::move(variable.error().message));
+			annotateInvalid(node);
+			return;
+		}
+		// TODO: allow certain identifiers to be evaluated at compile time
+		node.annotate(LReferenceType::wrap((*variable)->getType()), false);
+	}
+
+	void TypeChecker::visitLogicalNot(const Expression &node) {
+		checkUnary(node);
+	}
+
+	void TypeChecker::visitNumber(const Number &node) {
+		if (!node.getValue()) {
+			error(node, std::format("Integer literal {} doesn't fit in 64 bits", node.token.value));
+			annotateInvalid(node);
+			return;
+		}
+
+		node.annotate(node.getIntType(context), true);
+	}
+
+	void TypeChecker::visitPostfixDecrement(const Expression &node) {
+		checkStep(node);
+	}
+
+	void TypeChecker::visitPostfixIncrement(const Expression &node) {
+		checkStep(node);
+	}
+
+	void TypeChecker::visitPrefixDecrement(const Expression &node) {
+		checkStep(node);
+	}
+
+	void TypeChecker::visitPrefixIncrement(const Expression &node) {
+		checkStep(node);
+	}
+
+	void TypeChecker::visitString(const Expression &node) {
+		node.annotate(context.getPointer(context.getInt(8, false, true)), false);
+	}
+
+	void TypeChecker::visitUnaryMinus(const Expression &node) {
+		checkUnary(node);
+	}
+
+	void TypeChecker::visitUnaryPlus(const Expression &node) {
+		checkUnary(node);
+	}
+
+	void TypeChecker::checkUnary(const Expression &node) {
+		const Expression *operand = getTyped(*node.front());
+		if (!operand) {
+			node.annotate(nullptr, false);
+			return;
+		}
+
+		const TypePtr type = operand->getAnnotatedType()->unwrapLReference();
+		if (isPoisoned(type)) {
+			annotateInvalid(node);
+		} else if (isa<IntType>(type)) {
+			node.annotate(type, operand->isConstant(scope));
+		} else {
+			error(node, std::format("Operand of {} isn't an integer", getNodeTypeName(node.type)));
+			annotateInvalid(node);
+		}
+	}
+
+	void TypeChecker::checkStep(const Expression &node) {
+		const Expression *place = getPlace(*node.front(), "modify");
+		if (!place) {
+			annotateInvalid(node);
+			return;
+		}
+
+		const TypePtr type = place->getAnnotatedType()->unwrapLReference();
+		if (!isa<IntType>(type))
+			error(node, "Only integers can be incremented or decremented");
+		else if (type->getConst())
+			error(node, "Can't modify a const");
+		else {
+			node.annotate(type, false);
+			return;
+		}
+
+		annotateInvalid(node);
+	}
+
+	void TypeChecker::checkCast(const Expression &node, const ASTNode &type_node, const ASTNode &subexpr) {
+		TypePtr type = getStatedType(type_node);
+		if (!type) {
+			error(type_node, std::format("Unknown type {}", std::string(cast<TypeNode>(&type_node)->getName())));
+			annotateInvalid(node);
+			return;
+		}
+
+		// Only conversions between integers are supported so far, and the emitter reports any others.
+		const Expression *value = getTyped(subexpr);
+		if (value && isa<IntType>(type)) {
+			const TypePtr value_type = value->getAnnotatedType()->unwrapLReference();
+			if (isPoisoned(value_type)) {
+				annotateInvalid(node);
+				return;
+			}
+			if (!isa<IntType>(value_type)) {
+				error(subexpr, std::move(TypeError(value_type, type).message));
+				annotateInvalid(node);
+				return;
+			}
+		}
+
+		node.annotate(std::move(type), value && value->isConstant(scope));
+	}
+
+	void TypeChecker::visitVariableDefinition(const VariableDefinition &node) {
+		if (std::expected<void, TypeError> result = checkInitializer(node); !result)
+			error(*node.at(1), std::move(result.error().message));
+	}
+
+	std::expected<void, TypeError> TypeChecker::checkInitializer(const VariableDefinition &node) const {
+		auto type_node = dyn_cast<TypeNode>(node.at(0)->at(1));
+		assert(type_node);
+		TypePtr stated_type = type_node->getType(scope.getProgram()->getGlobalNamespace());
+
+		const ASTNode &initializer = *node.at(1);
+		const auto *expression = dyn_cast<Expression>(&initializer);
+		if (expression && isPoisoned(expression->getAnnotatedType()))
+			return {};
+
+		// A constant initializer converts implicitly to any integer type that can represent its value.
+		if (const auto *int_type = dyn_cast<IntType>(stated_type.get())) {
+			if (std::optional<IntConstant> value = ConstantFolder(scope).evaluate(initializer)) {
+				if (value->fits(*int_type) || value->getType()->isConvertibleTo(*stated_type))
+					return {};
+				return std::unexpected(TypeError(value->getType(), std::move(stated_type)));
+			}
+		}
+
+		if (!expression)
+			return {};
+
+		TypePtr expr_type = expression->getAnnotatedType();
+		if (expr_type && !expr_type->isConvertibleTo(*stated_type))
+			return std::unexpected(TypeError(std::move(expr_type), std::move(stated_type)));
+		return {};
+	}
+}
@@ -0,0 +1,136 @@
+#include "mead/util/Casting.h"
+#include "mead/Namespace.h"
+#include "mead/TypeContext.h"
+
+#include <bit>
+#include <cassert>
+
+namespace mead {
+	template <typename T>
+	const std::shared_ptr<T> & TypeContext::adopt(const std::shared_ptr<T> &type, const Type *non_const_variant) {
+		type->context = this;
+		type->nonConstVariant = non_const_variant? non_const_variant : type.get();
+		return type;
+	}
+
+	TypeContext::TypeContext() {
+		for (IntTypeId id = 0; id < intTypeCount; ++id) {
+			const int bit_width = getIntTypeWidth(id);
+			const bool is_signed = getIntTypeSigned(id);
+			auto non_const = std::make_shared<IntType>(bit_width, is_signed, false);
+			intTypes[id][false] = adopt(non_const, nullptr);
+			intTypes[id][true] = adopt(std::make_shared<IntType>(bit_width, is_signed, true), non_const.get());
+		}
+	}
+
+	std::shared_ptr<IntType> TypeContext::getInt(int bit_width, bool is_signed, bool is_const) {
+		assert(std::has_single_bit(static_cast<unsigned>(bit_width)) && 8 <= bit_width && bit_width <= 64);
+		return intTypes[getIntTypeId(bit_width, is_signed)][is_const];
+	}
+
+	std::shared_ptr<VoidType> TypeContext::getVoid(bool is_const) {
+		std::lock_guard lock(mutex);
+		auto &slot = voidTypes[is_const];
+		if (!slot) {
+			const Type *non_const = is_const? getVoid(false).get() : nullptr;
+			slot = adopt(std::make_shared<VoidType>(is_const), non_const);
+		}
+		return slot;
+	}
+
+	std::shared_ptr<InvalidType> TypeContext::getInvalid(bool is_const) {
+		std::lock_guard lock(mutex);
+		auto &slot = invalidTypes[is_const];
+		if (!slot) {
+			const Type *non_const = is_const? getInvalid(false).get() : nullptr;
+			slot = adopt(std::make_shared<InvalidType>(is_const), non_const);
+		}
+		return slot;
+	}
+
+	std::shared_ptr<PointerType> TypeContext::getPointer(const TypePtr &subtype, bool is_const) {
+		std::lock_guard lock(mutex);
+		assert(subtype && subtype->context == this);
+		TypePtr unwrapped = subtype->unwrapLReference();
+		std::pair key{static_cast<const Type *>(unwrapped.get()), is_const};
+		if (auto iter = pointerTypes.find(key); iter != pointerTypes.end())
+			return iter->second;
+		const Type *non_const = is_const? getPointer(unwrapped, false).get() : nullptr;
+		auto type = std::make_shared<PointerType>(unwrapped, is_const);
+		adopt(type, non_const);
+		pointerTypes.emplace(key, type);
+		return type;
+	}
+
+	std::shared_ptr<LReferenceType> TypeContext::getLReference(const TypePtr &subtype, bool is_const) {
+		std::lock_guard lock(mutex);
+		assert(subtype && subtype->context == this);
+		TypePtr unwrapped = subtype->unwrapLReference();
+		std::pair key{static_cast<const Type *>(unwrapped.get()), is_const};
+		if (auto iter = lreferenceTypes.find(key); iter != lreferenceTypes.end())
+			return iter->second;
+		const Type *non_const = is_const? getLReference(unwrapped, false).get() : nullptr;
+		auto type = std::make_shared<LReferenceType>(unwrapped, is_const);
+		adopt(type, non_const);
+		lreferenceTypes.emplace(key, type);
+		return type;
+	}
+
+	std::shared_ptr<ClassType> TypeContext::getClass(const std::string &name, const std::shared_ptr<Namespace> &owner, bool is_const) {
+		std::lock_guard lock(mutex);
+		ClassKey key{owner.get(), name, is_const};
+		if (auto iter = classTypes.find(key); iter != classTypes.end())
+			return iter->second;
+		const Type *non_const = is_const? getClass(name, owner, false).get() : nullptr;
+		auto type = std::make_shared<ClassType>(name, owner, is_const);
+		adopt(type, non_const);
+		classTypes.emplace(std::move(key), type);
+		return type;
+	}
+
+	TypePtr TypeContext::withConst(const Type &type, bool is_const) {
+		std::lock_guard lock(mutex);
+		assert(type.context == this);
+
+		if (type.getConst() == is_const)
+			return std::const_pointer_cast<Type>(type.shared_from_this());
+
+		switch (type.getKind()) {
+			case TypeKind::Int: {
+				const auto &int_type = cast<IntType>(type);
+				return getIntById(int_type.getId(), is_const);
+			}
+
+			case TypeKind::Pointer:
+				return getPointer(cast<PointerType>(type).getSubtype(), is_const);
+
+			case TypeKind::LReference:
+				return getLReference(cast<LReferenceType>(type).getSubtype(), is_const);
+
+			case TypeKind::Class: {
+				const auto &class_type = cast<ClassType>(type);
+				return getClass(class_type.getBaseName(), class_type.getOwner(), is_const);
+			}
+
+			case TypeKind::Void:
+				return getVoid(is_const);
+
+			case TypeKind::Invalid:
+				return getInvalid(is_const);
+		}
+
+		return getInvalid(is_const);
+	}
+
+	bool TypeContext::isConvertible(const Type &from, const Type &to) {
+		std::lock_guard lock(mutex);
+		assert(from.context == this && to.context == this);
+
+		if (auto iter = conversions.find({&from, &to}); iter != conversions.end())
+			return iter->second;
+
+		const bool result = from.isConvertibleToImpl(to);
+		conversions.emplace(std::pair{&from, &to}, result);
+		return result;
+	}
+}
@@ -1,22 +1,24 @@
+#include "mead/TypeContext.h"
 #include "mead/TypeDB.h"
 
 namespace mead {
-	std::map<NamespacedName, TypePtr> TypeDB::getDefaultTypes() {
+	std::map<NamespacedName, TypePtr> TypeDB::getDefaultTypes(TypeContext &context) {
 		return {
-			{"void", std::make_shared<VoidType>()},
-			{"i8",   std::make_shared<IntType>(8,   true)},
-			{"u8",   std::make_shared<IntType>(8,  false)},
-			{"i16",  std::make_shared<IntType>(16,  true)},
-			{"u16",  std::make_shared<IntType>(16, false)},
-			{"i32",  std::make_shared<IntType>(32,  true)},
-			{"u32",  std::make_shared<IntType>(32, false)},
-			{"i64",  std::make_shared<IntType>(64,  true)},
-			{"u64",  std::make_shared<IntType>(64, false)},
+			{"void", context.getVoid()},
+			{"i8",   context.getInt(8,   true)},
+			{"u8",   context.getInt(8,  false)},
+			{"i16",  context.getInt(16,  true)},
+			{"u16",  context.getInt(16, false)},
+			{"i32",  context.getInt(32,  true)},
+			{"u32",  context.getInt(32, false)},
+			{"i64",  context.getInt(64,  true)},
+			{"u64",  context.getInt(64, false)},
 		};
 	}
 
 	TypeDB::TypeDB():
-		types(getDefaultTypes()) {}
+		context(std::make_shared<TypeContext>()),
+		types(getDefaultTypes(*context)) {}
 
 	bool TypeDB::insert(TypePtr /* type */) {
 		// if (auto iter = types.find(type->name); iter != types.end()) {
@@ -0,0 +1,69 @@
+#include "mead/util/Casting.h"
+#include "mead/BasicBlock.h"
+#include "mead/Function.h"
+#include "mead/LLVMInstruction.h"
+#include "mead/UseLists.h"
+
+#include <algorithm>
+
+namespace mead {
+	UseLists::UseLists(Function &function) {
+		for (const auto &block : function.getBlocks())
+			for (Instruction &instruction : block->getInstructions())
+				if (auto llvm_instruction = dyn_cast<LLVMInstruction>(&instruction))
+					add(*llvm_instruction);
+	}
+
+	const std::vector<UseLists::Use> & UseLists::getUses(const LLVMValue &value) const {
+		static const std::vector<Use> none;
+		auto iter = uses.find(&value);
+		return iter == uses.end()? none : iter->second;
+	}
+
+	LLVMInstruction * UseLists::getDefinition(const LLVMValue &value) const {
+		auto iter = definitions.find(&value);
+		return iter == definitions.end()? nullptr : iter->second;
+	}
+
+	void UseLists::add(LLVMInstruction &instruction) {
+		for (LLVMValuePtr *operand : instruction.getOperands())
+			if (*operand)
+				uses[operand->get()].push_back({&instruction, operand});
+
+		if (LLVMValuePtr result = instruction.getResult())
+			definitions[result.get()] = &instruction;
+	}
+
+	void UseLists::forget(LLVMInstruction &instruction) {
+		for (LLVMValuePtr *operand : instruction.getOperands()) {
+			if (!*operand)
+				continue;
+
+			auto iter = uses.find(operand->get());
+			if (iter == uses.end())
+				continue;
+
+			std::erase_if(iter->second, [&](const Use &use) { return use.user == &instruction; });
+			if (iter->second.empty())
+				uses.erase(iter);
+		}
+
+		if (LLVMValuePtr result = instruction.getResult())
+			definitions.erase(result.get());
+	}
+
+	void UseLists::replaceAllUses(const LLVMValue &value, const LLVMValuePtr &replacement) {
+		if (&value == replacement.get())
+			return;
+
+		auto node = uses.extract(&value);
+		if (node.empty())
+			return;
+
+		std::vector<Use> &replacement_uses = uses[replacement.get()];
+		for (const Use &use : node.mapped()) {
+			*use.operand = replacement;
+			replacement_uses.push_back(use);
+		}
+	}
+}
@@ -0,0 +1,25 @@
+#include "mead/node/Expression.h"
+#include "mead/Type.h"
+#include "mead/TypeChecker.h"
+
+namespace mead {
+	void Expression::annotate(std::shared_ptr<Type> type, bool is_constant) const {
+		annotatedType = std::move(type);
+		annotatedConstant = is_constant;
+		annotated = true;
+	}
+
+	std::shared_ptr<Type> Expression::getType(const Scope &scope) const {
+		if (!annotated)
+			TypeChecker(scope).check(*this);
+
+		return annotatedType;
+	}
+
+	bool Expression::isConstant(const Scope &scope) const {
+		if (!annotated)
+			TypeChecker(scope).check(*this);
+
+		return annotatedConstant;
+	}
+}
@@ -1,8 +1,25 @@
 #include "mead/node/FunctionCall.h"
+#include "mead/node/Identifier.h"
+#include "mead/util/Casting.h"
+#include "mead/Function.h"
+#include "mead/Namespace.h"
+#include "mead/Program.h"
+#include "mead/Scope.h"
+
+#include <vector>
 
 #include <cassert>
 
 namespace mead {
+	namespace {
+		/** Arguments that aren't expressions, like new-expressions, have an unknown type. */
+		std::shared_ptr<Type> getArgumentType(const ASTNode &argument, const Scope &scope) {
+			if (const auto *expression = dyn_cast<Expression>(&argument))
+				return expression->getType(scope);
+			return nullptr;
+		}
+	}
+
 	FunctionCall::FunctionCall(Token token):
 		Expression(NodeType::FunctionCall, std::move(token)) {}
 
@@ -14,18 +31,28 @@ namespace mead {
 		return children.at(1);
 	}
 
-	std::shared_ptr<Type> FunctionCall::getType(const Scope &) const {
-		ASTNodePtr function = getFunction();
+	const Identifier * FunctionCall::getCalleeName() const {
+		return dyn_cast<Identifier>(children.at(0).get());
+	}
 
-		if (function->type == NodeType::Identifier) {
+	std::shared_ptr<const OverloadSet> FunctionCall::getOverloads(const Namespace &ns) const {
+		const Identifier *name = getCalleeName();
+		return name? ns.getOverloads(name->getIdentifier()) : nullptr;
+	}
 
-		}
+	OverloadSet::Resolution FunctionCall::resolveCallee(const Scope &scope) const {
+		std::shared_ptr<const OverloadSet> overloads = getOverloads(*scope.getProgram()->getGlobalNamespace());
+		if (!overloads)
+			return {};
 
-		return {};
-	}
+		if (overloads->size() == 1)
+			return {overloads->getOnly()};
+
+		// Unknown argument types match any parameter.
+		std::vector<std::shared_ptr<Type>> argument_types;
+		for (const ASTNodePtr &argument : *getArgs())
+			argument_types.push_back(getArgumentType(*argument, scope));
 
-	bool FunctionCall::isConstant(const Scope &) const {
-		// TODO: allow certain functions to be evaluated at compile time
-		return false;
+		return overloads->resolve(argument_types);
 	}
 }
@@ -1,20 +1,62 @@
 #include "mead/node/Number.h"
-#include "mead/Logging.h"
 #include "mead/Type.h"
+#include "mead/TypeContext.h"
 #include "mead/Util.h"
 
-#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
 
 namespace mead {
 	Number::Number(Token token):
 		Expression(NodeType::Number, std::move(token)) {}
 
-	TypePtr Number::getType(const Scope &scope) const {
-		// TODO: allow more types
-		return std::make_shared<IntType>(64, true, true);
+	Number::Number(Token token, std::shared_ptr<IntType> literal_type):
+		Expression(NodeType::Number, std::move(token)), literalType(std::move(literal_type)) {}
+
+	std::optional<uint64_t> Number::getValue() const {
+		std::string_view view = token.value;
+
+		const bool negative = view.starts_with('-');
+		if (negative)
+			view.remove_prefix(1);
+
+		int base = 10;
+		if (view.starts_with("0x") || view.starts_with("0X")) {
+			base = 16;
+			view.remove_prefix(2);
+		} else if (1 < view.size() && view.front() == '0') {
+			base = 8;
+			view.remove_prefix(1);
+		}
+
+		uint64_t value = 0;
+		for (const char ch : view) {
+			if (ch == '\'')
+				continue;
+
+			uint64_t digit{};
+			if ('0' <= ch && ch <= '9')
+				digit = ch - '0';
+			else if ('a' <= ch && ch <= 'f')
+				digit = ch - 'a' + 10;
+			else if ('A' <= ch && ch <= 'F')
+				digit = ch - 'A' + 10;
+			else
+				throw std::invalid_argument("Not an integer: \"" + token.value + "\"");
+
+			if ((std::numeric_limits<uint64_t>::max() - digit) / base < value)
+				return std::nullopt;
+			value = value * base + digit;
+		}
+
+		return negative? -value : value;
 	}
 
-	bool Number::isConstant(const Scope &) const {
-		return true;
+	std::shared_ptr<IntType> Number::getIntType(TypeContext &context) const {
+		if (literalType)
+			return literalType;
+		// TODO: allow more types
+		return context.getInt(64, true, true);
 	}
 }
@@ -1,4 +1,5 @@
 #include "mead/node/Return.h"
+#include "mead/util/Casting.h"
 
 #include <cassert>
 
@@ -8,7 +9,7 @@ namespace mead {
 
 	std::shared_ptr<Expression> Return::getExpression() const {
 		assert(size() == 1);
-		auto expression = std::dynamic_pointer_cast<Expression>(front());
+		auto expression = dyn_cast<Expression>(front());
 		assert(expression);
 		return expression;
 	}
@@ -1,29 +1,28 @@
 #include "mead/node/TypeNode.h"
 #include "mead/Logging.h"
 #include "mead/Namespace.h"
-#include "mead/Type.h"
+#include "mead/QualifiedType.h"
 
 namespace mead {
 	TypeNode::TypeNode(Token token):
-		ASTNode(NodeType::Type, std::move(token)) {}
+		ASTNode(NodeType::Type, token), name(std::move(token.value)) {}
 
-	std::shared_ptr<Type> TypeNode::getType(const std::shared_ptr<Namespace> &ns) const {
-		TypePtr type = ns->getType(token.value);
+	TypeNode::TypeNode(Token token, NamespacedName name):
+		ASTNode(NodeType::Type, std::move(token)), name(std::move(name)) {}
 
-		if (empty())
-			return type;
+	QualifiedType TypeNode::getQualifiedType(const std::shared_ptr<Namespace> &ns) const {
+		QualifiedType type(ns->getType(name));
 
 		for (const ASTNodePtr &child : children) {
 			switch (child->type) {
 				case NodeType::Pointer:
-					type = std::make_shared<PointerType>(std::move(type));
+					type = type.pointerTo();
 					break;
 				case NodeType::LReference:
-					type = std::make_shared<LReferenceType>(std::move(type));
+					type = type.referenceTo();
 					break;
 				case NodeType::Const:
-					type = type->copy();
-					type->setConst(true);
+					type = type.withConst(true);
 					break;
 				default:
 					WARN("{}???", child->type);
@@ -33,4 +32,11 @@ namespace mead {
 
 		return type;
 	}
+
+	std::shared_ptr<Type> TypeNode::getType(const std::shared_ptr<Namespace> &ns) const {
+		if (empty())
+			return ns->getType(name);
+
+		return getQualifiedType(ns).getType();
+	}
 }
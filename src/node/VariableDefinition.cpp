@@ -1,5 +1,5 @@
 #include "mead/node/VariableDefinition.h"
-#include "mead/Scope.h"
+#include "mead/util/Casting.h"
 
 #include <cassert>
 
@@ -12,23 +12,9 @@ namespace mead {
 	}
 
 	ExpressionPtr VariableDefinition::getExpression() const {
-		debug();
 		assert(size() == 2);
-		auto expression = std::dynamic_pointer_cast<Expression>(at(1));
+		auto expression = dyn_cast<Expression>(at(1));
 		assert(expression);
 		return expression;
 	}
-
-	bool VariableDefinition::compile(Compiler &compiler, Function &function, Scope &scope, std::shared_ptr<BasicBlock> block) {
-		debug();
-
-		ExpressionPtr expression = getExpression();
-
-		const bool inserted = scope.insertVariable(getVariableName(), expression->getType(scope));
-		if (!inserted) {
-			return false;
-		}
-
-		return false;
-	}
 }
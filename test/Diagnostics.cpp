@@ -0,0 +1,82 @@
+#include "mead/Compiler.h"
+#include "mead/IncrementalCompiler.h"
+
+#include "Harness.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+int main() {
+	using namespace mead;
+
+	// Every error in a body is reported, not just the first, and they come out sorted by location.
+	{
+		IncrementalCompiler compiler;
+		compiler.setSource("file",
+			"fn f(p: i32*) -> i32 {\n"
+			"\tx: i32 = missing;\n"
+			"\tp = 5;\n"
+			"\ty: i32 = nothing(1);\n"
+			"\tx = p + x;\n"
+			"\treturn p;\n"
+			"}\n"
+			"fn g() -> i32 { return f(1, 2); }\n");
+
+		const std::vector<std::pair<std::pair<size_t, size_t>, std::string>> expected{
+			{{2, 11}, "Unknown variable missing"},
+			{{3, 6},  "Can't convert i64 const to i32*"},
+			{{4, 11}, "Unknown function nothing"},
+			{{5, 8},  "Operands of types i32* and i32 have no common type"},
+			{{6, 9},  "Can't convert i32* to i32"},
+			{{8, 25}, "f takes 1 arguments, not 2"},
+		};
+
+		const auto &diagnostics = compiler.getModule("file").diagnostics;
+		if (CHECK(diagnostics.size() == expected.size())) {
+			for (size_t i = 0; i < expected.size(); ++i) {
+				CHECK(diagnostics[i].location.line == expected[i].first.first);
+				CHECK(diagnostics[i].location.column == expected[i].first.second);
+				CHECK(diagnostics[i].message == expected[i].second);
+			}
+		}
+	}
+
+	// The same mistake gets the same message in a global initializer as in a function body.
+	{
+		IncrementalCompiler compiler;
+		compiler.setSource("file",
+			"g: i32 = missing;\n"
+			"fn f() -> i32 { return missing; }\n");
+
+		const auto &diagnostics = compiler.getModule("file").diagnostics;
+		if (CHECK(diagnostics.size() == 2)) {
+			CHECK(diagnostics[0].message == "Unknown variable missing");
+			CHECK(diagnostics[1].message == "Unknown variable missing");
+		}
+	}
+
+	// An error is reported once, not again by everything that uses the erroneous expression.
+	{
+		IncrementalCompiler compiler;
+		compiler.setSource("file", "fn f(a: i32) -> i32 { b: i32 = a + missing * 2; return -(b + missing) + (a = missing); }\n");
+		const auto &diagnostics = compiler.getModule("file").diagnostics;
+		CHECK(diagnostics.size() == 3);
+	}
+
+	// Errors from every function are collected by a batch compile too.
+	{
+		test::Parsed parsed(R"(
+			fn f() -> i32 { return one + two; }
+			fn g() -> i32 { x: i32 = three; return x; }
+		)");
+		if (parsed.ok) {
+			Compiler compiler(0);
+			const CompilerResult result = compiler.compile(parsed.getNodes());
+			if (CHECK(!result.has_value()))
+				CHECK(result.error().first == "3 errors");
+		}
+	}
+
+	return test::finish();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "mead/Lexer.h"
+#include "mead/Parser.h"
+
+#include <cstdlib>
+#include <print>
+#include <string_view>
+
+/** Just enough to write regression tests with: checks report where they failed and let the rest of the test run, and
+ *  the test fails at the end if any of them did. */
+namespace mead::test {
+	inline size_t failures = 0;
+
+	inline bool check(bool condition, std::string_view expression, std::string_view file, int line) {
+		if (!condition) {
+			std::println(stderr, "{}:{}: check failed: {}", file, line, expression);
+			++failures;
+		}
+		return condition;
+	}
+
+	inline bool contains(std::string_view haystack, std::string_view needle) {
+		return haystack.find(needle) != std::string_view::npos;
+	}
+
+	/** A source that's been lexed and parsed, with the test failed if either failed. The tokens live as long as the
+	 *  nodes, so that lazily parsed bodies can still be loaded. */
+	struct Parsed {
+		Lexer lexer;
+		Parser parser;
+		bool ok = false;
+
+		explicit Parsed(std::string_view source, bool lazy_bodies = false) {
+			if (!lexer.lex(source)) {
+				std::println(stderr, "Lexing failed:\n{}", source);
+				++failures;
+				return;
+			}
+
+			parser.setLazyBodies(lazy_bodies);
+			if (auto failure = parser.parse(lexer.tokens)) {
+				std::println(stderr, "Parsing failed at {}:\n{}", *failure, source);
+				++failures;
+				return;
+			}
+
+			ok = true;
+		}
+
+		const auto & getNodes() const { return parser.getNodes(); }
+	};
+
+	inline int finish() {
+		if (failures == 0)
+			return EXIT_SUCCESS;
+		std::println(stderr, "{} check{} failed", failures, failures == 1? "" : "s");
+		return EXIT_FAILURE;
+	}
+}
+
+#define CHECK(...) ::mead::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
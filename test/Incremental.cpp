@@ -0,0 +1,86 @@
+#include "mead/Compiler.h"
+#include "mead/IncrementalCompiler.h"
+
+#include "Harness.h"
+
+#include <format>
+#include <string>
+#include <string_view>
+
+namespace {
+	using namespace mead;
+
+	constexpr size_t functionCount = 301;
+
+	std::string generate() {
+		std::string out = "k: i32 const = 3;\n";
+		for (size_t i = 0; i < functionCount; ++i)
+			out += std::format("fn f{}(a: i32) -> i32 {{ b: i32 = a * {} + k; if b > 10 {{ return b - 1; }} return b; }}\n", i, i % 7);
+		return out;
+	}
+
+	std::string compileBatch(std::string_view source) {
+		test::Parsed parsed(source);
+		if (!parsed.ok)
+			return {};
+		const CompilerResult result = Compiler(0).compile(parsed.getNodes());
+		return result? *result : std::string{};
+	}
+}
+
+int main() {
+	using namespace mead;
+
+	// A newline inside one function's body moves every item after it, but only that function is compiled again.
+	{
+		std::string source = generate();
+		IncrementalCompiler compiler;
+		compiler.setSource("file", source);
+		const CompilerResult initial = compiler.compile("file");
+		if (CHECK(initial.has_value()))
+			CHECK(*initial == compileBatch(source));
+
+		const std::string body = "fn f5(a: i32) -> i32 {";
+		source.insert(source.find(body) + body.size(), "\n");
+		compiler.getEngine().resetStats();
+		compiler.setSource("file", source);
+		const CompilerResult edited = compiler.compile("file");
+		if (CHECK(edited.has_value()))
+			CHECK(*edited == compileBatch(source));
+
+		const QueryStats &ir = compiler.getEngine().getStats(QueryKind::FunctionIR);
+		CHECK(ir.misses == 0);
+		CHECK(ir.recomputations == 1);
+		CHECK(compiler.getEngine().getStats(QueryKind::ItemTokens).recomputations == 1);
+	}
+
+	// Moving a function that has an error moves the error along with it, although its piece isn't compiled again.
+	{
+		const std::string function = "fn f() -> i32 {\n\treturn missing;\n}\n";
+		IncrementalCompiler compiler;
+		compiler.setSource("file", function);
+		const auto &before = compiler.getModule("file").diagnostics;
+		if (CHECK(before.size() == 1)) {
+			CHECK(before.front().location.line == 2);
+			CHECK(before.front().location.column == 9);
+		}
+
+		compiler.getEngine().resetStats();
+		compiler.setSource("file", "\n\n  " + function);
+		const auto &after = compiler.getModule("file").diagnostics;
+		if (CHECK(after.size() == 1)) {
+			CHECK(after.front().location.line == 4);
+			CHECK(after.front().location.column == 9);
+		}
+		CHECK(compiler.getEngine().getStats(QueryKind::FunctionIR).recomputations == 0);
+	}
+
+	// Results are compared by 128-bit fingerprints, so inputs differing in a single bit shouldn't collide.
+	{
+		CHECK(Fingerprint().add(std::string_view("a")).get() != Fingerprint().add(std::string_view("b")).get());
+		CHECK(Fingerprint().add(0).get() != Fingerprint().add(1).get());
+		CHECK(Fingerprint().add(std::string_view("")).get() != Fingerprint().get());
+	}
+
+	return test::finish();
+}
@@ -0,0 +1,52 @@
+#include "mead/Compiler.h"
+
+#include "Harness.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace {
+	using namespace mead;
+
+	/** Returns the mangled name of the first node in the source, which has to declare or define a function. */
+	std::optional<std::string> mangle(std::string_view source) {
+		test::Parsed parsed(source);
+		if (!parsed.ok || parsed.getNodes().empty())
+			return std::nullopt;
+		return Compiler(0).getMangledName(*parsed.getNodes().front());
+	}
+}
+
+int main() {
+	using namespace mead;
+
+	// <cstdint>'s types on LP64, so that C++ can call these.
+	CHECK(mangle("fn hash(x: u64) -> u64;") == "_Z4hashm");
+	CHECK(mangle("fn hash(x: i64) -> i64;") == "_Z4hashl");
+	CHECK(mangle("fn f(a: i8, b: u8, c: i16, d: u16, e: i32, f: u32) -> void;") == "_Z1fahstij");
+
+	// Top-level const on a parameter isn't part of the signature, but const behind a pointer is.
+	CHECK(mangle("fn f(x: i32 const) -> i32;") == "_Z1fi");
+	CHECK(mangle("fn g(p: i32 const*) -> i32;") == "_Z1gPKi");
+	CHECK(mangle("fn g(p: u8*) -> i32;") == "_Z1gPh");
+
+	// Overloads are told apart, and calls go to the right one.
+	test::Parsed parsed(R"(
+		fn f(x: i32 const) -> i32 { return x; }
+		fn f(x: u64) -> i32 { return 2; }
+		fn main() -> i32 { x: i32 = 1; y: u64 = 2; return f(x) + f(y); }
+	)");
+	if (parsed.ok) {
+		Compiler compiler(0);
+		const CompilerResult result = compiler.compile(parsed.getNodes());
+		if (CHECK(result.has_value())) {
+			CHECK(test::contains(*result, "@_Z1fi("));
+			CHECK(test::contains(*result, "@_Z1fm("));
+			CHECK(test::contains(*result, "call i32 @_Z1fi("));
+			CHECK(test::contains(*result, "call i32 @_Z1fm("));
+		}
+	}
+
+	return test::finish();
+}
@@ -0,0 +1,71 @@
+#include "mead/Compiler.h"
+
+#include "Harness.h"
+
+#include <string>
+#include <string_view>
+
+namespace {
+	using namespace mead;
+
+	/** Compiles the source through the default pipeline and returns the module, or an empty string on failure. */
+	std::string compile(std::string_view source) {
+		test::Parsed parsed(source);
+		if (!parsed.ok)
+			return {};
+		const CompilerResult result = Compiler(0).compile(parsed.getNodes());
+		if (!CHECK(result.has_value()))
+			return {};
+		return *result;
+	}
+}
+
+int main() {
+	using namespace mead;
+
+	// Value numbering forwards the stored value to the load, and constant propagation has to run again to fold the add.
+	{
+		const std::string module = compile("fn f(p: i32*) -> i32 { p.* = 3; return p.* + 1; }");
+		CHECK(test::contains(module, "store i32 3, ptr %p"));
+		CHECK(test::contains(module, "ret i32 4"));
+		CHECK(!test::contains(module, "add i32"));
+		CHECK(!test::contains(module, "load i32"));
+	}
+
+	// Likewise for a condition, after which the branch that can't be taken is removed along with its block.
+	{
+		const std::string module = compile("fn f(p: i32*) -> i32 { p.* = 5; if p.* > 2 { return 1; } return 0; }");
+		CHECK(test::contains(module, "ret i32 1"));
+		CHECK(!test::contains(module, "icmp"));
+		CHECK(!test::contains(module, "ret i32 0"));
+	}
+
+	// Locals are folded whether or not they go through memory.
+	{
+		const std::string module = compile("fn h(a: i32) -> i32 { x: i32 = 5; if x > 2 { return 10 / x; } return a; }");
+		CHECK(test::contains(module, "ret i32 2"));
+		CHECK(!test::contains(module, "sdiv"));
+		CHECK(!test::contains(module, "ret i32 %a"));
+	}
+
+	// A redundant computation is replaced by the one that dominates it.
+	{
+		const std::string module = compile("fn g(a: i32) -> i32 { return a * 2 + a * 2; }");
+		CHECK(test::contains(module, "mul i32 %a, 2"));
+		CHECK(module.find("mul i32") == module.rfind("mul i32"));
+	}
+
+	// Loads from constant globals are folded.
+	{
+		const std::string module = compile("k: i32 const = 6; fn f() -> i32 { return k * 7; }");
+		CHECK(test::contains(module, "ret i32 42"));
+	}
+
+	// Division by zero is left for LLVM to deal with.
+	{
+		const std::string module = compile("fn f() -> i32 { x: i32 = 0; return 1 / x; }");
+		CHECK(test::contains(module, "sdiv i32 1, 0"));
+	}
+
+	return test::finish();
+}
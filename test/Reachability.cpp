@@ -0,0 +1,46 @@
+#include "mead/Compiler.h"
+
+#include "Harness.h"
+
+#include <string>
+
+int main() {
+	using namespace mead;
+
+	// Bodies that can't be reached from the roots are never parsed, so their errors go unnoticed.
+	{
+		test::Parsed parsed(R"(
+			fn unused() -> i32 { return 1 + ; }
+			fn helper(a: i32) -> i32 { return a * 2; }
+			fn main() -> i32 { return helper(21); }
+		)", true);
+		if (parsed.ok) {
+			Compiler compiler(0);
+			compiler.setRoots({"main"}, [&](ASTNode &definition) { return parsed.parser.loadBody(definition); });
+			const CompilerResult result = compiler.compile(parsed.getNodes());
+			if (CHECK(result.has_value())) {
+				CHECK(test::contains(*result, "@main("));
+				CHECK(test::contains(*result, "@helper("));
+				CHECK(!test::contains(*result, "@unused("));
+			}
+		}
+	}
+
+	// A reachable body that fails to parse is the only error: its callers still find the function.
+	{
+		test::Parsed parsed(R"(
+			fn helper(a: i32) -> i32 { return a + ; }
+			fn other() -> i32 { return helper(1) * 2; }
+			fn main() -> i32 { return helper(2) + other() + helper(3); }
+		)", true);
+		if (parsed.ok) {
+			Compiler compiler(0);
+			compiler.setRoots({"main"}, [&](ASTNode &definition) { return parsed.parser.loadBody(definition); });
+			const CompilerResult result = compiler.compile(parsed.getNodes());
+			if (CHECK(!result.has_value()))
+				CHECK(result.error().first == "1 error");
+		}
+	}
+
+	return test::finish();
+}
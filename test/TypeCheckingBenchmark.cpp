@@ -0,0 +1,73 @@
+#include "mead/Compiler.h"
+#include "mead/Lexer.h"
+#include "mead/Parser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <print>
+#include <string>
+
+namespace {
+	constexpr size_t termCount = 10'000;
+	constexpr size_t functionCount = 2'000;
+
+	/** A global whose initializer has many terms, which has to be typed in linear time, and many small functions. */
+	std::string generate() {
+		std::string out = "long: i64 = 0";
+		for (size_t i = 1; i <= termCount; ++i)
+			out += std::format(" + {}", i % 7);
+		out += ";\n";
+
+		for (size_t i = 0; i < functionCount; ++i)
+			out += std::format("fn f{}(a: i32, b: i32) -> i32 {{ c: i32 = a * b + {}; if c > b {{ return c - a; }} return c + b; }}\n", i, i % 100);
+
+		return out;
+	}
+
+	template <typename F>
+	double time(F &&function) {
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+int main() {
+	using namespace mead;
+
+	const std::string source = generate();
+
+	Lexer lexer;
+	bool lexed = false;
+	const double lex_time = time([&] { lexed = lexer.lex(source); });
+	if (!lexed) {
+		std::println("Lexing failed");
+		return EXIT_FAILURE;
+	}
+
+	Parser parser;
+	std::optional<Token> failure;
+	const double parse_time = time([&] { failure = parser.parse(lexer.tokens); });
+	if (failure) {
+		std::println("Parsing failed at {}", *failure);
+		return EXIT_FAILURE;
+	}
+
+	Compiler compiler;
+	CompilerResult result;
+	const double compile_time = time([&] { result = compiler.compile(parser.getNodes()); });
+	if (!result) {
+		std::println("Compilation failed: {}", result.error().first);
+		return EXIT_FAILURE;
+	}
+
+	std::println("{} terms, {} functions, {} tokens", termCount, functionCount, lexer.tokens.size());
+	std::println("{:<10} {:>10.3f} ms", "Lexing", lex_time);
+	std::println("{:<10} {:>10.3f} ms", "Parsing", parse_time);
+	std::println("{:<10} {:>10.3f} ms", "Compiling", compile_time);
+	compiler.getPassManager().printReport(std::cout);
+	return EXIT_SUCCESS;
+}